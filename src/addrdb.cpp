@@ -14,6 +14,7 @@
 #include <common/settings.h>
 #include <cstdint>
 #include <hash.h>
+#include <kernel/messagestartchars.h>
 #include <logging.h>
 #include <logging/timer.h>
 #include <netbase.h>
@@ -21,11 +22,16 @@
 #include <random.h>
 #include <streams.h>
 #include <tinyformat.h>
+#include <uint256.h>
 #include <univalue.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/translation.h>
 
+#include <algorithm>
+#include <optional>
+#include <span>
+
 namespace {
 
 class DbNotFoundError : public std::exception
@@ -126,6 +132,127 @@ void DeserializeFileDB(const fs::path& path, Data&& data)
     }
     DeserializeDB(filein, data);
 }
+
+/** Return the checksum at the end of a file written by SerializeFileDB(). */
+std::optional<uint256> ReadFileDBChecksum(const fs::path& path)
+{
+    AutoFile file{fsbridge::fopen(path, "rb")};
+    if (file.IsNull()) return std::nullopt;
+    try {
+        uint256 checksum;
+        file.seek(-int64_t{uint256::size()}, SEEK_END);
+        file >> checksum;
+        return checksum;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+/**
+ * Create an empty journal on top of the peers.dat just written. The journal
+ * header records the peers.dat checksum, so that it is ignored if peers.dat
+ * is replaced without it, and the sequence number of the last journal record
+ * already reflected in peers.dat.
+ */
+bool StartPeersJournal(const fs::path& journal_path, const fs::path& peers_path, uint64_t base_sequence)
+{
+    const std::optional<uint256> base{ReadFileDBChecksum(peers_path)};
+    if (!base) {
+        LogError("%s: Failed to read checksum of %s\n", __func__, fs::PathToString(peers_path));
+        return false;
+    }
+
+    const fs::path tmp_path{journal_path + ".new"};
+    AutoFile file{fsbridge::fopen(tmp_path, "wb")};
+    if (file.IsNull()) {
+        LogError("%s: Failed to open file %s\n", __func__, fs::PathToString(tmp_path));
+        return false;
+    }
+    try {
+        file << Params().MessageStart() << *base << base_sequence;
+    } catch (const std::exception& e) {
+        (void)file.fclose();
+        remove(tmp_path);
+        LogError("%s: Serialize or I/O error - %s\n", __func__, e.what());
+        return false;
+    }
+    if (!file.Commit() || file.fclose() != 0 || !RenameOver(tmp_path, journal_path)) {
+        remove(tmp_path);
+        LogError("%s: Failed to write %s\n", __func__, fs::PathToString(journal_path));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Append journal records to an existing journal.
+ *
+ * @returns false if there is no journal or it should be compacted into peers.dat instead
+ */
+bool AppendPeersJournal(const fs::path& journal_path, const fs::path& peers_path, std::span<const std::byte> records)
+{
+    std::error_code ec;
+    const uint64_t journal_size{fs::file_size(journal_path, ec)};
+    if (ec) return false;
+    const uint64_t peers_size{fs::file_size(peers_path, ec)};
+    if (ec) return false;
+    if (journal_size + records.size() > std::max(peers_size, MIN_PEERS_JOURNAL_COMPACTION_SIZE)) return false;
+    if (records.empty()) return true;
+
+    AutoFile file{fsbridge::fopen(journal_path, "ab")};
+    if (file.IsNull()) return false;
+    try {
+        file.write(records);
+    } catch (const std::exception& e) {
+        LogError("%s: I/O error - %s\n", __func__, e.what());
+        return false;
+    }
+    // A failed or torn append is discarded when replaying, and the journal
+    // is replaced when falling back to writing peers.dat.
+    return file.Commit() && file.fclose() == 0;
+}
+
+/** Apply the changes journaled since peers.dat was written. */
+void ReplayPeersJournal(const fs::path& journal_path, const fs::path& peers_path, AddrMan& addrman)
+{
+    std::vector<std::byte> records;
+    uint64_t base_sequence{0};
+    uint64_t header_size{0};
+    {
+        AutoFile file{fsbridge::fopen(journal_path, "rb")};
+        if (file.IsNull()) return;
+        std::error_code ec;
+        const uint64_t journal_size{fs::file_size(journal_path, ec)};
+        try {
+            MessageStartChars magic;
+            uint256 base;
+            file >> magic >> base >> base_sequence;
+            if (ec || magic != Params().MessageStart() || base != ReadFileDBChecksum(peers_path)) {
+                throw std::runtime_error{"journal does not belong to peers.dat"};
+            }
+            header_size = file.tell();
+            records.resize(journal_size - header_size);
+            file.read(records);
+        } catch (const std::exception& e) {
+            LogPrintf("Ignoring %s (%s)\n", fs::quoted(fs::PathToString(journal_path)), e.what());
+            // Drop the journal, so that the next dump rewrites peers.dat and starts a fresh one.
+            (void)file.fclose();
+            std::error_code ec;
+            fs::remove(journal_path, ec);
+            return;
+        }
+    }
+
+    const auto start{SteadyClock::now()};
+    const size_t replayed{addrman.ReplayJournal(records, base_sequence)};
+    if (replayed < records.size()) {
+        // Cut off the torn or corrupt tail, so that later appends can be replayed again.
+        std::error_code ec;
+        fs::resize_file(journal_path, header_size + replayed, ec);
+        if (ec) fs::remove(journal_path, ec);
+    }
+    LogPrintf("Replayed %u of %u bytes from peers.journal  %dms\n", replayed, records.size(), Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+}
 } // namespace
 
 CBanDB::CBanDB(fs::path ban_list_path)
@@ -177,10 +304,23 @@ bool CBanDB::Read(banmap_t& banSet)
     return true;
 }
 
-bool DumpPeerAddresses(const ArgsManager& args, const AddrMan& addr)
+bool DumpPeerAddresses(const ArgsManager& args, AddrMan& addr)
 {
     const auto pathAddr = args.GetDataDirNet() / "peers.dat";
-    return SerializeFileDB("peers", pathAddr, addr);
+    const auto path_journal = args.GetDataDirNet() / "peers.journal";
+    if (const auto records{addr.TakeJournal()}) {
+        if (AppendPeersJournal(path_journal, pathAddr, *records)) return true;
+    }
+    // Compact any journal by rewriting peers.dat. Changes made while doing so
+    // may end up both in peers.dat and in the new journal; the new journal's
+    // header tells replay to skip them.
+    if (!SerializeFileDB("peers", pathAddr, addr)) return false;
+    if (args.GetBoolArg("-peersjournal", DEFAULT_PEERS_JOURNAL)) {
+        return StartPeersJournal(path_journal, pathAddr, addr.SerializedJournalSequence());
+    }
+    std::error_code ec;
+    fs::remove(path_journal, ec);
+    return true;
 }
 
 void ReadFromStream(AddrMan& addr, DataStream& ssPeers)
@@ -200,6 +340,9 @@ util::Result<std::unique_ptr<AddrMan>> LoadAddrman(const NetGroupManager& netgro
     try {
         DeserializeFileDB(path_addr, *addrman);
         LogPrintf("Loaded %i addresses from peers.dat  %dms\n", addrman->Size(), Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+        // Replay the journal even with -nopeersjournal, in which case the
+        // next dump folds it into peers.dat before removing it.
+        ReplayPeersJournal(args.GetDataDirNet() / "peers.journal", path_addr, *addrman);
     } catch (const DbNotFoundError&) {
         // Addrman can be in an inconsistent state after failure, reset it
         addrman = std::make_unique<AddrMan>(netgroupman, deterministic, /*consistency_check_ratio=*/check_addrman);
@@ -217,6 +360,7 @@ util::Result<std::unique_ptr<AddrMan>> LoadAddrman(const NetGroupManager& netgro
         return util::Error{strprintf(_("Invalid or corrupt peers.dat (%s). If you believe this is a bug, please report it to %s. As a workaround, you can move the file (%s) out of the way (rename, move, or delete) to have a new one created on the next start."),
                                      e.what(), CLIENT_BUGREPORT, fs::quoted(fs::PathToString(path_addr)))};
     }
+    if (args.GetBoolArg("-peersjournal", DEFAULT_PEERS_JOURNAL)) addrman->EnableJournal(MAX_PEERS_JOURNAL_PENDING);
     return addrman;
 }
 
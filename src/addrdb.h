@@ -10,9 +10,18 @@
 #include <util/fs.h>
 #include <util/result.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+/** Default for -peersjournal */
+static constexpr bool DEFAULT_PEERS_JOURNAL{false};
+/** Maximum size of the addrman journal kept in memory between two dumps of peers.dat */
+static constexpr size_t MAX_PEERS_JOURNAL_PENDING{4 << 20};
+/** peers.journal is compacted into peers.dat once it would grow beyond the size of peers.dat, or this size if larger */
+static constexpr uint64_t MIN_PEERS_JOURNAL_COMPACTION_SIZE{1 << 20};
+
 class ArgsManager;
 class AddrMan;
 class CAddress;
@@ -22,7 +31,12 @@ class NetGroupManager;
 /** Only used by tests. */
 void ReadFromStream(AddrMan& addr, DataStream& ssPeers);
 
-bool DumpPeerAddresses(const ArgsManager& args, const AddrMan& addr);
+/**
+ * Persist the addrman to peers.dat. With -peersjournal, only the changes since
+ * the previous call are appended to peers.journal, and peers.dat is rewritten
+ * when the journal grows too large.
+ */
+bool DumpPeerAddresses(const ArgsManager& args, AddrMan& addr);
 
 /** Access to the banlist database (banlist.json) */
 class CBanDB
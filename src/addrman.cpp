@@ -8,6 +8,7 @@
 #include <addrman.h>
 #include <addrman_impl.h>
 
+#include <crypto/common.h>
 #include <hash.h>
 #include <logging.h>
 #include <logging/timer.h>
@@ -22,6 +23,7 @@
 #include <util/time.h>
 
 #include <cmath>
+#include <numeric>
 #include <optional>
 
 /** Over how many buckets entries with tried addresses from a single group (/16 for IPv4) are spread */
@@ -111,6 +113,8 @@ AddrManImpl::AddrManImpl(const NetGroupManager& netgroupman, bool deterministic,
     , nKey{deterministic ? uint256{1} : insecure_rand.rand256()}
     , m_consistency_check_ratio{consistency_check_ratio}
     , m_netgroupman{netgroupman}
+    , m_snapshot_max_age{deterministic ? 0s : ADDRMAN_SNAPSHOT_MAX_AGE}
+    , m_snapshot_rand{deterministic}
 {
     for (auto& bucket : vvNew) {
         for (auto& entry : bucket) {
@@ -133,6 +137,7 @@ template <typename Stream>
 void AddrManImpl::Serialize(Stream& s_) const
 {
     LOCK(cs);
+    m_journal_serialized_sequence = m_journal_sequence;
 
     /**
      * Serialized format.
@@ -233,6 +238,7 @@ void AddrManImpl::Unserialize(Stream& s_)
     LOCK(cs);
 
     assert(vRandom.empty());
+    InvalidateSnapshot();
 
     Format format;
     s_ >> Using<CustomUintFormatter<1>>(format);
@@ -547,7 +553,7 @@ void AddrManImpl::MakeTried(AddrInfo& info, nid_type nId)
     m_network_counts[info.GetNetwork()].n_tried++;
 }
 
-bool AddrManImpl::AddSingle(const CAddress& addr, const CNetAddr& source, std::chrono::seconds time_penalty)
+bool AddrManImpl::AddSingle(const CAddress& addr, const CNetAddr& source, std::chrono::seconds time_penalty, NodeSeconds now, std::optional<bool>& admit)
 {
     AssertLockHeld(cs);
 
@@ -564,7 +570,7 @@ bool AddrManImpl::AddSingle(const CAddress& addr, const CNetAddr& source, std::c
 
     if (pinfo) {
         // periodically update nTime
-        const bool currently_online{NodeClock::now() - addr.nTime < 24h};
+        const bool currently_online{now - addr.nTime < 24h};
         const auto update_interval{currently_online ? 1h : 24h};
         if (pinfo->nTime < addr.nTime - update_interval - time_penalty) {
             pinfo->nTime = std::max(NodeSeconds{0s}, addr.nTime - time_penalty);
@@ -589,7 +595,8 @@ bool AddrManImpl::AddSingle(const CAddress& addr, const CNetAddr& source, std::c
         // stochastic test: previous nRefCount == N: 2^N times harder to increase it
         if (pinfo->nRefCount > 0) {
             const int nFactor{1 << pinfo->nRefCount};
-            if (insecure_rand.randrange(nFactor) != 0) return false;
+            if (!admit) admit = insecure_rand.randrange(nFactor) == 0;
+            if (!*admit) return false;
         }
     } else {
         pinfo = Create(addr, source, &nId);
@@ -602,7 +609,7 @@ bool AddrManImpl::AddSingle(const CAddress& addr, const CNetAddr& source, std::c
     if (vvNew[nUBucket][nUBucketPos] != nId) {
         if (!fInsert) {
             AddrInfo& infoExisting = mapInfo[vvNew[nUBucket][nUBucketPos]];
-            if (infoExisting.IsTerrible() || (infoExisting.nRefCount > 1 && pinfo->nRefCount == 0)) {
+            if (infoExisting.IsTerrible(now) || (infoExisting.nRefCount > 1 && pinfo->nRefCount == 0)) {
                 // Overwrite the existing new table entry.
                 fInsert = true;
             }
@@ -626,6 +633,7 @@ bool AddrManImpl::AddSingle(const CAddress& addr, const CNetAddr& source, std::c
 bool AddrManImpl::Good_(const CService& addr, bool test_before_evict, NodeSeconds time)
 {
     AssertLockHeld(cs);
+    Journal(JournalRecord::GOOD, addr, test_before_evict, TicksSinceEpoch<std::chrono::seconds>(time));
 
     nid_type nId;
 
@@ -678,12 +686,21 @@ bool AddrManImpl::Good_(const CService& addr, bool test_before_evict, NodeSecond
     }
 }
 
-bool AddrManImpl::Add_(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty)
+bool AddrManImpl::Add_(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty,
+                       NodeSeconds now, const std::vector<uint8_t>* rejected)
 {
+    AssertLockHeld(cs);
+
     int added{0};
-    for (std::vector<CAddress>::const_iterator it = vAddr.begin(); it != vAddr.end(); it++) {
-        added += AddSingle(*it, source, time_penalty) ? 1 : 0;
+    std::vector<uint8_t> journal_rejected(vAddr.size());
+    for (size_t i{0}; i < vAddr.size(); ++i) {
+        std::optional<bool> admit;
+        if (rejected && i < rejected->size()) admit = !(*rejected)[i];
+        added += AddSingle(vAddr[i], source, time_penalty, now, admit) ? 1 : 0;
+        journal_rejected[i] = admit == false ? 1 : 0;
     }
+    // Journaled after the fact, so that replaying it repeats the same stochastic test outcomes.
+    Journal(JournalRecord::ADD, vAddr, source, int64_t{time_penalty.count()}, TicksSinceEpoch<std::chrono::seconds>(now), journal_rejected);
     if (added > 0) {
         LogDebug(BCLog::ADDRMAN, "Added %i addresses (of %i) from %s: %i tried, %i new\n", added, vAddr.size(), source.ToStringAddr(), nTried, nNew);
     }
@@ -693,6 +710,7 @@ bool AddrManImpl::Add_(const std::vector<CAddress>& vAddr, const CNetAddr& sourc
 void AddrManImpl::Attempt_(const CService& addr, bool fCountFailure, NodeSeconds time)
 {
     AssertLockHeld(cs);
+    Journal(JournalRecord::ATTEMPT, addr, fCountFailure, TicksSinceEpoch<std::chrono::seconds>(time));
 
     AddrInfo* pinfo = Find(addr);
 
@@ -710,21 +728,19 @@ void AddrManImpl::Attempt_(const CService& addr, bool fCountFailure, NodeSeconds
     }
 }
 
-std::pair<CAddress, NodeSeconds> AddrManImpl::Select_(bool new_only, const std::unordered_set<Network>& networks) const
+std::pair<CAddress, NodeSeconds> AddrManImpl::Select_(const Snapshot& snapshot, FastRandomContext& rng, bool new_only, const std::unordered_set<Network>& networks) const
 {
-    AssertLockHeld(cs);
+    if (snapshot.entries.empty()) return {};
 
-    if (vRandom.empty()) return {};
-
-    size_t new_count = nNew;
-    size_t tried_count = nTried;
+    size_t new_count = snapshot.n_new;
+    size_t tried_count = snapshot.n_tried;
 
     if (!networks.empty()) {
         new_count = 0;
         tried_count = 0;
         for (auto& network : networks) {
-            auto it = m_network_counts.find(network);
-            if (it == m_network_counts.end()) {
+            auto it = snapshot.network_counts.find(network);
+            if (it == snapshot.network_counts.end()) {
                 continue;
             }
             auto counts = it->second;
@@ -744,29 +760,29 @@ std::pair<CAddress, NodeSeconds> AddrManImpl::Select_(bool new_only, const std::
     } else if (new_count == 0) {
         search_tried = true;
     } else {
-        search_tried = insecure_rand.randbool();
+        search_tried = rng.randbool();
     }
 
     const int bucket_count{search_tried ? ADDRMAN_TRIED_BUCKET_COUNT : ADDRMAN_NEW_BUCKET_COUNT};
+    const std::vector<int32_t>& table{search_tried ? snapshot.tried_table : snapshot.new_table};
 
     // Loop through the addrman table until we find an appropriate entry
     double chance_factor = 1.0;
     while (1) {
         // Pick a bucket, and an initial position in that bucket.
-        int bucket = insecure_rand.randrange(bucket_count);
-        int initial_position = insecure_rand.randrange(ADDRMAN_BUCKET_SIZE);
+        int bucket = rng.randrange(bucket_count);
+        int initial_position = rng.randrange(ADDRMAN_BUCKET_SIZE);
 
         // Iterate over the positions of that bucket, starting at the initial one,
         // and looping around.
         int i, position;
-        nid_type node_id;
+        int32_t entry{-1};
         for (i = 0; i < ADDRMAN_BUCKET_SIZE; ++i) {
             position = (initial_position + i) % ADDRMAN_BUCKET_SIZE;
-            node_id = GetEntry(search_tried, bucket, position);
-            if (node_id != -1) {
+            entry = table[bucket * ADDRMAN_BUCKET_SIZE + position];
+            if (entry != -1) {
                 if (!networks.empty()) {
-                    const auto it{mapInfo.find(node_id)};
-                    if (Assume(it != mapInfo.end()) && networks.contains(it->second.GetNetwork())) break;
+                    if (networks.contains(snapshot.entries[entry].GetNetwork())) break;
                 } else {
                     break;
                 }
@@ -777,12 +793,10 @@ std::pair<CAddress, NodeSeconds> AddrManImpl::Select_(bool new_only, const std::
         if (i == ADDRMAN_BUCKET_SIZE) continue;
 
         // Find the entry to return.
-        const auto it_found{mapInfo.find(node_id)};
-        assert(it_found != mapInfo.end());
-        const AddrInfo& info{it_found->second};
+        const AddrInfo& info{snapshot.entries[entry]};
 
         // With probability GetChance() * chance_factor, return the entry.
-        if (insecure_rand.randbits<30>() < chance_factor * info.GetChance() * (1 << 30)) {
+        if (rng.randbits<30>() < chance_factor * info.GetChance() * (1 << 30)) {
             LogDebug(BCLog::ADDRMAN, "Selected %s from %s\n", info.ToStringAddrPort(), search_tried ? "tried" : "new");
             return {info, info.m_last_try};
         }
@@ -809,12 +823,11 @@ nid_type AddrManImpl::GetEntry(bool use_tried, size_t bucket, size_t position) c
     return -1;
 }
 
-std::vector<CAddress> AddrManImpl::GetAddr_(size_t max_addresses, size_t max_pct, std::optional<Network> network, const bool filtered) const
+std::vector<CAddress> AddrManImpl::GetAddr_(size_t count, const std::function<const AddrInfo&(size_t)>& entry, FastRandomContext& rng, size_t max_addresses, size_t max_pct, std::optional<Network> network, const bool filtered) const
 {
-    AssertLockHeld(cs);
     Assume(max_pct <= 100);
 
-    size_t nNodes = vRandom.size();
+    size_t nNodes = count;
     if (max_pct != 0) {
         max_pct = std::min(max_pct, size_t{100});
         nNodes = max_pct * nNodes / 100;
@@ -827,16 +840,15 @@ std::vector<CAddress> AddrManImpl::GetAddr_(size_t max_addresses, size_t max_pct
     const auto now{Now<NodeSeconds>()};
     std::vector<CAddress> addresses;
     addresses.reserve(nNodes);
-    for (unsigned int n = 0; n < vRandom.size(); n++) {
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    for (unsigned int n = 0; n < order.size(); n++) {
         if (addresses.size() >= nNodes)
             break;
 
-        int nRndPos = insecure_rand.randrange(vRandom.size() - n) + n;
-        SwapRandom(n, nRndPos);
-        const auto it{mapInfo.find(vRandom[n])};
-        assert(it != mapInfo.end());
-
-        const AddrInfo& ai{it->second};
+        int nRndPos = rng.randrange(order.size() - n) + n;
+        std::swap(order[n], order[nRndPos]);
+        const AddrInfo& ai{entry(order[n])};
 
         // Filter by network (optional)
         if (network != std::nullopt && ai.GetNetClass() != network) continue;
@@ -850,6 +862,69 @@ std::vector<CAddress> AddrManImpl::GetAddr_(size_t max_addresses, size_t max_pct
     return addresses;
 }
 
+void AddrManImpl::InvalidateSnapshot(bool only_added)
+{
+    AssertLockHeld(cs);
+    ++m_version;
+    if (!only_added) m_min_snapshot_version = m_version.load();
+}
+
+std::shared_ptr<const AddrManImpl::Snapshot> AddrManImpl::MakeSnapshot() const
+{
+    AssertLockHeld(cs);
+
+    auto snapshot{std::make_shared<Snapshot>()};
+    snapshot->version = m_version;
+    snapshot->time = SteadyClock::now();
+    snapshot->n_new = nNew;
+    snapshot->n_tried = nTried;
+    snapshot->network_counts = m_network_counts;
+
+    std::unordered_map<nid_type, int32_t> index;
+    index.reserve(mapInfo.size());
+    snapshot->entries.reserve(mapInfo.size());
+    for (const auto& [id, info] : mapInfo) {
+        index.emplace(id, snapshot->entries.size());
+        snapshot->entries.push_back(info);
+    }
+    const auto copy_table{[&](const auto& buckets, std::vector<int32_t>& table) {
+        table.reserve(std::size(buckets) * ADDRMAN_BUCKET_SIZE);
+        for (const auto& bucket : buckets) {
+            for (const nid_type id : bucket) {
+                table.push_back(id == -1 ? -1 : index.at(id));
+            }
+        }
+    }};
+    copy_table(vvNew, snapshot->new_table);
+    copy_table(vvTried, snapshot->tried_table);
+    return snapshot;
+}
+
+std::shared_ptr<const AddrManImpl::Snapshot> AddrManImpl::GetSnapshot(uint256& seed) const
+{
+    std::shared_ptr<const Snapshot> snapshot;
+    {
+        LOCK(m_snapshot_mutex);
+        snapshot = m_snapshot;
+        seed = m_snapshot_rand.rand256();
+    }
+    if (snapshot) {
+        if (snapshot->version == m_version) return snapshot;
+        if (snapshot->version >= m_min_snapshot_version && SteadyClock::now() - snapshot->time < m_snapshot_max_age) return snapshot;
+    }
+
+    LOCK(cs);
+    {
+        // Another caller may have taken a snapshot while we were waiting for cs.
+        LOCK(m_snapshot_mutex);
+        if (m_snapshot && m_snapshot->version == m_version) return m_snapshot;
+    }
+    snapshot = MakeSnapshot();
+    LOCK(m_snapshot_mutex);
+    m_snapshot = snapshot;
+    return snapshot;
+}
+
 std::vector<std::pair<AddrInfo, AddressPosition>> AddrManImpl::GetEntries_(bool from_tried) const
 {
     AssertLockHeld(cs);
@@ -877,6 +952,7 @@ std::vector<std::pair<AddrInfo, AddressPosition>> AddrManImpl::GetEntries_(bool
 void AddrManImpl::Connected_(const CService& addr, NodeSeconds time)
 {
     AssertLockHeld(cs);
+    Journal(JournalRecord::CONNECTED, addr, TicksSinceEpoch<std::chrono::seconds>(time));
 
     AddrInfo* pinfo = Find(addr);
 
@@ -896,6 +972,7 @@ void AddrManImpl::Connected_(const CService& addr, NodeSeconds time)
 void AddrManImpl::SetServices_(const CService& addr, ServiceFlags nServices)
 {
     AssertLockHeld(cs);
+    Journal(JournalRecord::SERVICES, addr, uint64_t{nServices});
 
     AddrInfo* pinfo = Find(addr);
 
@@ -1178,8 +1255,9 @@ bool AddrManImpl::Add(const std::vector<CAddress>& vAddr, const CNetAddr& source
 {
     LOCK(cs);
     Check();
-    auto ret = Add_(vAddr, source, time_penalty);
+    auto ret = Add_(vAddr, source, time_penalty, Now<NodeSeconds>());
     Check();
+    InvalidateSnapshot(/*only_added=*/true);
     return ret;
 }
 
@@ -1189,6 +1267,7 @@ bool AddrManImpl::Good(const CService& addr, NodeSeconds time)
     Check();
     auto ret = Good_(addr, /*test_before_evict=*/true, time);
     Check();
+    InvalidateSnapshot();
     return ret;
 }
 
@@ -1198,6 +1277,7 @@ void AddrManImpl::Attempt(const CService& addr, bool fCountFailure, NodeSeconds
     Check();
     Attempt_(addr, fCountFailure, time);
     Check();
+    InvalidateSnapshot();
 }
 
 void AddrManImpl::ResolveCollisions()
@@ -1206,6 +1286,7 @@ void AddrManImpl::ResolveCollisions()
     Check();
     ResolveCollisions_();
     Check();
+    InvalidateSnapshot();
 }
 
 std::pair<CAddress, NodeSeconds> AddrManImpl::SelectTriedCollision()
@@ -1219,20 +1300,29 @@ std::pair<CAddress, NodeSeconds> AddrManImpl::SelectTriedCollision()
 
 std::pair<CAddress, NodeSeconds> AddrManImpl::Select(bool new_only, const std::unordered_set<Network>& networks) const
 {
-    LOCK(cs);
-    Check();
-    auto addrRet = Select_(new_only, networks);
-    Check();
-    return addrRet;
+    uint256 seed;
+    const auto snapshot{GetSnapshot(seed)};
+    FastRandomContext rng{seed};
+    return Select_(*snapshot, rng, new_only, networks);
 }
 
 std::vector<CAddress> AddrManImpl::GetAddr(size_t max_addresses, size_t max_pct, std::optional<Network> network, const bool filtered) const
 {
+    std::shared_ptr<const Snapshot> snapshot;
+    uint256 seed;
+    {
+        LOCK(m_snapshot_mutex);
+        snapshot = m_snapshot;
+        seed = m_snapshot_rand.rand256();
+    }
+    FastRandomContext rng{seed};
+    if (snapshot && snapshot->version == m_version) {
+        return GetAddr_(snapshot->entries.size(), [&](size_t i) -> const AddrInfo& { return snapshot->entries[i]; }, rng, max_addresses, max_pct, network, filtered);
+    }
+    // Callers expect to see every Add() right away. Pick from the tables
+    // rather than copying them into a new snapshot, which only Select() reuses.
     LOCK(cs);
-    Check();
-    auto addresses = GetAddr_(max_addresses, max_pct, network, filtered);
-    Check();
-    return addresses;
+    return GetAddr_(vRandom.size(), [&](size_t i) EXCLUSIVE_LOCKS_REQUIRED(cs) -> const AddrInfo& { return mapInfo.at(vRandom[i]); }, rng, max_addresses, max_pct, network, filtered);
 }
 
 std::vector<std::pair<AddrInfo, AddressPosition>> AddrManImpl::GetEntries(bool from_tried) const
@@ -1250,6 +1340,7 @@ void AddrManImpl::Connected(const CService& addr, NodeSeconds time)
     Check();
     Connected_(addr, time);
     Check();
+    InvalidateSnapshot();
 }
 
 void AddrManImpl::SetServices(const CService& addr, ServiceFlags nServices)
@@ -1258,6 +1349,7 @@ void AddrManImpl::SetServices(const CService& addr, ServiceFlags nServices)
     Check();
     SetServices_(addr, nServices);
     Check();
+    InvalidateSnapshot();
 }
 
 std::optional<AddressPosition> AddrManImpl::FindAddressEntry(const CAddress& addr)
@@ -1269,6 +1361,162 @@ std::optional<AddressPosition> AddrManImpl::FindAddressEntry(const CAddress& add
     return entry;
 }
 
+/** Checksum protecting a single journal record against torn writes. */
+static uint32_t JournalChecksum(uint8_t type, std::span<const std::byte> payload)
+{
+    HashWriter hasher{};
+    hasher << type;
+    hasher.write(payload);
+    return ReadLE32(hasher.GetHash().begin());
+}
+
+template <typename... Args>
+void AddrManImpl::Journal(JournalRecord type, const Args&... args)
+{
+    AssertLockHeld(cs);
+    if (!m_journal_max_bytes || m_journal_replaying) return;
+    ++m_journal_sequence;
+    if (m_journal_overflow) return;
+
+    DataStream payload{};
+    ParamsStream ps{payload, CAddress::V2_DISK};
+    ps << m_journal_sequence;
+    (ps << ... << args);
+
+    const uint8_t type_byte{static_cast<uint8_t>(type)};
+    m_journal << type_byte;
+    WriteCompactSize(m_journal, payload.size());
+    m_journal.write(payload);
+    m_journal << JournalChecksum(type_byte, payload);
+
+    if (m_journal.size() > *m_journal_max_bytes) {
+        LogDebug(BCLog::ADDRMAN, "Journal exceeded %u bytes, dropping it\n", *m_journal_max_bytes);
+        m_journal.clear();
+        m_journal_overflow = true;
+    }
+}
+
+void AddrManImpl::EnableJournal(size_t max_bytes)
+{
+    LOCK(cs);
+    m_journal_max_bytes = max_bytes;
+}
+
+std::optional<std::vector<std::byte>> AddrManImpl::TakeJournal()
+{
+    LOCK(cs);
+    if (!m_journal_max_bytes) return std::nullopt;
+    if (m_journal_overflow) {
+        m_journal_overflow = false;
+        return std::nullopt;
+    }
+    std::vector<std::byte> records{m_journal.begin(), m_journal.end()};
+    m_journal.clear();
+    return records;
+}
+
+uint64_t AddrManImpl::SerializedJournalSequence() const
+{
+    LOCK(cs);
+    return m_journal_serialized_sequence;
+}
+
+size_t AddrManImpl::ReplayJournal(std::span<const std::byte> records, uint64_t base_sequence)
+{
+    LOCK(cs);
+    Check();
+    m_journal_replaying = true;
+    m_journal_sequence = std::max(m_journal_sequence, base_sequence);
+
+    SpanReader reader{records};
+    size_t replayed_bytes{0};
+    int replayed_records{0};
+    int skipped_records{0};
+    try {
+        while (!reader.empty()) {
+            uint8_t type;
+            reader >> type;
+            const uint64_t payload_size{ReadCompactSize(reader)};
+            if (payload_size > reader.size()) break;
+            std::vector<std::byte> payload(payload_size);
+            reader.read(payload);
+            uint32_t checksum;
+            reader >> checksum;
+            if (checksum != JournalChecksum(type, payload)) {
+                LogDebug(BCLog::ADDRMAN, "Journal record with invalid checksum, stopping replay\n");
+                break;
+            }
+
+            SpanReader payload_reader{payload};
+            ParamsStream ps{payload_reader, CAddress::V2_DISK};
+            uint64_t sequence;
+            ps >> sequence;
+            m_journal_sequence = std::max(m_journal_sequence, sequence);
+            // Records journaled before the base state was serialized are already part of it.
+            if (sequence <= base_sequence) {
+                ++skipped_records;
+            } else {
+                switch (JournalRecord{type}) {
+                case JournalRecord::ADD: {
+                    std::vector<CAddress> addrs;
+                    CNetAddr source;
+                    int64_t time_penalty;
+                    int64_t time;
+                    std::vector<uint8_t> rejected;
+                    ps >> addrs >> source >> time_penalty >> time >> rejected;
+                    Add_(addrs, source, std::chrono::seconds{time_penalty}, NodeSeconds{std::chrono::seconds{time}}, &rejected);
+                    break;
+                }
+                case JournalRecord::GOOD: {
+                    CService addr;
+                    bool test_before_evict;
+                    int64_t time;
+                    ps >> addr >> test_before_evict >> time;
+                    Good_(addr, test_before_evict, NodeSeconds{std::chrono::seconds{time}});
+                    break;
+                }
+                case JournalRecord::ATTEMPT: {
+                    CService addr;
+                    bool count_failure;
+                    int64_t time;
+                    ps >> addr >> count_failure >> time;
+                    Attempt_(addr, count_failure, NodeSeconds{std::chrono::seconds{time}});
+                    break;
+                }
+                case JournalRecord::CONNECTED: {
+                    CService addr;
+                    int64_t time;
+                    ps >> addr >> time;
+                    Connected_(addr, NodeSeconds{std::chrono::seconds{time}});
+                    break;
+                }
+                case JournalRecord::SERVICES: {
+                    CService addr;
+                    uint64_t services;
+                    ps >> addr >> services;
+                    SetServices_(addr, ServiceFlags{services});
+                    break;
+                }
+                default:
+                    // Records written by a future version are skipped.
+                    break;
+                }
+            }
+            replayed_bytes = records.size() - reader.size();
+            ++replayed_records;
+        }
+    } catch (const std::ios_base::failure&) {
+        // A truncated record at the end of the journal, e.g. after a crash
+        // while appending to it. Everything before it is still usable.
+    }
+
+    m_journal_replaying = false;
+    Check();
+    InvalidateSnapshot();
+    LogDebug(BCLog::ADDRMAN, "Replayed %d journal records, %d of them already applied (%u of %u bytes)\n", replayed_records, skipped_records, replayed_bytes, records.size());
+    return replayed_bytes;
+}
+
 AddrMan::AddrMan(const NetGroupManager& netgroupman, bool deterministic, int32_t consistency_check_ratio)
     : m_impl(std::make_unique<AddrManImpl>(netgroupman, deterministic, consistency_check_ratio)) {}
 
@@ -1353,3 +1601,23 @@ std::optional<AddressPosition> AddrMan::FindAddressEntry(const CAddress& addr)
 {
     return m_impl->FindAddressEntry(addr);
 }
+
+void AddrMan::EnableJournal(size_t max_bytes)
+{
+    m_impl->EnableJournal(max_bytes);
+}
+
+std::optional<std::vector<std::byte>> AddrMan::TakeJournal()
+{
+    return m_impl->TakeJournal();
+}
+
+uint64_t AddrMan::SerializedJournalSequence() const
+{
+    return m_impl->SerializedJournalSequence();
+}
+
+size_t AddrMan::ReplayJournal(std::span<const std::byte> records, uint64_t base_sequence)
+{
+    return m_impl->ReplayJournal(records, base_sequence);
+}
@@ -201,6 +201,43 @@ public:
     //! Update an entry's service bits.
     void SetServices(const CService& addr, ServiceFlags nServices);
 
+    /**
+     * Start recording modifications (additions, connection attempts and
+     * results, service updates) in an in-memory journal, so that they can be
+     * persisted incrementally instead of serializing the whole addrman.
+     *
+     * @param[in] max_bytes  Maximum size of the journal. If exceeded, it is
+     *                       discarded and TakeJournal() returns nullopt.
+     */
+    void EnableJournal(size_t max_bytes);
+
+    /**
+     * Return and clear the modifications journaled since the previous call.
+     *
+     * @return  The journal records, to be passed to ReplayJournal() after
+     *          loading the addrman state serialized before the modifications,
+     *          or nullopt if journaling is disabled or records were dropped.
+     */
+    std::optional<std::vector<std::byte>> TakeJournal();
+
+    /**
+     * Sequence number of the last journal record whose modification is
+     * reflected in the most recent serialization of this addrman.
+     */
+    uint64_t SerializedJournalSequence() const;
+
+    /**
+     * Reapply modifications returned by TakeJournal(), using the times and
+     * random choices they were originally made with. Replay stops at the
+     * first truncated or corrupt record.
+     *
+     * @param[in] records        Concatenated journal records.
+     * @param[in] base_sequence  SerializedJournalSequence() of the loaded state.
+     *                           Records up to it are already part of that state and skipped.
+     * @return                   The number of bytes successfully replayed.
+     */
+    size_t ReplayJournal(std::span<const std::byte> records, uint64_t base_sequence);
+
     /** Test-only function
      * Find the address record in AddrMan and return information about its
      * position.
@@ -10,13 +10,18 @@
 #include <netaddress.h>
 #include <protocol.h>
 #include <serialize.h>
+#include <streams.h>
 #include <sync.h>
 #include <uint256.h>
 #include <util/time.h>
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <set>
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -31,6 +36,8 @@ static constexpr int ADDRMAN_NEW_BUCKET_COUNT{1 << ADDRMAN_NEW_BUCKET_COUNT_LOG2
 /** Maximum allowed number of entries in buckets for new and tried addresses */
 static constexpr int32_t ADDRMAN_BUCKET_SIZE_LOG2{6};
 static constexpr int ADDRMAN_BUCKET_SIZE{1 << ADDRMAN_BUCKET_SIZE_LOG2};
+/** Maximum age of the table snapshot served to Select() after the tables were modified */
+static constexpr auto ADDRMAN_SNAPSHOT_MAX_AGE{1s};
 
 /**
  * User-defined type for the internally used nIds
@@ -133,10 +140,10 @@ public:
     std::pair<CAddress, NodeSeconds> SelectTriedCollision() EXCLUSIVE_LOCKS_REQUIRED(!cs);
 
     std::pair<CAddress, NodeSeconds> Select(bool new_only, const std::unordered_set<Network>& networks) const
-        EXCLUSIVE_LOCKS_REQUIRED(!cs);
+        EXCLUSIVE_LOCKS_REQUIRED(!cs, !m_snapshot_mutex);
 
     std::vector<CAddress> GetAddr(size_t max_addresses, size_t max_pct, std::optional<Network> network, const bool filtered = true) const
-        EXCLUSIVE_LOCKS_REQUIRED(!cs);
+        EXCLUSIVE_LOCKS_REQUIRED(!cs, !m_snapshot_mutex);
 
     std::vector<std::pair<AddrInfo, AddressPosition>> GetEntries(bool from_tried) const
         EXCLUSIVE_LOCKS_REQUIRED(!cs);
@@ -150,6 +157,14 @@ public:
     std::optional<AddressPosition> FindAddressEntry(const CAddress& addr)
         EXCLUSIVE_LOCKS_REQUIRED(!cs);
 
+    void EnableJournal(size_t max_bytes) EXCLUSIVE_LOCKS_REQUIRED(!cs);
+
+    std::optional<std::vector<std::byte>> TakeJournal() EXCLUSIVE_LOCKS_REQUIRED(!cs);
+
+    uint64_t SerializedJournalSequence() const EXCLUSIVE_LOCKS_REQUIRED(!cs);
+
+    size_t ReplayJournal(std::span<const std::byte> records, uint64_t base_sequence) EXCLUSIVE_LOCKS_REQUIRED(!cs);
+
     friend class AddrManDeterministic;
 
 private:
@@ -231,6 +246,76 @@ private:
     /** Number of entries in addrman per network and new/tried table. */
     std::unordered_map<Network, NewTriedCount> m_network_counts GUARDED_BY(cs);
 
+    /**
+     * Immutable copy of the new and tried tables. Select() and GetAddr() run
+     * on the most recently published snapshot instead of taking cs, so that
+     * they do not contend with the addr relay path adding addresses.
+     */
+    struct Snapshot {
+        //! Value of m_version the snapshot was taken at.
+        uint64_t version{0};
+        SteadyClock::time_point time;
+        //! Copies of all entries, in no particular order.
+        std::vector<AddrInfo> entries;
+        //! Index into entries for every position of the new/tried tables, -1 if empty.
+        std::vector<int32_t> new_table;
+        std::vector<int32_t> tried_table;
+        size_t n_new{0};
+        size_t n_tried{0};
+        std::unordered_map<Network, NewTriedCount> network_counts;
+    };
+
+    //! Incremented by every modification of the tables. Only written while holding cs.
+    std::atomic<uint64_t> m_version{0};
+
+    //! Oldest m_version a snapshot may have been taken at to still be used. Modifications other
+    //! than adding addresses, such as Attempt() and Good(), raise it to their own version, as
+    //! Select() must see them right away. Only written while holding cs.
+    std::atomic<uint64_t> m_min_snapshot_version{0};
+
+    //! How long Select() may be served a snapshot that misses addresses added since.
+    //! Taking a snapshot copies all tables, so it is not done after every Add().
+    const std::chrono::milliseconds m_snapshot_max_age;
+
+    //! Protects publishing m_snapshot. May be acquired while holding cs, but not the other way around.
+    mutable Mutex m_snapshot_mutex;
+
+    mutable std::shared_ptr<const Snapshot> m_snapshot GUARDED_BY(m_snapshot_mutex);
+
+    //! Seeds the randomness of each Select() and GetAddr() call.
+    mutable FastRandomContext m_snapshot_rand GUARDED_BY(m_snapshot_mutex);
+
+    //! Types of journal records, see EnableJournal().
+    enum class JournalRecord : uint8_t {
+        ADD = 'a',
+        GOOD = 'g',
+        ATTEMPT = 't',
+        CONNECTED = 'c',
+        SERVICES = 's',
+    };
+
+    //! Maximum size of m_journal, or nullopt if journaling is disabled.
+    std::optional<size_t> m_journal_max_bytes GUARDED_BY(cs);
+
+    //! Modifications since the last TakeJournal().
+    DataStream m_journal GUARDED_BY(cs);
+
+    //! Whether records were dropped from m_journal because it grew too large.
+    bool m_journal_overflow GUARDED_BY(cs){false};
+
+    //! Whether ReplayJournal() is running, so replayed modifications are not journaled again.
+    bool m_journal_replaying GUARDED_BY(cs){false};
+
+    //! Sequence number of the last journal record.
+    uint64_t m_journal_sequence GUARDED_BY(cs){0};
+
+    //! Value of m_journal_sequence at the last Serialize(), i.e. of the last record reflected in its output.
+    mutable uint64_t m_journal_serialized_sequence GUARDED_BY(cs){0};
+
+    //! Append a record of the given type and fields to m_journal, if journaling is enabled.
+    template <typename... Args>
+    void Journal(JournalRecord type, const Args&... args) EXCLUSIVE_LOCKS_REQUIRED(cs);
+
     //! Find an entry.
     AddrInfo* Find(const CService& addr, nid_type* pnId = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
@@ -250,16 +335,21 @@ private:
     void MakeTried(AddrInfo& info, nid_type nId) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
     /** Attempt to add a single address to addrman's new table.
-     *  @see AddrMan::Add() for parameters. */
-    bool AddSingle(const CAddress& addr, const CNetAddr& source, std::chrono::seconds time_penalty) EXCLUSIVE_LOCKS_REQUIRED(cs);
+     *  @see AddrMan::Add() for parameters.
+     *  @param[in,out] admit  Outcome of the stochastic test for adding another reference
+     *                        to an existing entry. Drawn and returned if unset. */
+    bool AddSingle(const CAddress& addr, const CNetAddr& source, std::chrono::seconds time_penalty, NodeSeconds now, std::optional<bool>& admit) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
     bool Good_(const CService& addr, bool test_before_evict, NodeSeconds time) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
-    bool Add_(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    /** @param[in] now       Current time, or the time the addition was journaled when replaying it.
+     *  @param[in] rejected  Addresses rejected by the stochastic test in AddSingle(), or nullptr to draw it. */
+    bool Add_(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty,
+              NodeSeconds now, const std::vector<uint8_t>* rejected = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
     void Attempt_(const CService& addr, bool fCountFailure, NodeSeconds time) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
-    std::pair<CAddress, NodeSeconds> Select_(bool new_only, const std::unordered_set<Network>& networks) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+    std::pair<CAddress, NodeSeconds> Select_(const Snapshot& snapshot, FastRandomContext& rng, bool new_only, const std::unordered_set<Network>& networks) const;
 
     /** Helper to generalize looking up an addrman entry from either table.
      *
@@ -267,7 +357,21 @@ private:
      * */
     nid_type GetEntry(bool use_tried, size_t bucket, size_t position) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
-    std::vector<CAddress> GetAddr_(size_t max_addresses, size_t max_pct, std::optional<Network> network, const bool filtered = true) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+    //! @param[in] count  Number of entries to pick from.
+    //! @param[in] entry  Returns the entry at an index below count.
+    std::vector<CAddress> GetAddr_(size_t count, const std::function<const AddrInfo&(size_t)>& entry, FastRandomContext& rng, size_t max_addresses, size_t max_pct, std::optional<Network> network, const bool filtered = true) const;
+
+    //! Record a modification of the tables, which the snapshot does not have yet.
+    //! @param[in] only_added  Whether addresses were only added, which Select() may miss for up to m_snapshot_max_age.
+    void InvalidateSnapshot(bool only_added = false) EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+    //! Copy the tables into a new snapshot.
+    std::shared_ptr<const Snapshot> MakeSnapshot() const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+    //! Return a snapshot of the tables that at most misses addresses added in the last m_snapshot_max_age,
+    //! taking a new one if needed.
+    //! @param[out] seed  Seed for the randomness of the caller.
+    std::shared_ptr<const Snapshot> GetSnapshot(uint256& seed) const EXCLUSIVE_LOCKS_REQUIRED(!cs, !m_snapshot_mutex);
 
     std::vector<std::pair<AddrInfo, AddressPosition>> GetEntries_(bool from_tried) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
@@ -15,14 +15,18 @@
 #include <util/check.h>
 #include <util/time.h>
 
+#include <atomic>
 #include <cstring>
 #include <optional>
+#include <thread>
 #include <vector>
 
 /* A "source" is a source address from which we have received a bunch of other addresses. */
 
 static constexpr size_t NUM_SOURCES = 64;
 static constexpr size_t NUM_ADDRESSES_PER_SOURCE = 256;
+/* Number of threads feeding addresses into addrman in the concurrent benchmarks. */
+static constexpr size_t NUM_ADD_THREADS = 2;
 
 static NetGroupManager EMPTY_NETGROUPMAN{std::vector<bool>()};
 static constexpr uint32_t ADDRMAN_CONSISTENCY_CHECK_RATIO{0};
@@ -149,6 +153,57 @@ static void AddrManGetAddr(benchmark::Bench& bench)
     });
 }
 
+/* Keep re-adding the known addresses from background threads, as the addr relay path of a busy node does. */
+class ConcurrentAdder
+{
+    std::atomic<bool> m_stop{false};
+    std::vector<std::thread> m_threads;
+
+public:
+    explicit ConcurrentAdder(AddrMan& addrman)
+    {
+        for (size_t thread_i = 0; thread_i < NUM_ADD_THREADS; ++thread_i) {
+            m_threads.emplace_back([&, thread_i] {
+                for (size_t source_i = thread_i; !m_stop; source_i = (source_i + NUM_ADD_THREADS) % NUM_SOURCES) {
+                    addrman.Add(g_addresses[source_i], g_sources[source_i]);
+                }
+            });
+        }
+    }
+
+    ~ConcurrentAdder()
+    {
+        m_stop = true;
+        for (auto& thread : m_threads) thread.join();
+    }
+};
+
+static void AddrManSelectConcurrentAdd(benchmark::Bench& bench)
+{
+    AddrMan addrman{EMPTY_NETGROUPMAN, /*deterministic=*/false, ADDRMAN_CONSISTENCY_CHECK_RATIO};
+
+    FillAddrMan(addrman);
+    ConcurrentAdder adder{addrman};
+
+    bench.run([&] {
+        const auto& address = addrman.Select();
+        assert(address.first.GetPort() > 0);
+    });
+}
+
+static void AddrManGetAddrConcurrentAdd(benchmark::Bench& bench)
+{
+    AddrMan addrman{EMPTY_NETGROUPMAN, /*deterministic=*/false, ADDRMAN_CONSISTENCY_CHECK_RATIO};
+
+    FillAddrMan(addrman);
+    ConcurrentAdder adder{addrman};
+
+    bench.run([&] {
+        const auto& addresses = addrman.GetAddr(/*max_addresses=*/2500, /*max_pct=*/23, /*network=*/std::nullopt);
+        assert(addresses.size() > 0);
+    });
+}
+
 static void AddrManAddThenGood(benchmark::Bench& bench)
 {
     auto markSomeAsGood = [](AddrMan& addrman) {
@@ -181,3 +236,5 @@ BENCHMARK(AddrManSelectFromAlmostEmpty, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddrManSelectByNetwork, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddrManGetAddr, benchmark::PriorityLevel::HIGH);
 BENCHMARK(AddrManAddThenGood, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddrManSelectConcurrentAdd, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddrManGetAddrConcurrentAdd, benchmark::PriorityLevel::HIGH);
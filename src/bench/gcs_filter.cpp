@@ -4,9 +4,13 @@
 
 #include <bench/bench.h>
 #include <blockfilter.h>
+#include <serialize.h>
+#include <streams.h>
 #include <uint256.h>
+#include <util/golombrice.h>
 
 #include <cstdint>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -86,8 +90,67 @@ static void GCSFilterMatch(benchmark::Bench& bench)
         filter.Match(GCSFilter::Element());
     });
 }
+
+static void GCSFilterMatchAny(benchmark::Bench& bench)
+{
+    auto elements = GenerateGCSTestElements();
+
+    GCSFilter filter({0, 0, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+
+    // A wallet rescan checks many scripts against every filter, none of which usually match.
+    GCSFilter::ElementSet needles;
+    for (int i = 0; i < 1000; ++i) {
+        GCSFilter::Element needle(34);
+        needle[33] = static_cast<unsigned char>(i);
+        needle[32] = static_cast<unsigned char>(i >> 8);
+        needles.insert(std::move(needle));
+    }
+
+    bench.run([&] {
+        filter.MatchAny(needles);
+    });
+}
+
+/** Decode all Golomb-Rice codes of the filter bit by bit, as a baseline for GolombRiceReader. */
+static void GCSFilterDecodeBitStream(benchmark::Bench& bench)
+{
+    auto elements = GenerateGCSTestElements();
+
+    GCSFilter filter({0, 0, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+    const auto& encoded = filter.GetEncoded();
+
+    bench.batch(filter.GetN()).unit("elem").run([&] {
+        SpanReader stream{encoded};
+        const uint64_t n{ReadCompactSize(stream)};
+        BitStreamReader bitreader{stream};
+        uint64_t sum{0};
+        for (uint64_t i = 0; i < n; ++i) sum += GolombRiceDecode(bitreader, BASIC_FILTER_P);
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+}
+
+/** Decode all Golomb-Rice codes of the filter with GolombRiceReader. */
+static void GCSFilterDecodeBulk(benchmark::Bench& bench)
+{
+    auto elements = GenerateGCSTestElements();
+
+    GCSFilter filter({0, 0, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+    const auto& encoded = filter.GetEncoded();
+
+    bench.batch(filter.GetN()).unit("elem").run([&] {
+        SpanReader stream{encoded};
+        const uint64_t n{ReadCompactSize(stream)};
+        GolombRiceReader reader{std::span{encoded}.subspan(encoded.size() - stream.size())};
+        uint64_t sum{0};
+        for (uint64_t i = 0; i < n; ++i) sum += reader.Decode(BASIC_FILTER_P);
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    });
+}
 BENCHMARK(GCSBlockFilterGetHash, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterConstruct, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecode, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecodeSkipCheck, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterMatch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterMatchAny, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterDecodeBitStream, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterDecodeBulk, benchmark::PriorityLevel::HIGH);
@@ -3,7 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <bench/data/block413567.raw.h>
+#include <crypto/hex_base.h>
 #include <random.h>
+#include <tinyformat.h>
 #include <util/strencodings.h>
 
 #include <cassert>
@@ -34,4 +37,24 @@ static void HexParse(benchmark::Bench& bench)
     });
 }
 
+static void HexParseBlock(benchmark::Bench& bench)
+{
+    const std::string data{HexStr(benchmark::data::block413567)};
+
+    bench.batch(data.size()).unit("base16").run([&] {
+        auto result = TryParseHex(data);
+        assert(result != std::nullopt);
+        ankerl::nanobench::doNotOptimizeAway(result);
+    });
+}
+
+static void HexParseBlockStandard(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' hex implementation", __func__, HexAutoDetect(hex_implementation::STANDARD)));
+    HexParseBlock(bench);
+    HexAutoDetect();
+}
+
 BENCHMARK(HexParse, benchmark::PriorityLevel::HIGH);
+BENCHMARK(HexParseBlock, benchmark::PriorityLevel::HIGH);
+BENCHMARK(HexParseBlockStandard, benchmark::PriorityLevel::HIGH);
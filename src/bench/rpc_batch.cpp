@@ -0,0 +1,61 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/data/block413567.raw.h>
+#include <core_io.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <rpc/request.h>
+#include <rpc/server.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <univalue.h>
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/** Decode every transaction of a block in one batch request, using up to max_parallel threads. */
+static void RpcBatch(benchmark::Bench& bench, size_t max_parallel)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
+    if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
+
+    CBlock block;
+    DataStream{benchmark::data::block413567} >> TX_WITH_WITNESS(block);
+    UniValue batch{UniValue::VARR};
+    for (const CTransactionRef& tx : block.vtx) {
+        UniValue request{UniValue::VOBJ};
+        request.pushKV("jsonrpc", "2.0");
+        request.pushKV("id", batch.size());
+        request.pushKV("method", "decoderawtransaction");
+        UniValue params{UniValue::VARR};
+        params.push_back(EncodeHexTx(*tx));
+        request.pushKV("params", std::move(params));
+        batch.push_back(std::move(request));
+    }
+
+    JSONRPCRequest jreq;
+    jreq.context = &testing_setup->m_node;
+    bench.run([&] {
+        std::vector<std::thread> workers;
+        const UniValue reply{JSONRPCExecBatch(jreq, batch, max_parallel, [&](std::function<void()> func) {
+            workers.emplace_back(std::move(func));
+            return true;
+        })};
+        for (std::thread& worker : workers) worker.join();
+        assert(reply.size() == block.vtx.size());
+    });
+}
+
+static void RpcBatchSequential(benchmark::Bench& bench) { RpcBatch(bench, /*max_parallel=*/1); }
+static void RpcBatchParallel(benchmark::Bench& bench) { RpcBatch(bench, /*max_parallel=*/4); }
+
+BENCHMARK(RpcBatchSequential, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RpcBatchParallel, benchmark::PriorityLevel::HIGH);
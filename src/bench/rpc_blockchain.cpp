@@ -17,8 +17,10 @@
 #include <univalue.h>
 #include <validation.h>
 
+#include <cassert>
 #include <cstddef>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace {
@@ -69,3 +71,18 @@ static void BlockToJsonVerboseWrite(benchmark::Bench& bench)
 }
 
 BENCHMARK(BlockToJsonVerboseWrite, benchmark::PriorityLevel::HIGH);
+
+static void BlockToJsonVerboseRead(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    const std::string json{blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit).write()};
+    bench.run([&] {
+        UniValue univalue;
+        bool ok{univalue.read(json)};
+        assert(ok);
+        ankerl::nanobench::doNotOptimizeAway(univalue);
+    });
+}
+
+BENCHMARK(BlockToJsonVerboseRead, benchmark::PriorityLevel::HIGH);
@@ -15,7 +15,9 @@
 #include <univalue.h>
 #include <util/check.h>
 
+#include <cassert>
 #include <memory>
+#include <string>
 #include <vector>
 
 
@@ -25,12 +27,8 @@ static void AddTx(const CTransactionRef& tx, const CAmount& fee, CTxMemPool& poo
     AddToMempool(pool, CTxMemPoolEntry(tx, fee, /*time=*/0, /*entry_height=*/1, /*entry_sequence=*/0, /*spends_coinbase=*/false, /*sigops_cost=*/4, lp));
 }
 
-static void RpcMempool(benchmark::Bench& bench)
+static void FillMempool(CTxMemPool& pool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
 {
-    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
-    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
-    LOCK2(cs_main, pool.cs);
-
     for (int i = 0; i < 1000; ++i) {
         CMutableTransaction tx = CMutableTransaction();
         tx.vin.resize(1);
@@ -42,10 +40,50 @@ static void RpcMempool(benchmark::Bench& bench)
         const CTransactionRef tx_r{MakeTransactionRef(tx)};
         AddTx(tx_r, /*fee=*/i, pool);
     }
+}
+
+static void RpcMempool(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    LOCK2(cs_main, pool.cs);
+    FillMempool(pool);
 
     bench.run([&] {
         (void)MempoolToJSON(pool, /*verbose=*/true);
     });
 }
 
+static void RpcMempoolWrite(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    LOCK2(cs_main, pool.cs);
+    FillMempool(pool);
+    const UniValue univalue{MempoolToJSON(pool, /*verbose=*/true)};
+
+    bench.run([&] {
+        auto str = univalue.write();
+        ankerl::nanobench::doNotOptimizeAway(str);
+    });
+}
+
+static void RpcMempoolRead(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    LOCK2(cs_main, pool.cs);
+    FillMempool(pool);
+    const std::string json{MempoolToJSON(pool, /*verbose=*/true).write()};
+
+    bench.run([&] {
+        UniValue univalue;
+        bool ok{univalue.read(json)};
+        assert(ok);
+        ankerl::nanobench::doNotOptimizeAway(univalue);
+    });
+}
+
 BENCHMARK(RpcMempool, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RpcMempoolWrite, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RpcMempoolRead, benchmark::PriorityLevel::HIGH);
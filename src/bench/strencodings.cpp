@@ -4,7 +4,9 @@
 
 #include <bench/bench.h>
 #include <bench/data/block413567.raw.h>
+#include <crypto/hex_base.h>
 #include <span.h>
+#include <tinyformat.h>
 #include <util/strencodings.h>
 
 #include <vector>
@@ -18,4 +20,12 @@ static void HexStrBench(benchmark::Bench& bench)
     });
 }
 
+static void HexStrBenchStandard(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' hex implementation", __func__, HexAutoDetect(hex_implementation::STANDARD)));
+    HexStrBench(bench);
+    HexAutoDetect();
+}
+
 BENCHMARK(HexStrBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(HexStrBenchStandard, benchmark::PriorityLevel::HIGH);
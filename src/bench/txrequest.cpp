@@ -0,0 +1,73 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <net.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <txrequest.h>
+#include <uint256.h>
+
+#include <cassert>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/** Run num_txs transactions through the full announce/request/receive cycle. Every transaction is announced by
+ *  announcers_per_tx random peers out of num_peers, of which one in four is preferred (and announces without delay).
+ *  Each step, every peer is asked for its requestable transactions, which are then requested and received. */
+static void TxRequestCycle(benchmark::Bench& bench, int num_peers, int num_txs, int announcers_per_tx)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<uint256> txhashes;
+    std::vector<std::vector<NodeId>> announcers;
+    for (int i = 0; i < num_txs; ++i) {
+        txhashes.push_back(rng.rand256());
+        auto& peers = announcers.emplace_back();
+        for (int j = 0; j < announcers_per_tx; ++j) peers.push_back(rng.randrange(num_peers));
+    }
+
+    bench.batch(num_txs).unit("tx").run([&] {
+        TxRequestTracker tracker{/*deterministic=*/true};
+        std::chrono::microseconds now{1s};
+        for (int i = 0; i < num_txs; ++i) {
+            for (NodeId peer : announcers[i]) {
+                const bool preferred{peer % 4 == 0};
+                tracker.ReceivedInv(peer, GenTxid::Wtxid(txhashes[i]), preferred, preferred ? now : now + 2s);
+            }
+        }
+
+        std::vector<std::pair<NodeId, uint256>> requested;
+        while (tracker.Size() > 0) {
+            now += 1s;
+            for (NodeId peer = 0; peer < num_peers; ++peer) {
+                for (const GenTxid& gtxid : tracker.GetRequestable(peer, now)) {
+                    tracker.RequestedTx(peer, gtxid.GetHash(), now + 60s);
+                    requested.emplace_back(peer, gtxid.GetHash());
+                }
+            }
+            for (const auto& [peer, txhash] : requested) {
+                tracker.ReceivedResponse(peer, txhash);
+                tracker.ForgetTxHash(txhash);
+            }
+            requested.clear();
+        }
+        assert(tracker.Size() == 0);
+    });
+}
+
+static void TxRequestTracker125Peers(benchmark::Bench& bench)
+{
+    TxRequestCycle(bench, /*num_peers=*/125, /*num_txs=*/10000, /*announcers_per_tx=*/8);
+}
+
+static void TxRequestTracker1000Peers(benchmark::Bench& bench)
+{
+    TxRequestCycle(bench, /*num_peers=*/1000, /*num_txs=*/20000, /*announcers_per_tx=*/32);
+}
+
+BENCHMARK(TxRequestTracker125Peers, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxRequestTracker1000Peers, benchmark::PriorityLevel::HIGH);
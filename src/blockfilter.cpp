@@ -61,11 +61,12 @@ GCSFilter::GCSFilter(const Params& params, std::vector<unsigned char> encoded_fi
 
     // Verify that the encoded filter contains exactly N elements. If it has too much or too little
     // data, a std::ios_base::failure exception will be raised.
-    BitStreamReader bitreader{stream};
+    const auto data{std::span{m_encoded}.subspan(m_encoded.size() - stream.size())};
+    GolombRiceReader reader{data};
     for (uint64_t i = 0; i < m_N; ++i) {
-        GolombRiceDecode(bitreader, m_params.m_P);
+        reader.Decode(m_params.m_P);
     }
-    if (!stream.empty()) {
+    if (reader.GetBytesRead() != data.size()) {
         throw std::ios_base::failure("encoded_filter contains excess data");
     }
 }
@@ -108,12 +109,12 @@ bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
     uint64_t N = ReadCompactSize(stream);
     assert(N == m_N);
 
-    BitStreamReader bitreader{stream};
+    GolombRiceReader reader{std::span{m_encoded}.subspan(m_encoded.size() - stream.size())};
 
     uint64_t value = 0;
     size_t hashes_index = 0;
     for (uint32_t i = 0; i < m_N; ++i) {
-        uint64_t delta = GolombRiceDecode(bitreader, m_params.m_P);
+        uint64_t delta = reader.Decode(m_params.m_P);
         value += delta;
 
         while (true) {
@@ -198,6 +198,8 @@ public:
     }
 
     bool HasThreads() const { return !m_worker_threads.empty(); }
+
+    int NumThreads() const { return m_worker_threads.size(); }
 };
 
 /**
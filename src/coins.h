@@ -243,6 +243,9 @@ public:
     virtual bool Valid() const = 0;
     virtual void Next() = 0;
 
+    //! Move to the first coin at or after start. Returns false if the cursor cannot seek.
+    virtual bool Seek(const COutPoint& start) { return false; }
+
     //! Get best block at the time this cursor was created
     const uint256 &GetBestBlock() const { return hashBlock; }
 private:
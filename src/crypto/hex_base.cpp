@@ -4,12 +4,38 @@
 
 #include <crypto/hex_base.h>
 
+#include <compat/cpuid.h>
+
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstring>
 #include <string>
 
+namespace hex_sse41 {
+size_t Encode(const uint8_t* in, size_t size, char* out);
+size_t Decode(const char* in, size_t size, uint8_t* out);
+} // namespace hex_sse41
+
+namespace hex_avx2 {
+size_t Encode(const uint8_t* in, size_t size, char* out);
+size_t Decode(const char* in, size_t size, uint8_t* out);
+} // namespace hex_avx2
+
 namespace {
 
+/** Encode a prefix of `size` bytes in whole blocks. Returns the number of bytes encoded. */
+using EncodeBlocksFn = size_t (*)(const uint8_t* in, size_t size, char* out);
+/** Decode up to `size` bytes in whole blocks, stopping at the first block with a non-digit. Returns the number of bytes decoded. */
+using DecodeBlocksFn = size_t (*)(const char* in, size_t size, uint8_t* out);
+
+size_t EncodeNoBlocks(const uint8_t*, size_t, char*) { return 0; }
+size_t DecodeNoBlocks(const char*, size_t, uint8_t*) { return 0; }
+
+// Set by HexAutoDetect. Until then, everything is encoded one byte at a time.
+EncodeBlocksFn EncodeBlocks = EncodeNoBlocks;
+DecodeBlocksFn DecodeBlocks = DecodeNoBlocks;
+
 using ByteAsHex = std::array<char, 2>;
 
 constexpr std::array<ByteAsHex, 256> CreateByteToHexMap()
@@ -24,21 +50,39 @@ constexpr std::array<ByteAsHex, 256> CreateByteToHexMap()
     return byte_to_hex;
 }
 
+constexpr auto BYTE_TO_HEX{CreateByteToHexMap()};
+static_assert(sizeof(BYTE_TO_HEX) == 512);
+
 } // namespace
 
-std::string HexStr(const std::span<const uint8_t> s)
+void HexEncode(std::span<const uint8_t> s, std::span<char> out)
 {
-    std::string rv(s.size() * 2, '\0');
-    static constexpr auto byte_to_hex = CreateByteToHexMap();
-    static_assert(sizeof(byte_to_hex) == 512);
-
-    char* it = rv.data();
-    for (uint8_t v : s) {
-        std::memcpy(it, byte_to_hex[v].data(), 2);
+    assert(out.size() == s.size() * 2);
+    const size_t done{EncodeBlocks(s.data(), s.size(), out.data())};
+    char* it = out.data() + 2 * done;
+    for (uint8_t v : s.subspan(done)) {
+        std::memcpy(it, BYTE_TO_HEX[v].data(), 2);
         it += 2;
     }
+}
+
+size_t HexDecode(std::span<const char> in, std::span<uint8_t> out)
+{
+    const size_t size{std::min(in.size() / 2, out.size())};
+    size_t done{DecodeBlocks(in.data(), size, out.data())};
+    for (; done < size; ++done) {
+        const signed char high{HexDigit(in[2 * done])};
+        const signed char low{HexDigit(in[2 * done + 1])};
+        if (high < 0 || low < 0) break;
+        out[done] = uint8_t(high << 4) | uint8_t(low);
+    }
+    return done;
+}
 
-    assert(it == rv.data() + rv.size());
+std::string HexStr(const std::span<const uint8_t> s)
+{
+    std::string rv(s.size() * 2, '\0');
+    HexEncode(s, rv);
     return rv;
 }
 
@@ -65,3 +109,46 @@ signed char HexDigit(char c)
     return p_util_hexdigit[(unsigned char)c];
 }
 
+
+std::string HexAutoDetect([[maybe_unused]] hex_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    EncodeBlocks = EncodeNoBlocks;
+    DecodeBlocks = DecodeNoBlocks;
+
+#if defined(HAVE_GETCPUID)
+    [[maybe_unused]] bool have_sse41 = false;
+    [[maybe_unused]] bool have_avx2 = false;
+    [[maybe_unused]] bool enabled_avx = false;
+
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    have_sse41 = (ecx >> 19) & 1;
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    if (have_xsave && have_avx) {
+        enabled_avx = AVXEnabled();
+    }
+    if (have_sse41) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        have_avx2 = (ebx >> 5) & 1;
+    }
+
+#if defined(ENABLE_SSE41)
+    if (have_sse41 && (use_implementation & hex_implementation::USE_SSE41)) {
+        EncodeBlocks = hex_sse41::Encode;
+        DecodeBlocks = hex_sse41::Decode;
+        ret = "sse41";
+    }
+#endif
+#if defined(ENABLE_AVX2)
+    if (have_avx2 && enabled_avx && (use_implementation & hex_implementation::USE_AVX2)) {
+        EncodeBlocks = hex_avx2::Encode;
+        DecodeBlocks = hex_avx2::Decode;
+        ret = "avx2";
+    }
+#endif
+#endif // defined(HAVE_GETCPUID)
+
+    return ret;
+}
@@ -18,6 +18,33 @@ std::string HexStr(const std::span<const uint8_t> s);
 inline std::string HexStr(const std::span<const char> s) { return HexStr(MakeUCharSpan(s)); }
 inline std::string HexStr(const std::span<const std::byte> s) { return HexStr(MakeUCharSpan(s)); }
 
+/**
+ * Write the lower-case hexadecimal encoding of a span of bytes to `out`, which
+ * must have room for exactly two characters per byte.
+ */
+void HexEncode(std::span<const uint8_t> s, std::span<char> out);
+inline void HexEncode(std::span<const std::byte> s, std::span<char> out) { HexEncode(MakeUCharSpan(s), out); }
+
+/**
+ * Decode pairs of hex digits from the start of `in` into `out`, until a pair
+ * is not made of two hex digits or either span is used up.
+ *
+ * @returns the number of bytes written to `out`
+ */
+size_t HexDecode(std::span<const char> in, std::span<uint8_t> out);
+
 signed char HexDigit(char c);
 
+namespace hex_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_SSE41 = 1 << 0,
+    USE_AVX2 = 1 << 1,
+    USE_SSE41_AND_AVX2 = USE_SSE41 | USE_AVX2,
+};
+}
+
+/** Autodetect the best available hex encoding and decoding implementation. Returns its name. */
+std::string HexAutoDetect(hex_implementation::UseImplementation use_implementation = hex_implementation::USE_SSE41_AND_AVX2);
+
 #endif // BITCOIN_CRYPTO_HEX_BASE_H
@@ -0,0 +1,66 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace hex_avx2 {
+
+size_t Encode(const uint8_t* in, size_t size, char* out)
+{
+    const __m256i digits{_mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                          '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f')};
+    const __m256i low_nibble{_mm256_set1_epi8(0x0f)};
+    size_t done{0};
+    for (; done + 32 <= size; done += 32) {
+        const __m256i bytes{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + done))};
+        const __m256i high{_mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_nibble))};
+        const __m256i low{_mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, low_nibble))};
+        // Interleaving works within 128-bit lanes, so the halves of the output are spread over both results.
+        const __m256i first{_mm256_unpacklo_epi8(high, low)};
+        const __m256i second{_mm256_unpackhi_epi8(high, low)};
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * done), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * done + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return done;
+}
+
+namespace {
+/** Map 32 hex digits to their values, or return false if any is not a hex digit. */
+bool inline DigitValues(__m256i chars, __m256i& values)
+{
+    const __m256i digit{_mm256_sub_epi8(chars, _mm256_set1_epi8('0'))};
+    const __m256i letter{_mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'))};
+    const __m256i is_digit{_mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit)};
+    const __m256i is_letter{_mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter)};
+    if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)) != -1) return false;
+    values = _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, is_digit);
+    return true;
+}
+} // namespace
+
+size_t Decode(const char* in, size_t size, uint8_t* out)
+{
+    // Multiplying every pair of values by (16, 1) and adding them up combines them into a byte.
+    const __m256i combine{_mm256_set1_epi16(0x0110)};
+    size_t done{0};
+    for (; done + 32 <= size; done += 32) {
+        __m256i first, second;
+        if (!DigitValues(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * done)), first) ||
+            !DigitValues(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * done + 32)), second)) {
+            break;
+        }
+        // Packing works within 128-bit lanes as well, so put the 64-bit parts back in order.
+        const __m256i bytes{_mm256_packus_epi16(_mm256_maddubs_epi16(first, combine), _mm256_maddubs_epi16(second, combine))};
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + done), _mm256_permute4x64_epi64(bytes, 0xd8));
+    }
+    return done;
+}
+
+} // namespace hex_avx2
+
+#endif
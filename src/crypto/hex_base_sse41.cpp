@@ -0,0 +1,61 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_SSE41
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace hex_sse41 {
+
+size_t Encode(const uint8_t* in, size_t size, char* out)
+{
+    const __m128i digits{_mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f')};
+    const __m128i low_nibble{_mm_set1_epi8(0x0f)};
+    size_t done{0};
+    for (; done + 16 <= size; done += 16) {
+        const __m128i bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done))};
+        const __m128i high{_mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibble))};
+        const __m128i low{_mm_shuffle_epi8(digits, _mm_and_si128(bytes, low_nibble))};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * done), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * done + 16), _mm_unpackhi_epi8(high, low));
+    }
+    return done;
+}
+
+namespace {
+/** Map 16 hex digits to their values, or return false if any is not a hex digit. */
+bool inline DigitValues(__m128i chars, __m128i& values)
+{
+    const __m128i digit{_mm_sub_epi8(chars, _mm_set1_epi8('0'))};
+    const __m128i letter{_mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'))};
+    const __m128i is_digit{_mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit)};
+    const __m128i is_letter{_mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter)};
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xffff) return false;
+    values = _mm_blendv_epi8(_mm_add_epi8(letter, _mm_set1_epi8(10)), digit, is_digit);
+    return true;
+}
+} // namespace
+
+size_t Decode(const char* in, size_t size, uint8_t* out)
+{
+    // Multiplying every pair of values by (16, 1) and adding them up combines them into a byte.
+    const __m128i combine{_mm_set1_epi16(0x0110)};
+    size_t done{0};
+    for (; done + 16 <= size; done += 16) {
+        __m128i first, second;
+        if (!DigitValues(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * done)), first) ||
+            !DigitValues(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * done + 16)), second)) {
+            break;
+        }
+        const __m128i bytes{_mm_packus_epi16(_mm_maddubs_epi16(first, combine), _mm_maddubs_epi16(second, combine))};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done), bytes);
+    }
+    return done;
+}
+
+} // namespace hex_sse41
+
+#endif
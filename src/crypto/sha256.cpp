@@ -568,17 +568,6 @@ bool SelfTest() {
     return true;
 }
 
-#if !defined(DISABLE_OPTIMIZED_SHA256)
-#if (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
-/** Check whether the OS has enabled AVX registers. */
-bool AVXEnabled()
-{
-    uint32_t a, d;
-    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
-    return (a & 6) == 6;
-}
-#endif
-#endif // DISABLE_OPTIMIZED_SHA256
 } // namespace
 
 
@@ -9,23 +9,34 @@
 #include <httpserver.h>
 #include <logging.h>
 #include <netaddress.h>
+#include <node/interface_ui.h>
+#include <rpc/cbor.h>
+#include <rpc/jsonstream.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
+#include <sync.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/time.h>
 #include <walletinitinterface.h>
 
 #include <algorithm>
+#include <chrono>
+#include <functional>
 #include <iterator>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <boost/signals2/connection.hpp>
+
 using util::SplitString;
 using util::TrimStringView;
 
@@ -76,8 +87,21 @@ static std::vector<std::vector<std::string>> g_rpcauth;
 /* RPC Auth Whitelist */
 static std::map<std::string, std::set<std::string>> g_rpc_whitelist;
 static bool g_rpc_whitelist_default = false;
+static size_t g_rpc_batch_parallel{DEFAULT_RPC_BATCH_PARALLEL};
 
-static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCRequest& jreq)
+/** Send a reply in the binary encoding if the client asked for it, and as JSON otherwise. */
+static void WriteRPCReply(HTTPRequest* req, int status, const UniValue& reply, bool cbor)
+{
+    if (cbor) {
+        req->WriteHeader("Content-Type", std::string{CBOR_MEDIA_TYPE});
+        req->WriteReply(status, EncodeCBOR(reply));
+    } else {
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(status, reply.write() + "\n");
+    }
+}
+
+static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCRequest& jreq, bool cbor)
 {
     // Sending HTTP errors is a legacy JSON-RPC behavior.
     Assume(jreq.m_json_version != JSONRPCVersion::V2);
@@ -91,12 +115,207 @@ static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCReq
     else if (code == RPC_METHOD_NOT_FOUND)
         nStatus = HTTP_NOT_FOUND;
 
-    std::string strReply = JSONRPCReplyObj(NullUniValue, std::move(objError), jreq.id, jreq.m_json_version).write() + "\n";
+    WriteRPCReply(req, nStatus, JSONRPCReplyObj(NullUniValue, std::move(objError), jreq.id, jreq.m_json_version), cbor);
+}
 
-    req->WriteHeader("Content-Type", "application/json");
-    req->WriteReply(nStatus, strReply);
+/**
+ * Execute a single request, giving the method the chance to stream its result
+ * to the client (see JSONRPCRequest::m_result_stream). Results that are
+ * returned rather than streamed, and streamed results small enough to never
+ * be flushed, are sent as a regular reply.
+ */
+static void JSONRPCExecStreaming(HTTPRequest* req, JSONRPCRequest& jreq, bool catch_errors)
+{
+    JSONStreamWriter stream{[req](std::string_view data) {
+        if (!req->IsChunkedReplyStarted()) {
+            req->WriteHeader("Content-Type", "application/json");
+            req->StartChunkedReply(HTTP_OK);
+        }
+        return req->WriteReplyChunk(data);
+    }};
+    // Same layout as JSONRPCReplyObj.
+    stream.BeginObject();
+    if (jreq.m_json_version == JSONRPCVersion::V2) stream.KeyValue("jsonrpc", "2.0");
+    stream.Key("result");
+
+    UniValue reply;
+    jreq.m_result_stream = &stream;
+    try {
+        reply = JSONRPCExec(jreq, catch_errors);
+    } catch (...) {
+        jreq.m_result_stream = nullptr;
+        if (!stream.Flushed()) throw;
+        LogPrintf("JSON-RPC method %s failed after part of its result was sent\n", jreq.strMethod);
+        req->EndChunkedReply();
+        return;
+    }
+    jreq.m_result_stream = nullptr;
+    // The reply is sent once the wait is over.
+    if (jreq.m_tip_wait && jreq.m_tip_wait->poll) return;
+
+    if (reply.find_value("error").isNull() && !stream.AwaitingValue() && stream.Depth() == 1) {
+        if (jreq.m_json_version == JSONRPCVersion::V1_LEGACY) stream.KeyValue("error", NullUniValue);
+        if (jreq.id.has_value()) stream.KeyValue("id", *jreq.id);
+        stream.EndObject();
+        const std::string tail{stream.TakeBuffer() + "\n"};
+        if (stream.Flushed()) {
+            if (!stream.Failed()) req->WriteReplyChunk(tail);
+            req->EndChunkedReply();
+        } else {
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK, tail);
+        }
+    } else if (stream.Flushed()) {
+        // Only possible if the method failed while streaming and JSON-RPC 2.0 errors are caught.
+        LogPrintf("JSON-RPC method %s failed after part of its result was sent\n", jreq.strMethod);
+        req->EndChunkedReply();
+    } else {
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, reply.write() + "\n");
+    }
 }
 
+/**
+ * Calls whose method waits for the chain tip to change (see RPCTipWait). They
+ * wait here without holding a worker thread and are polled on one whenever
+ * the tip changes or their wake-up time passes. The polls are queued from the
+ * event loop thread by a single event, which tip changes trigger and which is
+ * the timer for the earliest wake-up time.
+ */
+class TipWaitingCalls
+{
+    struct Call {
+        Call(std::unique_ptr<HTTPRequest> req_in, JSONRPCRequest jreq_in, bool cbor_in, RPCTipWait wait_in)
+            : req{std::move(req_in)}, jreq{std::move(jreq_in)}, cbor{cbor_in}, wait{std::move(wait_in)} {}
+
+        std::unique_ptr<HTTPRequest> req;
+        JSONRPCRequest jreq;
+        bool cbor;
+        RPCTipWait wait;
+        //! Being polled on a worker thread.
+        bool polling{true};
+        //! To be polled again as soon as possible, because the tip changed or
+        //! the work queue was full.
+        bool due{false};
+    };
+
+    //! How long to wait before retrying to queue a poll when the work queue is full.
+    static constexpr std::chrono::milliseconds RETRY_INTERVAL{100};
+
+    Mutex m_mutex;
+    std::list<std::shared_ptr<Call>> m_calls GUARDED_BY(m_mutex);
+    //! Null when not started or stopped.
+    std::unique_ptr<HTTPEvent> m_event GUARDED_BY(m_mutex);
+    bool m_tip_changed GUARDED_BY(m_mutex){false};
+    boost::signals2::connection m_tip_connection;
+
+    void ArmTimer(std::chrono::steady_clock::time_point now) EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+    {
+        std::optional<std::chrono::steady_clock::time_point> earliest;
+        for (const auto& call : m_calls) {
+            if (call->polling) continue;
+            const auto wake_at{call->due ? std::optional{now + RETRY_INTERVAL} : call->wait.wake_at};
+            if (wake_at && (!earliest || *wake_at < *earliest)) earliest = wake_at;
+        }
+        if (earliest && m_event) {
+            struct timeval tv{MillisToTimeval(std::max(std::chrono::ceil<std::chrono::milliseconds>(*earliest - now), std::chrono::milliseconds{0}))};
+            m_event->trigger(&tv);
+        }
+    }
+
+    //! Queue the polls of the calls that are due. Runs on the event loop thread.
+    void Wake() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        const auto now{std::chrono::steady_clock::now()};
+        const bool tip_changed{std::exchange(m_tip_changed, false)};
+        for (const auto& call : m_calls) {
+            if (tip_changed) call->due = true;
+            if (call->polling || !(call->due || (call->wait.wake_at && *call->wait.wake_at <= now))) continue;
+            call->polling = QueueHTTPWork(*call->req, [this, call] { Poll(call); });
+            call->due = !call->polling;
+        }
+        ArmTimer(now);
+    }
+
+    void Poll(const std::shared_ptr<Call>& call) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        const JSONRPCRequest& jreq{call->jreq};
+        const bool catch_errors{jreq.m_json_version == JSONRPCVersion::V2};
+        UniValue reply;
+        try {
+            while (true) {
+                if (auto result{call->wait.poll(call->wait.wake_at)}) {
+                    reply = JSONRPCReplyObj(std::move(*result), NullUniValue, jreq.id, jreq.m_json_version);
+                    break;
+                }
+                LOCK(m_mutex);
+                if (!m_event) throw JSONRPCError(RPC_CLIENT_NOT_CONNECTED, "Shutting down");
+                if (!std::exchange(call->due, false)) {
+                    call->polling = false;
+                    ArmTimer(std::chrono::steady_clock::now());
+                    return;
+                }
+            }
+        } catch (UniValue& e) {
+            if (!catch_errors) return Finish(call, [&] { JSONErrorReply(call->req.get(), std::move(e), jreq, call->cbor); });
+            reply = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
+        } catch (const std::exception& e) {
+            if (!catch_errors) return Finish(call, [&] { JSONErrorReply(call->req.get(), JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq, call->cbor); });
+            reply = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_MISC_ERROR, e.what()), jreq.id, jreq.m_json_version);
+        }
+        Finish(call, [&] { WriteRPCReply(call->req.get(), HTTP_OK, reply, call->cbor); });
+    }
+
+    void Finish(const std::shared_ptr<Call>& call, const std::function<void()>& write_reply) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_calls.remove(call));
+        write_reply();
+    }
+
+public:
+    void Start(struct event_base* base) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_event = std::make_unique<HTTPEvent>(base, /*deleteWhenTriggered=*/false, [this] { Wake(); }));
+        m_tip_connection = uiInterface.NotifyBlockTip_connect([this](SynchronizationState, const CBlockIndex&, double) {
+            LOCK(m_mutex);
+            if (!m_event) return;
+            m_tip_changed = true;
+            m_event->trigger(nullptr);
+        });
+    }
+
+    /** Finish all calls. Those not being polled are polled one last time on this thread. */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        m_tip_connection.disconnect();
+        std::unique_ptr<HTTPEvent> event;
+        std::vector<std::shared_ptr<Call>> idle;
+        {
+            LOCK(m_mutex);
+            event = std::move(m_event);
+            for (const auto& call : m_calls) {
+                if (!std::exchange(call->polling, true)) idle.push_back(call);
+            }
+        }
+        event.reset();
+        for (const auto& call : idle) Poll(call);
+    }
+
+    /**
+     * Take over a request whose method left its wait to the server. It is
+     * polled on this thread first, in case the tip changed in the meantime.
+     */
+    void Add(std::unique_ptr<HTTPRequest> req, JSONRPCRequest jreq, bool cbor, RPCTipWait wait) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        auto call{std::make_shared<Call>(std::move(req), std::move(jreq), cbor, std::move(wait))};
+        WITH_LOCK(m_mutex, m_calls.push_back(call));
+        Poll(call);
+    }
+};
+
+static TipWaitingCalls g_tip_waiting_calls;
+
 //This function checks username and password against -rpcauth
 //entries from config file.
 static bool CheckUserAuthorized(std::string_view user, std::string_view pass)
@@ -171,11 +390,22 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
         return false;
     }
 
+    // The request body is in the binary encoding if its Content-Type says so.
+    // The reply is if the request was, or if the client accepts it.
+    const bool cbor_request{IsCBORMediaType(req->GetHeader("content-type").second)};
+    const bool cbor_reply{cbor_request || IsCBORMediaType(req->GetHeader("accept").second)};
+
     try {
         // Parse request
         UniValue valRequest;
-        if (!valRequest.read(req->ReadBody()))
+        if (cbor_request) {
+            const std::string body{req->ReadBody()};
+            auto decoded{DecodeCBOR(std::as_bytes(std::span{body}))};
+            if (!decoded) throw JSONRPCError(RPC_PARSE_ERROR, "Parse error");
+            valRequest = std::move(*decoded);
+        } else if (!valRequest.read(req->ReadBody())) {
             throw JSONRPCError(RPC_PARSE_ERROR, "Parse error");
+        }
 
         // Set the URI
         jreq.URI = req->GetURI();
@@ -201,13 +431,27 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // 2.0 behavior is to catch exceptions and return HTTP success with
             // RPC errors, as long as there is not an actual HTTP server error.
             const bool catch_errors{jreq.m_json_version == JSONRPCVersion::V2};
-            reply = JSONRPCExec(jreq, catch_errors);
-
             if (jreq.IsNotification()) {
                 // Even though we do execute notifications, we do not respond to them
+                JSONRPCExec(jreq, catch_errors);
                 req->WriteReply(HTTP_NO_CONTENT);
                 return true;
             }
+            // Methods that wait for the chain tip to change may leave the wait
+            // to g_tip_waiting_calls instead of holding this thread.
+            RPCTipWait tip_wait;
+            jreq.m_tip_wait = &tip_wait;
+            if (cbor_reply) {
+                reply = JSONRPCExec(jreq, catch_errors);
+            } else {
+                JSONRPCExecStreaming(req, jreq, catch_errors);
+            }
+            jreq.m_tip_wait = nullptr;
+            if (tip_wait.poll) {
+                g_tip_waiting_calls.Add(req->Detach(), std::move(jreq), cbor_reply, std::move(tip_wait));
+                return true;
+            }
+            if (!cbor_reply) return true;
 
         // array of requests
         } else if (valRequest.isArray()) {
@@ -229,24 +473,11 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
                 }
             }
 
-            // Execute each request
-            reply = UniValue::VARR;
-            for (size_t i{0}; i < valRequest.size(); ++i) {
-                // Batches never throw HTTP errors, they are always just included
-                // in "HTTP OK" responses. Notifications never get any response.
-                UniValue response;
-                try {
-                    jreq.parse(valRequest[i]);
-                    response = JSONRPCExec(jreq, /*catch_errors=*/true);
-                } catch (UniValue& e) {
-                    response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
-                } catch (const std::exception& e) {
-                    response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
-                }
-                if (!jreq.IsNotification()) {
-                    reply.push_back(std::move(response));
-                }
-            }
+            // Execute the requests, spreading them over the worker threads
+            // if -rpcbatchparallel allows it
+            const size_t batch_size{valRequest.size()};
+            reply = JSONRPCExecBatch(jreq, std::move(valRequest), g_rpc_batch_parallel,
+                                     [req](std::function<void()> func) { return QueueHTTPWork(*req, std::move(func)); });
             // Return no response for an all-notification batch, but only if the
             // batch request is non-empty. Technically according to the JSON-RPC
             // 2.0 spec, an empty batch request should also return no response,
@@ -256,7 +487,7 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // relying on previous behavior. Return an empty array instead of an
             // empty response in this case to favor being backwards compatible
             // over complying with the JSON-RPC 2.0 spec in this case.
-            if (reply.size() == 0 && valRequest.size() > 0) {
+            if (reply.size() == 0 && batch_size > 0) {
                 req->WriteReply(HTTP_NO_CONTENT);
                 return true;
             }
@@ -264,13 +495,12 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
         else
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
 
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, reply.write() + "\n");
+        WriteRPCReply(req, HTTP_OK, reply, cbor_reply);
     } catch (UniValue& e) {
-        JSONErrorReply(req, std::move(e), jreq);
+        JSONErrorReply(req, std::move(e), jreq, cbor_reply);
         return false;
     } catch (const std::exception& e) {
-        JSONErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq);
+        JSONErrorReply(req, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq, cbor_reply);
         return false;
     }
     return true;
@@ -372,6 +602,7 @@ bool StartHTTPRPC(const std::any& context)
     LogDebug(BCLog::RPC, "Starting HTTP RPC server\n");
     if (!InitRPCAuthentication())
         return false;
+    g_rpc_batch_parallel = std::max<int64_t>(gArgs.GetIntArg("-rpcbatchparallel", DEFAULT_RPC_BATCH_PARALLEL), 1);
 
     auto handle_rpc = [context](HTTPRequest* req, const std::string&) { return HTTPReq_JSONRPC(context, req); };
     RegisterHTTPHandler("/", true, handle_rpc);
@@ -382,6 +613,7 @@ bool StartHTTPRPC(const std::any& context)
     assert(eventBase);
     httpRPCTimerInterface = std::make_unique<HTTPRPCTimerInterface>(eventBase);
     RPCSetTimerInterface(httpRPCTimerInterface.get());
+    g_tip_waiting_calls.Start(eventBase);
     return true;
 }
 
@@ -401,4 +633,5 @@ void StopHTTPRPC()
         RPCUnsetTimerInterface(httpRPCTimerInterface.get());
         httpRPCTimerInterface.reset();
     }
+    g_tip_waiting_calls.Stop();
 }
@@ -6,6 +6,10 @@
 #define BITCOIN_HTTPRPC_H
 
 #include <any>
+#include <cstddef>
+
+/** Default for -rpcbatchparallel, the number of entries of a batch request executed at the same time. */
+static constexpr size_t DEFAULT_RPC_BATCH_PARALLEL{1};
 
 /** Start HTTP RPC subsystem.
  * Precondition; HTTP and RPC has been started.
@@ -17,18 +17,24 @@
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/threadnames.h>
+#include <util/time.h>
 #include <util/translation.h>
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
 #include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <deque>
+#include <map>
 #include <memory>
 #include <optional>
 #include <span>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <sys/types.h>
@@ -61,6 +67,10 @@ public:
     {
         func(req.get(), path);
     }
+    void Reject() override
+    {
+        req->WriteReply(HTTP_SERVICE_UNAVAILABLE, "Work queue depth exceeded");
+    }
 
     std::unique_ptr<HTTPRequest> req;
 
@@ -69,62 +79,154 @@ private:
     HTTPRequestHandler func;
 };
 
-/** Simple work queue for distributing work over multiple threads.
- * Work items are simply callable objects.
- */
-template <typename WorkItem>
-class WorkQueue
+/** Work other than handling a request, see QueueHTTPWork. */
+class HTTPFunctionItem final : public HTTPClosure
 {
+public:
+    explicit HTTPFunctionItem(std::function<void()> func) : m_func(std::move(func)) {}
+    void operator()() override { m_func(); }
+
 private:
-    Mutex cs;
-    std::condition_variable cond GUARDED_BY(cs);
-    std::deque<std::unique_ptr<WorkItem>> queue GUARDED_BY(cs);
-    bool running GUARDED_BY(cs){true};
-    const size_t maxDepth;
+    std::function<void()> m_func;
+};
 
-public:
-    explicit WorkQueue(size_t _maxDepth) : maxDepth(_maxDepth)
-    {
+void HTTPWorkQueue::AddToHistogram(std::vector<uint64_t>& histogram, std::chrono::microseconds duration)
+{
+    const auto ms{uint64_t(std::max<int64_t>(Ticks<std::chrono::milliseconds>(duration), 0))};
+    histogram[std::min<size_t>(std::bit_width(ms), histogram.size() - 1)]++;
+}
+
+void HTTPWorkQueue::ForgetIfIdle(std::map<CService, Client>::iterator it)
+{
+    if (it->second.items.empty() && it->second.running == 0) m_clients.erase(it);
+}
+
+HTTPWorkQueue::HTTPWorkQueue(size_t max_depth) : maxDepth(max_depth)
+{
+    m_stats.max_depth = maxDepth;
+    m_stats.queue_time_ms.resize(HTTPWorkQueueStats::HISTOGRAM_BUCKETS);
+    m_stats.exec_time_ms.resize(HTTPWorkQueueStats::HISTOGRAM_BUCKETS);
+}
+
+std::unique_ptr<HTTPClosure> HTTPWorkQueue::Enqueue(std::unique_ptr<HTTPClosure> item, const CService& client, const evhttp_connection* conn, bool make_room)
+{
+    LOCK(cs);
+    if (!running) return item;
+    std::unique_ptr<HTTPClosure> rejected;
+    if (m_depth >= maxDepth) {
+        if (!make_room) return item;
+        const auto busiest{std::ranges::max_element(m_clients, {}, [](const auto& entry) { return entry.second.items.size(); })};
+        const auto own{m_clients.find(client)};
+        const size_t own_queued{own == m_clients.end() ? 0 : own->second.items.size()};
+        if (busiest == m_clients.end() || busiest->second.items.size() <= own_queued + 1) {
+            ++m_stats.rejected;
+            return item;
+        }
+        // Make room by rejecting the newest request of the client with the most queued.
+        rejected = std::move(busiest->second.items.back().work);
+        busiest->second.items.pop_back();
+        --m_depth;
+        ++m_stats.rejected;
     }
-    /** Precondition: worker threads have all stopped (they have been joined).
-     */
-    ~WorkQueue() = default;
-    /** Enqueue a work item */
-    bool Enqueue(WorkItem* item) EXCLUSIVE_LOCKS_REQUIRED(!cs)
-    {
-        LOCK(cs);
-        if (!running || queue.size() >= maxDepth) {
-            return false;
+    auto [it, inserted]{m_clients.try_emplace(client)};
+    if (inserted) {
+        auto least_usage{std::chrono::microseconds::max()};
+        for (const auto& [_, other] : m_clients) {
+            if (&other != &it->second) least_usage = std::min(least_usage, other.usage);
         }
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
-        cond.notify_one();
-        return true;
+        if (least_usage != std::chrono::microseconds::max()) it->second.usage = least_usage;
     }
-    /** Thread function */
-    void Run() EXCLUSIVE_LOCKS_REQUIRED(!cs)
-    {
-        while (true) {
-            std::unique_ptr<WorkItem> i;
-            {
-                WAIT_LOCK(cs, lock);
-                while (running && queue.empty())
-                    cond.wait(lock);
-                if (!running && queue.empty())
-                    break;
-                i = std::move(queue.front());
-                queue.pop_front();
+    it->second.items.push_back(Item{std::move(item), conn, SteadyClock::now()});
+    ++m_depth;
+    cond.notify_one();
+    return rejected;
+}
+
+std::vector<std::unique_ptr<HTTPClosure>> HTTPWorkQueue::Cancel(const evhttp_connection* conn)
+{
+    LOCK(cs);
+    std::vector<std::unique_ptr<HTTPClosure>> cancelled;
+    for (auto it{m_clients.begin()}; it != m_clients.end();) {
+        auto& items{it->second.items};
+        for (auto item{items.begin()}; item != items.end();) {
+            if (item->conn == conn) {
+                cancelled.push_back(std::move(item->work));
+                item = items.erase(item);
+            } else {
+                ++item;
             }
-            (*i)();
         }
+        ForgetIfIdle(it++);
     }
-    /** Interrupt and exit loops */
-    void Interrupt() EXCLUSIVE_LOCKS_REQUIRED(!cs)
-    {
-        LOCK(cs);
-        running = false;
-        cond.notify_all();
+    m_depth -= cancelled.size();
+    m_stats.cancelled += cancelled.size();
+    return cancelled;
+}
+
+void HTTPWorkQueue::Run()
+{
+    while (true) {
+        Item item;
+        CService client;
+        std::chrono::microseconds charged;
+        {
+            WAIT_LOCK(cs, lock);
+            while (running && m_depth == 0)
+                cond.wait(lock);
+            if (!running && m_depth == 0)
+                break;
+            // Serve the client that used the least, and among those the one waiting longest.
+            auto next{m_clients.end()};
+            for (auto it{m_clients.begin()}; it != m_clients.end(); ++it) {
+                if (it->second.items.empty()) continue;
+                if (next == m_clients.end() ||
+                    std::pair{it->second.usage, it->second.items.front().enqueued} < std::pair{next->second.usage, next->second.items.front().enqueued}) {
+                    next = it;
+                }
+            }
+            client = next->first;
+            Client& state{next->second};
+            item = std::move(state.items.front());
+            state.items.pop_front();
+            --m_depth;
+            ++state.running;
+            charged = state.avg_cost;
+            state.usage += charged;
+            AddToHistogram(m_stats.queue_time_ms, std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - item.enqueued));
+        }
+        const auto start{SteadyClock::now()};
+        (*item.work)();
+        item.work.reset();
+        const auto cost{std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - start)};
+        {
+            LOCK(cs);
+            AddToHistogram(m_stats.exec_time_ms, cost);
+            auto it{m_clients.find(client)};
+            if (it == m_clients.end()) continue;
+            Client& state{it->second};
+            state.usage += cost - charged;
+            state.avg_cost += (cost - state.avg_cost) / 8;
+            --state.running;
+            ForgetIfIdle(it);
+        }
     }
-};
+}
+
+void HTTPWorkQueue::Interrupt()
+{
+    LOCK(cs);
+    running = false;
+    cond.notify_all();
+}
+
+HTTPWorkQueueStats HTTPWorkQueue::GetStats()
+{
+    LOCK(cs);
+    HTTPWorkQueueStats stats{m_stats};
+    stats.depth = m_depth;
+    stats.clients = m_clients.size();
+    return stats;
+}
 
 struct HTTPPathHandler
 {
@@ -146,7 +248,7 @@ static struct evhttp* eventHTTP = nullptr;
 //! List of subnets to allow RPC connections from
 static std::vector<CSubNet> rpc_allow_subnets;
 //! Work queue for handling longer requests off the event loop thread
-static std::unique_ptr<WorkQueue<HTTPClosure>> g_work_queue{nullptr};
+static std::unique_ptr<HTTPWorkQueue> g_work_queue{nullptr};
 //! Handlers for (sub)paths
 static GlobalMutex g_httppathhandlers_mutex;
 static std::vector<HTTPPathHandler> pathHandlers GUARDED_BY(g_httppathhandlers_mutex);
@@ -272,6 +374,12 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
         }, nullptr);
         evhttp_connection_set_closecb(conn, [](evhttp_connection* conn, void* arg) {
             g_requests.RemoveConnection(conn);
+            // Drop the requests that were still waiting, libevent keeps them around until they get a reply.
+            if (g_work_queue) {
+                for (const auto& item : g_work_queue->Cancel(conn)) {
+                    item->Reject();
+                }
+            }
         }, nullptr);
     }
 
@@ -327,13 +435,12 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
 
     // Dispatch to worker thread
     if (i != iend) {
-        std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
+        const CService client{hreq->GetPeer()};
+        auto item{std::make_unique<HTTPWorkItem>(std::move(hreq), path, i->handler)};
         assert(g_work_queue);
-        if (g_work_queue->Enqueue(item.get())) {
-            item.release(); /* if true, queue took ownership */
-        } else {
+        if (const auto rejected{g_work_queue->Enqueue(std::move(item), client, conn)}) {
             LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
-            item->req->WriteReply(HTTP_SERVICE_UNAVAILABLE, "Work queue depth exceeded");
+            rejected->Reject();
         }
     } else {
         hreq->WriteReply(HTTP_NOT_FOUND);
@@ -413,7 +520,7 @@ static bool HTTPBindAddresses(struct evhttp* http)
 }
 
 /** Simple wrapper to set thread name and run work queue */
-static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue, int worker_num)
+static void HTTPWorkQueueRun(HTTPWorkQueue* queue, int worker_num)
 {
     util::ThreadRename(strprintf("httpworker.%i", worker_num));
     queue->Run();
@@ -480,7 +587,7 @@ bool InitHTTPServer(const util::SignalInterrupt& interrupt)
     int workQueueDepth = std::max((long)gArgs.GetIntArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
     LogDebug(BCLog::HTTP, "creating work queue of depth %d\n", workQueueDepth);
 
-    g_work_queue = std::make_unique<WorkQueue<HTTPClosure>>(workQueueDepth);
+    g_work_queue = std::make_unique<HTTPWorkQueue>(workQueueDepth);
     // transfer ownership to eventBase/HTTP via .release()
     eventBase = base_ctr.release();
     eventHTTP = http_ctr.release();
@@ -567,6 +674,19 @@ struct event_base* EventBase()
     return eventBase;
 }
 
+bool QueueHTTPWork(const HTTPRequest& req, std::function<void()> func)
+{
+    if (!g_work_queue) return false;
+    // Unlike requests, this work is not worth rejecting other work for.
+    return !g_work_queue->Enqueue(std::make_unique<HTTPFunctionItem>(std::move(func)), req.GetPeer(), /*conn=*/nullptr, /*make_room=*/false);
+}
+
+std::optional<HTTPWorkQueueStats> GetHTTPWorkQueueStats()
+{
+    if (!g_work_queue) return std::nullopt;
+    return g_work_queue->GetStats();
+}
+
 static void httpevent_callback_fn(evutil_socket_t, short, void* data)
 {
     // Static handler: simply call inner handler
@@ -598,9 +718,52 @@ HTTPRequest::HTTPRequest(struct evhttp_request* _req, const util::SignalInterrup
 {
 }
 
+/** State of a chunked reply, shared between the worker thread writing it and the main thread sending it. */
+struct HTTPRequest::ChunkedReply {
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    //! Bytes passed to WriteReplyChunk that have not been sent to the client yet.
+    size_t m_pending GUARDED_BY(m_mutex){0};
+    //! Bytes handed to libevent since its write callback last fired. Only used by the main thread.
+    size_t m_in_connection{0};
+    bool m_closed GUARDED_BY(m_mutex){false};
+
+    void Close() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_closed = true);
+        m_cv.notify_all();
+    }
+
+    //! Called by libevent once the connection's output buffer was written out.
+    static void OnWritten(evhttp_connection*, void* arg)
+    {
+        auto& self{*static_cast<ChunkedReply*>(arg)};
+        {
+            LOCK(self.m_mutex);
+            self.m_pending -= std::min(self.m_pending, self.m_in_connection);
+        }
+        self.m_in_connection = 0;
+        self.m_cv.notify_all();
+    }
+};
+
+/** Re-enable reading from the socket. This is the second part of the libevent workaround in http_request_cb. */
+static void ResumeReading(evhttp_connection* conn)
+{
+    if (conn && event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
+        bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+        if (bev) {
+            bufferevent_enable(bev, EV_READ | EV_WRITE);
+        }
+    }
+}
+
 HTTPRequest::~HTTPRequest()
 {
-    if (!replySent) {
+    if (m_chunked && !replySent) {
+        LogPrintf("%s: Unfinished chunked reply\n", __func__);
+        AbortChunkedReply();
+    } else if (!replySent) {
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
         WriteReply(HTTP_INTERNAL_SERVER_ERROR, "Unhandled request");
@@ -608,6 +771,14 @@ HTTPRequest::~HTTPRequest()
     // evhttpd cleans up the request, as long as a reply was sent.
 }
 
+std::unique_ptr<HTTPRequest> HTTPRequest::Detach()
+{
+    assert(!replySent && !m_chunked);
+    // The new object sends the reply instead.
+    replySent = true;
+    return std::make_unique<HTTPRequest>(req, m_interrupt);
+}
+
 std::pair<bool, std::string> HTTPRequest::GetHeader(const std::string& hdr) const
 {
     const struct evkeyvalq* headers = evhttp_request_get_input_headers(req);
@@ -654,26 +825,169 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 void HTTPRequest::WriteReply(int nStatus, std::span<const std::byte> reply)
 {
     assert(!replySent && req);
+    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    evbuffer_add(evb, reply.data(), reply.size());
+    SendReply(nStatus);
+}
+
+template <typename Body>
+void HTTPRequest::WriteOwnedReply(int nStatus, Body&& reply)
+{
+    assert(!replySent && req);
+    if (reply.empty()) return WriteReply(nStatus, std::string_view{});
+    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    // The buffer refers to the body until it was sent, and then frees it on
+    // the main http thread.
+    auto body{std::make_unique<Body>(std::move(reply))};
+    if (evbuffer_add_reference(evb, body->data(), body->size(), [](const void*, size_t, void* arg) { delete static_cast<Body*>(arg); }, body.get()) == 0) {
+        body.release();
+    } else {
+        evbuffer_add(evb, body->data(), body->size());
+    }
+    SendReply(nStatus);
+}
+
+void HTTPRequest::WriteReply(int nStatus, std::string&& reply)
+{
+    WriteOwnedReply(nStatus, std::move(reply));
+}
+
+void HTTPRequest::WriteReply(int nStatus, std::vector<std::byte>&& reply)
+{
+    WriteOwnedReply(nStatus, std::move(reply));
+}
+
+void HTTPRequest::SendReply(int nStatus)
+{
     if (m_interrupt) {
         WriteHeader("Connection", "close");
     }
     // Send event to main http thread to send reply message
-    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
-    assert(evb);
-    evbuffer_add(evb, reply.data(), reply.size());
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
-            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
-            }
+        ResumeReading(evhttp_request_get_connection(req_copy));
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
+void HTTPRequest::StartChunkedReply(int nStatus)
+{
+    assert(!replySent && req && !m_chunked);
+    if (m_interrupt) {
+        WriteHeader("Connection", "close");
+    }
+    m_chunked = std::make_shared<ChunkedReply>();
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus] {
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+    });
+    ev->trigger(nullptr);
+}
+
+void HTTPRequest::SendReplyChunk(std::span<const std::byte> chunk)
+{
+    if (chunk.empty()) return;
+
+    struct evbuffer* buf = evbuffer_new();
+    assert(buf);
+    evbuffer_add(buf, chunk.data(), chunk.size());
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, buf, state = m_chunked, size = chunk.size()] {
+        if (!evhttp_request_get_connection(req_copy)) {
+            // The connection was closed; libevent keeps the request around until the reply is ended.
+            state->Close();
+        } else {
+            state->m_in_connection += size;
+            evhttp_send_reply_chunk_with_cb(req_copy, buf, ChunkedReply::OnWritten, state.get());
+        }
+        evbuffer_free(buf);
+    });
+    ev->trigger(nullptr);
+}
+
+void HTTPRequest::ProbeConnection()
+{
+    auto req_copy = req;
+    HTTPEvent* probe = new HTTPEvent(eventBase, true, [req_copy, state = m_chunked] {
+        if (!evhttp_request_get_connection(req_copy)) state->Close();
+    });
+    probe->trigger(nullptr);
+}
+
+bool HTTPRequest::WriteReplyChunk(std::span<const std::byte> chunk)
+{
+    assert(!replySent && req && m_chunked);
+    ChunkedReply& state{*m_chunked};
+    {
+        LOCK(state.m_mutex);
+        if (state.m_closed) return false;
+        state.m_pending += chunk.size();
+    }
+    SendReplyChunk(chunk);
+
+    // Wait for the client to catch up. A connection that goes away does not call
+    // back, so check on it every now and then.
+    WAIT_LOCK(state.m_mutex, lock);
+    while (!state.m_closed && state.m_pending > MAX_CHUNKED_REPLY_PENDING) {
+        if (state.m_cv.wait_for(lock, std::chrono::seconds{1}) == std::cv_status::timeout) {
+            if (m_interrupt) return false;
+            ProbeConnection();
+        }
+    }
+    return !state.m_closed;
+}
+
+HTTPRequest::ChunkResult HTTPRequest::TryWriteReplyChunk(std::span<const std::byte> chunk, size_t max_pending)
+{
+    assert(!replySent && req && m_chunked);
+    ChunkedReply& state{*m_chunked};
+    bool full;
+    {
+        LOCK(state.m_mutex);
+        if (state.m_closed || m_interrupt) return ChunkResult::CLOSED;
+        full = state.m_pending + chunk.size() > max_pending;
+        if (!full) state.m_pending += chunk.size();
+    }
+    if (full) {
+        // The client may be slow, or gone without telling.
+        ProbeConnection();
+        return ChunkResult::FULL;
+    }
+    SendReplyChunk(chunk);
+    return ChunkResult::SENT;
+}
+
+void HTTPRequest::EndChunkedReply()
+{
+    assert(!replySent && req && m_chunked);
+    auto req_copy = req;
+    // Keep the state alive until libevent no longer calls back into it.
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, state = m_chunked] {
+        evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+        evhttp_send_reply_end(req_copy);
+        ResumeReading(conn);
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
+void HTTPRequest::AbortChunkedReply()
+{
+    assert(!replySent && req && m_chunked);
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, state = m_chunked] {
+        if (evhttp_connection* conn = evhttp_request_get_connection(req_copy)) {
+            // Frees the request too, without sending the last chunk.
+            evhttp_connection_free(conn);
+        } else {
+            // The client is gone already, so this only frees the request.
+            evhttp_send_reply_end(req_copy);
         }
     });
     ev->trigger(nullptr);
@@ -5,10 +5,23 @@
 #ifndef BITCOIN_HTTPSERVER_H
 #define BITCOIN_HTTPSERVER_H
 
+#include <netaddress.h>
+#include <sync.h>
+#include <util/time.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <map>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace util {
 class SignalInterrupt;
@@ -27,9 +40,15 @@ static const int DEFAULT_HTTP_WORKQUEUE=64;
 
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
 
+/**
+ * Amount of a chunked reply that may be waiting to be sent to the client before
+ * WriteReplyChunk blocks.
+ */
+static constexpr size_t MAX_CHUNKED_REPLY_PENDING{1 << 20};
+
+struct evhttp_connection;
 struct evhttp_request;
 struct event_base;
-class CService;
 class HTTPRequest;
 
 /** Initialize HTTP server.
@@ -49,6 +68,30 @@ void StopHTTPServer();
 /** Change logging level for libevent. */
 void UpdateHTTPServerLogging(bool enable);
 
+/** Statistics of the queue of requests waiting for a worker thread. */
+struct HTTPWorkQueueStats {
+    //! Number of buckets of the histograms. Bucket 0 counts durations under
+    //! 1 ms, bucket i durations from 2^(i-1) ms to under 2^i ms, and the last
+    //! bucket all longer ones.
+    static constexpr size_t HISTOGRAM_BUCKETS{16};
+
+    size_t depth{0};
+    size_t max_depth{0};
+    //! Number of clients with requests queued or being worked on.
+    size_t clients{0};
+    //! Requests rejected because the queue was full.
+    uint64_t rejected{0};
+    //! Requests dropped because their client disconnected while they were queued.
+    uint64_t cancelled{0};
+    //! Time requests spent in the queue.
+    std::vector<uint64_t> queue_time_ms;
+    //! Time requests took to be handled.
+    std::vector<uint64_t> exec_time_ms;
+};
+
+/** Get statistics of the work queue, or std::nullopt if the HTTP server is not running. */
+std::optional<HTTPWorkQueueStats> GetHTTPWorkQueueStats();
+
 /** Handler for requests to a certain HTTP path */
 typedef std::function<bool(HTTPRequest* req, const std::string &)> HTTPRequestHandler;
 /** Register handler for prefix.
@@ -74,6 +117,19 @@ private:
     const util::SignalInterrupt& m_interrupt;
     bool replySent;
 
+    struct ChunkedReply;
+    //! Set once a chunked reply was started.
+    std::shared_ptr<ChunkedReply> m_chunked;
+
+    //! Send the reply whose body was added to the output buffer.
+    void SendReply(int nStatus);
+    //! Hand a part of a chunked reply, already counted as pending, to the main thread.
+    void SendReplyChunk(std::span<const std::byte> chunk);
+    //! Have the main thread check whether the client of a chunked reply went away.
+    void ProbeConnection();
+    template <typename Body>
+    void WriteOwnedReply(int nStatus, Body&& reply);
+
 public:
     explicit HTTPRequest(struct evhttp_request* req, const util::SignalInterrupt& interrupt, bool replySent = false);
     ~HTTPRequest();
@@ -142,7 +198,68 @@ public:
     {
         WriteReply(nStatus, std::as_bytes(std::span{reply}));
     }
+    void WriteReply(int nStatus, const char* reply) { WriteReply(nStatus, std::string_view{reply}); }
     void WriteReply(int nStatus, std::span<const std::byte> reply);
+    //! Take over the body instead of copying it, for large replies.
+    void WriteReply(int nStatus, std::string&& reply);
+    void WriteReply(int nStatus, std::vector<std::byte>&& reply);
+
+    /**
+     * Start a reply whose body is sent in parts with WriteReplyChunk (using
+     * chunked transfer encoding), for replies too large to hold in memory at once.
+     *
+     * @note Call this instead of WriteReply, after the headers were written.
+     * Finish the reply with EndChunkedReply.
+     */
+    void StartChunkedReply(int nStatus);
+
+    /**
+     * Send a part of the body of a chunked reply. Blocks while more than
+     * MAX_CHUNKED_REPLY_PENDING bytes of the reply are waiting to be sent.
+     *
+     * @returns false if the client went away or the server is shutting down,
+     * in which case the rest of the reply can be skipped.
+     */
+    bool WriteReplyChunk(std::span<const std::byte> chunk);
+    bool WriteReplyChunk(std::string_view chunk) { return WriteReplyChunk(std::as_bytes(std::span{chunk})); }
+
+    enum class ChunkResult {
+        SENT,
+        //! Not sent, because too much of the reply is waiting to be sent.
+        FULL,
+        //! Not sent, because the client went away or the server is shutting down.
+        CLOSED,
+    };
+
+    /**
+     * Like WriteReplyChunk, but never blocks: the chunk is only sent if no more
+     * than `max_pending` bytes of the reply, including it, would be waiting
+     * to be sent. For replies written from threads that must not wait for a
+     * client, such as event streams.
+     */
+    ChunkResult TryWriteReplyChunk(std::span<const std::byte> chunk, size_t max_pending);
+    ChunkResult TryWriteReplyChunk(std::string_view chunk, size_t max_pending) { return TryWriteReplyChunk(std::as_bytes(std::span{chunk}), max_pending); }
+
+    /**
+     * Finish a chunked reply. Like WriteReply, this gives the request back to
+     * the main thread.
+     */
+    void EndChunkedReply();
+
+    /**
+     * Abort a chunked reply by closing the connection without finishing the
+     * body, so that the client can tell that it did not get all of it. Like
+     * EndChunkedReply, this gives the request back to the main thread.
+     */
+    void AbortChunkedReply();
+
+    bool IsChunkedReplyStarted() const { return m_chunked != nullptr; }
+
+    /**
+     * Take over the request to reply to it after its handler returned, from
+     * any thread. The handler must not use this object afterwards.
+     */
+    std::unique_ptr<HTTPRequest> Detach();
 };
 
 /** Get the query parameter value from request uri for a specified key, or std::nullopt if the key
@@ -165,9 +282,89 @@ class HTTPClosure
 {
 public:
     virtual void operator()() = 0;
+    //! Called instead of operator() if the work is dropped from the queue.
+    virtual void Reject() {}
     virtual ~HTTPClosure() = default;
 };
 
+/**
+ * Queue of work items for the HTTP worker threads, shared fairly between clients.
+ *
+ * Every client (connection, told apart by remote address and port, so that
+ * local callers and those behind a proxy are not one client) has its own FIFO
+ * queue. Workers take the next item from the client that used the least worker
+ * time so far, so a client sending slow requests (e.g. scantxoutset) does not
+ * hold up the quick requests of others. What a request costs is not known until
+ * it ran, so a client is charged its average cost when a request starts, and
+ * the difference once it finished. Clients that become active start at the
+ * usage of the least active client rather than with credit saved up while idle.
+ *
+ * When the queue is full, a request of the client with the most queued
+ * requests is rejected, so a client flooding the server cannot lock others out.
+ * Requests whose connection was closed while they were waiting are dropped.
+ */
+class HTTPWorkQueue
+{
+private:
+    struct Item {
+        std::unique_ptr<HTTPClosure> work;
+        //! Only used to find the items of a connection that was closed.
+        const evhttp_connection* conn{nullptr};
+        SteadyClock::time_point enqueued;
+    };
+    struct Client {
+        std::deque<Item> items;
+        //! Worker time charged to the client.
+        std::chrono::microseconds usage{0};
+        //! Moving average of the worker time of the client's requests.
+        std::chrono::microseconds avg_cost{std::chrono::milliseconds{1}};
+        //! Number of the client's requests being worked on.
+        size_t running{0};
+    };
+
+    Mutex cs;
+    std::condition_variable cond GUARDED_BY(cs);
+    std::map<CService, Client> m_clients GUARDED_BY(cs);
+    size_t m_depth GUARDED_BY(cs){0};
+    bool running GUARDED_BY(cs){true};
+    const size_t maxDepth;
+    HTTPWorkQueueStats m_stats GUARDED_BY(cs);
+
+    static void AddToHistogram(std::vector<uint64_t>& histogram, std::chrono::microseconds duration);
+
+    //! Remove a client that has nothing queued or running, so that it starts afresh when it returns.
+    void ForgetIfIdle(std::map<CService, Client>::iterator it) EXCLUSIVE_LOCKS_REQUIRED(cs);
+
+public:
+    explicit HTTPWorkQueue(size_t max_depth);
+    /** Precondition: worker threads have all stopped (they have been joined).
+     */
+    ~HTTPWorkQueue() = default;
+    /**
+     * Enqueue a work item of a client.
+     *
+     * @returns the item to be rejected because the queue is full or shutting
+     * down: the new one or one of another client's. nullptr if none.
+     */
+    std::unique_ptr<HTTPClosure> Enqueue(std::unique_ptr<HTTPClosure> item, const CService& client, const evhttp_connection* conn, bool make_room = true) EXCLUSIVE_LOCKS_REQUIRED(!cs);
+    /** Remove the items of a closed connection, which are returned to be disposed of. */
+    std::vector<std::unique_ptr<HTTPClosure>> Cancel(const evhttp_connection* conn) EXCLUSIVE_LOCKS_REQUIRED(!cs);
+    /** Thread function */
+    void Run() EXCLUSIVE_LOCKS_REQUIRED(!cs);
+    /** Interrupt and exit loops */
+    void Interrupt() EXCLUSIVE_LOCKS_REQUIRED(!cs);
+    HTTPWorkQueueStats GetStats() EXCLUSIVE_LOCKS_REQUIRED(!cs);
+};
+
+/**
+ * Run `func` on an HTTP worker thread, queued on behalf of the client of `req`
+ * like its requests are.
+ *
+ * @returns false if the work queue is full or shutting down, in which case
+ * `func` is not run.
+ */
+bool QueueHTTPWork(const HTTPRequest& req, std::function<void()> func);
+
 /** Event class. This can be used either as a cross-thread trigger or as a timer.
  */
 class HTTPEvent
@@ -5,6 +5,7 @@
 #include <chainparams.h>
 #include <common/args.h>
 #include <index/base.h>
+#include <index/readahead.h>
 #include <interfaces/chain.h>
 #include <kernel/chain.h>
 #include <logging.h>
@@ -32,6 +33,8 @@ constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+//! How long to wait at a time for slower indexes sharing the read-ahead source.
+constexpr auto SYNC_READ_AHEAD_WAIT{100ms};
 
 template <typename... Args>
 void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
@@ -149,7 +152,8 @@ static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindex_prev, CChain&
     return chain.Next(chain.FindFork(pindex_prev));
 }
 
-bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data)
+bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data,
+                             const CBlockUndo* undo_data, std::any* prepared)
 {
     interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, block_data);
 
@@ -165,15 +169,21 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
 
     CBlockUndo block_undo;
     if (CustomOptions().connect_undo_data) {
-        if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(block_undo, *pindex)) {
-            FatalErrorf("%s: Failed to read undo block data %s from disk",
-                        __func__, pindex->GetBlockHash().ToString());
-            return false;
+        if (undo_data) {
+            block_info.undo_data = undo_data;
+        } else {
+            if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(block_undo, *pindex)) {
+                FatalErrorf("%s: Failed to read undo block data %s from disk",
+                            __func__, pindex->GetBlockHash().ToString());
+                return false;
+            }
+            block_info.undo_data = &block_undo;
         }
-        block_info.undo_data = &block_undo;
     }
 
-    if (!CustomAppend(block_info)) {
+    const bool ok{prepared && prepared->has_value() ? CustomAppendPrepared(block_info, std::move(*prepared))
+                                                    : CustomAppend(block_info)};
+    if (!ok) {
         FatalErrorf("%s: Failed to write block %s to index database",
                     __func__, pindex->GetBlockHash().ToString());
         return false;
@@ -185,9 +195,19 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
 void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
+    // The read-ahead source is only needed until this index is synced.
+    const std::shared_ptr<BlockReadAhead> source{std::move(m_read_ahead)};
     if (!m_synced) {
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
+
+        // Optionally read (and prepare) upcoming blocks on worker threads, so
+        // that the sync thread only has to write them to the index.
+        std::unique_ptr<BlockReadAhead::Subscription> read_ahead;
+        if (source) {
+            read_ahead = source->Subscribe(CustomOptions().connect_undo_data,
+                                           [this](const interfaces::BlockInfo& block) { return CustomPrepare(block); });
+        }
         while (true) {
             if (m_interrupt) {
                 LogPrintf("%s: m_interrupt set; exiting ThreadSync\n", GetName());
@@ -226,8 +246,36 @@ void BaseIndex::Sync()
             }
             pindex = pindex_next;
 
+            if (read_ahead) {
+                // Blocks queued before a reorg are of no use any more.
+                if (read_ahead->Front() != pindex) read_ahead->Clear();
+                // Stay close to slower indexes, so that blocks are read once
+                // for all of them.
+                while (read_ahead->Size() == 0 && !read_ahead->Push(pindex) && !m_interrupt) {
+                    read_ahead->WaitForOthers(SYNC_READ_AHEAD_WAIT);
+                }
+                {
+                    LOCK(::cs_main);
+                    const CChain& chain{m_chainstate->m_chain};
+                    if (chain.Contains(pindex)) {
+                        const CBlockIndex* last{read_ahead->Back()};
+                        for (const CBlockIndex* next{last ? chain.Next(last) : pindex}; next; next = chain.Next(next)) {
+                            if (!read_ahead->Push(next)) break;
+                        }
+                    }
+                }
+            }
 
-            if (!ProcessBlock(pindex)) return; // error logged internally
+            if (read_ahead && read_ahead->Front() == pindex) {
+                BlockReadAhead::Entry entry{read_ahead->Pop()};
+                // If reading failed, read again here so that the error is reported as usual.
+                if (!(entry.ok ? ProcessBlock(pindex, entry.block.get(), entry.undo.get(), &entry.prepared)
+                               : ProcessBlock(pindex))) {
+                    return; // error logged internally
+                }
+            } else if (!ProcessBlock(pindex)) {
+                return; // error logged internally
+            }
 
             auto current_time{std::chrono::steady_clock::now()};
             if (last_log_time + SYNC_LOG_INTERVAL < current_time) {
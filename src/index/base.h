@@ -12,16 +12,25 @@
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <any>
+#include <memory>
 #include <string>
 
+class BlockReadAhead;
 class CBlock;
 class CBlockIndex;
+class CBlockUndo;
 class Chainstate;
 class ChainstateManager;
 namespace interfaces {
 class Chain;
 } // namespace interfaces
 
+/** Default for -indexsyncthreads: number of threads reading blocks ahead of the indexes' initial sync */
+static constexpr int DEFAULT_INDEX_SYNC_THREADS{0};
+/** Maximum for -indexsyncthreads */
+static constexpr int MAX_INDEX_SYNC_THREADS{16};
+
 struct IndexSummary {
     std::string name;
     bool synced{false};
@@ -80,6 +89,10 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Source of blocks for the initial sync, possibly shared with other
+    /// indexes. If null, blocks are read on the sync thread itself.
+    std::shared_ptr<BlockReadAhead> m_read_ahead;
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     ///
     /// Recommendations for error handling:
@@ -93,7 +106,8 @@ private:
     /// Loop over disconnected blocks and call CustomRemove.
     bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip);
 
-    bool ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data = nullptr);
+    bool ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data = nullptr,
+                      const CBlockUndo* undo_data = nullptr, std::any* prepared = nullptr);
 
     virtual bool AllowPrune() const = 0;
 
@@ -118,6 +132,16 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Compute data for CustomAppendPrepared from a block, on a read-ahead
+    /// thread during the initial sync. Runs concurrently with appends of
+    /// earlier blocks, so it may only use the block itself, not index state.
+    /// Returning an empty value makes the block go through CustomAppend.
+    [[nodiscard]] virtual std::any CustomPrepare(const interfaces::BlockInfo& block) const { return {}; }
+
+    /// Write update index entries for a newly connected block, given the
+    /// result of CustomPrepare for it.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) { return CustomAppend(block); }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -151,6 +175,11 @@ public:
     /// validation interface so that it stays in sync with blockchain updates.
     [[nodiscard]] bool Init();
 
+    /// Sets the source reading blocks ahead of the initial sync, which may be
+    /// shared with other indexes. Must be called before the sync starts; the
+    /// index lets go of it once synced.
+    void SetReadAhead(std::shared_ptr<BlockReadAhead> read_ahead) { m_read_ahead = std::move(read_ahead); }
+
     /// Starts the initial sync process on a background thread.
     [[nodiscard]] bool StartBackgroundSync();
 
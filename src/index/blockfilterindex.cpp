@@ -6,11 +6,13 @@
 
 #include <clientversion.h>
 #include <common/args.h>
+#include <crypto/common.h>
 #include <dbwrapper.h>
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <logging.h>
 #include <node/blockstorage.h>
+#include <streams.h>
 #include <undo.h>
 #include <util/fs_helpers.h>
 
@@ -28,6 +30,13 @@
  * Keys for the height index have the type [DB_BLOCK_HEIGHT, uint32 (BE)]. The height is represented
  * as big-endian so that sequential reads of filters by height are fast.
  * Keys for the hash index have the type [DB_BLOCK_HASH, uint256].
+ *
+ * The height index is mirrored in heights.dat, which has a fixed-size record per height so that it
+ * can be read through a memory mapping, together with the filter files, when serving filters. Each
+ * record holds the block hash, the DB value with the position in fixed-size form, and a checksum.
+ * Records are not erased when blocks are disconnected: since filters and headers only depend on the
+ * block chain, a record is valid for a block as long as its block hash and checksum match. Anything
+ * else, including a filter position that turns out to be stale, falls back to the database.
  */
 constexpr uint8_t DB_BLOCK_HASH{'s'};
 constexpr uint8_t DB_BLOCK_HEIGHT{'t'};
@@ -92,6 +101,60 @@ struct DBHashKey {
     }
 };
 
+uint64_t HeightRecordChecksum(std::span<const std::byte> record)
+{
+    return ReadLE64(Hash(record.first(HEIGHT_RECORD_SIZE - 8)).begin());
+}
+
+/** Write the height record of a block. Throws std::ios_base::failure on failure. */
+void WriteHeightRecord(AutoFile& file, int height, const uint256& block_hash, const DBVal& value)
+{
+    DataStream record;
+    record << block_hash << value.hash << value.header;
+    ser_writedata32(record, value.pos.nFile);
+    ser_writedata32(record, value.pos.nPos);
+    ser_writedata64(record, HeightRecordChecksum(record));
+
+    file.seek(int64_t{height} * HEIGHT_RECORD_SIZE, SEEK_SET);
+    file << std::span{record};
+}
+
+/** Read the height record of a block. */
+std::optional<DBVal> ReadHeightRecord(const MappedFile& map, const CBlockIndex& block_index)
+{
+    const size_t end{(static_cast<size_t>(block_index.nHeight) + 1) * HEIGHT_RECORD_SIZE};
+    if (map.Data().size() < end) return std::nullopt;
+
+    const std::span<const std::byte> record{map.Data().subspan(end - HEIGHT_RECORD_SIZE, HEIGHT_RECORD_SIZE)};
+    if (ReadLE64(UCharCast(record.data()) + HEIGHT_RECORD_SIZE - 8) != HeightRecordChecksum(record)) {
+        return std::nullopt;
+    }
+    SpanReader reader{record};
+    uint256 block_hash;
+    DBVal value;
+    reader >> block_hash >> value.hash >> value.header;
+    if (block_hash != block_index.GetBlockHash()) return std::nullopt;
+    value.pos.nFile = ser_readdata32(reader);
+    value.pos.nPos = ser_readdata32(reader);
+    return value;
+}
+
+/** Read the height records of a range of blocks. Returns false if any of them is unavailable. */
+bool ReadHeightRecordRange(const MappedFile& map, int start_height, const CBlockIndex* stop_index,
+                           std::vector<DBVal>& results)
+{
+    if (start_height < 0 || start_height > stop_index->nHeight) return false;
+    results.resize(static_cast<size_t>(stop_index->nHeight - start_height + 1));
+    for (const CBlockIndex* block_index = stop_index;
+         block_index && block_index->nHeight >= start_height;
+         block_index = block_index->pprev) {
+        auto value{ReadHeightRecord(map, *block_index)};
+        if (!value) return false;
+        results[block_index->nHeight - start_height] = std::move(*value);
+    }
+    return true;
+}
+
 }; // namespace
 
 static std::map<BlockFilterType, BlockFilterIndex> g_filter_indexes;
@@ -108,6 +171,14 @@ BlockFilterIndex::BlockFilterIndex(std::unique_ptr<interfaces::Chain> chain, Blo
     fs::create_directories(path);
 
     m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+    m_heights_path = path / "heights.dat";
+    if (f_wipe) fs::remove(m_heights_path);
+    FILE* heights_file{fsbridge::fopen(m_heights_path, "rb+")};
+    if (!heights_file) heights_file = fsbridge::fopen(m_heights_path, "wb+");
+    // Unbuffered, so that a record is visible through the memory mapping as soon as it is written.
+    if (heights_file) std::setvbuf(heights_file, nullptr, _IONBF, 0);
+    m_heights_file = std::make_unique<AutoFile>(heights_file);
+    if (!heights_file) DisableHeightRecords(strprintf("Failed to open %s", fs::PathToString(m_heights_path)));
     m_filter_fileseq = std::make_unique<FlatFileSeq>(std::move(path), "fltr", FLTR_FILE_CHUNK_SIZE);
 }
 
@@ -192,6 +263,62 @@ bool BlockFilterIndex::ReadFilterFromDisk(const FlatFilePos& pos, const uint256&
     return true;
 }
 
+void BlockFilterIndex::DisableHeightRecords(const std::string& reason) const
+{
+    if (!m_heights_disabled.exchange(true)) {
+        LogWarning("%s, serving %s from the database only until restarted\n", reason, GetName());
+    }
+}
+
+template <typename Fn>
+bool BlockFilterIndex::ReadMapped(Fn read) const
+{
+    if (m_heights_disabled) return false;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mapped_mutex);
+        if (read(/*remap=*/false)) return true;
+    }
+    // Mostly a file grew since it was mapped, so map it again.
+    std::unique_lock<std::shared_mutex> lock(m_mapped_mutex);
+    return read(/*remap=*/true);
+}
+
+void BlockFilterIndex::MapHeightRecords(int height) const
+{
+    if (m_heights_map.Data().size() < (static_cast<size_t>(height) + 1) * HEIGHT_RECORD_SIZE &&
+        !m_heights_map.Open(m_heights_path)) {
+        DisableHeightRecords(strprintf("Failed to map %s", fs::PathToString(m_heights_path)));
+    }
+}
+
+bool BlockFilterIndex::ReadFilterMapped(const FlatFilePos& pos, const uint256& hash, BlockFilter& filter, bool remap) const
+{
+    const auto read_filter{[&](const MappedFile& map) {
+        const std::span<const std::byte> data{map.Data()};
+        if (pos.nPos >= data.size()) return false;
+        try {
+            SpanReader reader{data.subspan(pos.nPos)};
+            uint256 block_hash;
+            std::vector<uint8_t> encoded_filter;
+            reader >> block_hash >> encoded_filter;
+            if (Hash(encoded_filter) != hash) return false;
+            filter = BlockFilter(GetFilterType(), block_hash, std::move(encoded_filter), /*skip_decode_check=*/true);
+            return true;
+        } catch (const std::ios_base::failure&) {
+            return false;
+        }
+    }};
+
+    if (!remap) {
+        const auto it{m_filter_maps.find(pos.nFile)};
+        return it != m_filter_maps.end() && read_filter(it->second);
+    }
+    // Map the file on first use, and again if the filter lies beyond the end of the mapping
+    // because the file grew since.
+    MappedFile& map{m_filter_maps[pos.nFile]};
+    return read_filter(map) || (map.Open(m_filter_fileseq->FileName(pos)) && read_filter(map));
+}
+
 size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos& pos, const BlockFilter& filter)
 {
     assert(filter.GetFilterType() == GetFilterType());
@@ -207,6 +334,9 @@ size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos& pos, const BlockFilter&
             LogPrintf("%s: Failed to open filter file %d\n", __func__, pos.nFile);
             return 0;
         }
+        // Reading a mapping beyond the end of the truncated file would crash, so drop it first.
+        std::unique_lock<std::shared_mutex> lock(m_mapped_mutex);
+        m_filter_maps.erase(pos.nFile);
         if (!last_file.Truncate(pos.nPos)) {
             LogPrintf("%s: Failed to truncate filter file %d\n", __func__, pos.nFile);
             return 0;
@@ -257,8 +387,25 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
 bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
 {
     BlockFilter filter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+    return AppendFilter(filter, block.height);
+}
+
+std::any BlockFilterIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    // Building the filter only depends on the block and its undo data, so it
+    // can happen on a read-ahead thread. Chaining the header cannot.
+    return BlockFilter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+}
+
+bool BlockFilterIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    return AppendFilter(std::any_cast<const BlockFilter&>(prepared), block.height);
+}
+
+bool BlockFilterIndex::AppendFilter(const BlockFilter& filter, uint32_t block_height)
+{
     const uint256& header = filter.ComputeHeader(m_last_header);
-    bool res = Write(filter, block.height, header);
+    bool res = Write(filter, block_height, header);
     if (res) m_last_header = header; // update last header
     return res;
 }
@@ -277,6 +424,14 @@ bool BlockFilterIndex::Write(const BlockFilter& filter, uint32_t block_height, c
     if (!m_db->Write(DBHeightKey(block_height), value)) {
         return false;
     }
+    if (!m_heights_disabled) {
+        try {
+            WriteHeightRecord(*m_heights_file, block_height, value.first, value.second);
+        } catch (const std::ios_base::failure& e) {
+            // Lookups fall back to the database when a record is missing.
+            DisableHeightRecords(strprintf("Failed to write block filter height record %d: %s", block_height, e.what()));
+        }
+    }
 
     m_next_filter_pos.nPos += bytes_written;
     return true;
@@ -407,6 +562,14 @@ static bool LookupRange(CDBWrapper& db, const std::string& index_name, int start
 
 bool BlockFilterIndex::LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const
 {
+    if (ReadMapped([&](bool remap) {
+            if (remap) MapHeightRecords(block_index->nHeight);
+            auto entry{ReadHeightRecord(m_heights_map, *block_index)};
+            return entry && ReadFilterMapped(entry->pos, entry->hash, filter_out, remap);
+        })) {
+        return true;
+    }
+
     DBVal entry;
     if (!LookupOne(*m_db, block_index, entry)) {
         return false;
@@ -430,6 +593,15 @@ bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint25
         }
     }
 
+    if (ReadMapped([&](bool remap) {
+            if (remap) MapHeightRecords(block_index->nHeight);
+            auto entry{ReadHeightRecord(m_heights_map, *block_index)};
+            if (entry) header_out = entry->header;
+            return entry.has_value();
+        })) {
+        return true;
+    }
+
     DBVal entry;
     if (!LookupOne(*m_db, block_index, entry)) {
         return false;
@@ -449,6 +621,19 @@ bool BlockFilterIndex::LookupFilterRange(int start_height, const CBlockIndex* st
                                          std::vector<BlockFilter>& filters_out) const
 {
     std::vector<DBVal> entries;
+    // Serve the range from the memory mappings if all of it is there.
+    if (ReadMapped([&](bool remap) {
+            if (remap) MapHeightRecords(stop_index->nHeight);
+            if (!ReadHeightRecordRange(m_heights_map, start_height, stop_index, entries)) return false;
+            filters_out.resize(entries.size());
+            for (size_t i = 0; i < entries.size(); ++i) {
+                if (!ReadFilterMapped(entries[i].pos, entries[i].hash, filters_out[i], remap)) return false;
+            }
+            return true;
+        })) {
+        return true;
+    }
+
     if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
         return false;
     }
@@ -470,7 +655,11 @@ bool BlockFilterIndex::LookupFilterHashRange(int start_height, const CBlockIndex
 
 {
     std::vector<DBVal> entries;
-    if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
+    if (!ReadMapped([&](bool remap) {
+            if (remap) MapHeightRecords(stop_index->nHeight);
+            return ReadHeightRecordRange(m_heights_map, start_height, stop_index, entries);
+        }) &&
+        !LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
         return false;
     }
 
@@ -10,8 +10,15 @@
 #include <chain.h>
 #include <flatfile.h>
 #include <index/base.h>
+#include <streams.h>
 #include <util/hasher.h>
+#include <util/mmapfile.h>
 
+#include <atomic>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <string>
 #include <unordered_map>
 
 static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
@@ -19,6 +26,9 @@ static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 /** Interval between compact filter checkpoints. See BIP 157. */
 static constexpr int CFCHECKPT_INTERVAL = 1000;
 
+/** Size of a record in heights.dat: block hash, filter hash, header, file number, position, checksum. */
+static constexpr size_t HEIGHT_RECORD_SIZE{32 + 32 + 32 + 4 + 4 + 8};
+
 /**
  * BlockFilterIndex is used to store and retrieve block filters, hashes, and headers for a range of
  * blocks by height. An index is constructed for each supported filter type with its own database
@@ -35,9 +45,53 @@ private:
     FlatFilePos m_next_filter_pos;
     std::unique_ptr<FlatFileSeq> m_filter_fileseq;
 
+    /**
+     * Height-indexed copy of the database entries of the active chain, one fixed-size record per
+     * height, so that ranges of filters and headers can be served from a memory mapping without
+     * LevelDB lookups. It is only a cache: records are checked against the requested block and
+     * against a checksum, and the database is used when they do not match.
+     */
+    fs::path m_heights_path;
+    /** heights.dat, kept open for the index thread to write the records. */
+    std::unique_ptr<AutoFile> m_heights_file;
+    /**
+     * Set once heights.dat could not be opened, written or mapped. Neither the records nor the
+     * memory mappings are used from then on, so that the failure is only reported once.
+     */
+    mutable std::atomic<bool> m_heights_disabled{false};
+
+    /**
+     * Guards the memory mappings. Reading through them takes it shared; (re-)mapping a file, because
+     * it grew or is about to be truncated, takes it exclusively.
+     */
+    mutable std::shared_mutex m_mapped_mutex;
+    mutable MappedFile m_heights_map;
+    /** Memory mappings of the filter files, by file number. */
+    mutable std::map<int, MappedFile> m_filter_maps;
+
     bool ReadFilterFromDisk(const FlatFilePos& pos, const uint256& hash, BlockFilter& filter) const;
     size_t WriteFilterToDisk(FlatFilePos& pos, const BlockFilter& filter);
 
+    /**
+     * Run read(remap) through the memory mappings with m_mapped_mutex held shared and remap false. If
+     * that fails, run it again with the mutex held exclusively and remap true, which allows it to
+     * (re-)map the files it needs.
+     */
+    template <typename Fn>
+    bool ReadMapped(Fn read) const;
+
+    /** Stop using heights.dat and the memory mappings for the rest of the session, warning the first time. */
+    void DisableHeightRecords(const std::string& reason) const;
+
+    /** Re-map heights.dat if the mapping does not cover the record at height. Requires m_mapped_mutex held exclusively. */
+    void MapHeightRecords(int height) const;
+
+    /**
+     * Read a filter through the memory mapping of its file. With remap, which requires m_mapped_mutex
+     * held exclusively, the file is mapped if it is not yet or if the filter lies beyond the mapping.
+     */
+    bool ReadFilterMapped(const FlatFilePos& pos, const uint256& hash, BlockFilter& filter, bool remap) const;
+
     Mutex m_cs_headers_cache;
     /** cache of block hash to filter header, to avoid disk access when responding to getcfcheckpt. */
     std::unordered_map<uint256, uint256, FilterHeaderHasher> m_headers_cache GUARDED_BY(m_cs_headers_cache);
@@ -49,6 +103,9 @@ private:
 
     bool Write(const BlockFilter& filter, uint32_t block_height, const uint256& filter_header);
 
+    /** Chain the filter's header onto the last one and write both to the index. */
+    bool AppendFilter(const BlockFilter& filter, uint32_t block_height);
+
     std::optional<uint256> ReadFilterHeader(int height, const uint256& expected_block_hash);
 
 protected:
@@ -60,6 +117,10 @@ protected:
 
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
     bool CustomRemove(const interfaces::BlockInfo& block) override;
 
     BaseIndex::DB& GetDB() const LIFETIMEBOUND override { return *m_db; }
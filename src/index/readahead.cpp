@@ -0,0 +1,231 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/readahead.h>
+
+#include <chain.h>
+#include <kernel/chain.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <tinyformat.h>
+#include <undo.h>
+#include <util/thread.h>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+BlockReadAhead::BlockReadAhead(node::BlockManager& blockman, int num_threads)
+    : m_blockman{blockman}, m_window{std::max<size_t>(num_threads * READ_AHEAD_BLOCKS_PER_THREAD, 1)}
+{
+    for (int n = 0; n < num_threads; ++n) {
+        m_threads.emplace_back(&util::TraceThread, strprintf("idxread.%d", n), [this] { ThreadWorker(); });
+    }
+}
+
+BlockReadAhead::~BlockReadAhead()
+{
+    {
+        LOCK(m_mutex);
+        assert(m_consumers.empty());
+        m_stop = true;
+    }
+    m_work_cv.notify_all();
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+std::unique_ptr<BlockReadAhead::Subscription> BlockReadAhead::Subscribe(bool read_undo, PrepareFn prepare)
+{
+    LOCK(m_mutex);
+    auto& consumer{*m_consumers.emplace_back(std::make_unique<Consumer>())};
+    consumer.read_undo = read_undo;
+    consumer.prepare = std::move(prepare);
+    return std::unique_ptr<Subscription>(new Subscription(*this, consumer));
+}
+
+void BlockReadAhead::Unsubscribe(Consumer& consumer)
+{
+    WAIT_LOCK(m_mutex, lock);
+    ClearLocked(consumer);
+    // Workers may still be running the prepare function for a dropped slot.
+    m_done_cv.wait(lock, [&] { return consumer.running == 0; });
+    std::erase_if(m_consumers, [&](const auto& c) { return c.get() == &consumer; });
+    // Subscriptions held back by this one may continue.
+    m_done_cv.notify_all();
+}
+
+bool BlockReadAhead::Push(Consumer& consumer, const CBlockIndex* pindex)
+{
+    {
+        LOCK(m_mutex);
+        const int window{static_cast<int>(m_window)};
+        if (consumer.slots.size() >= m_window) return false;
+        const int position{consumer.slots.empty() || !consumer.position ? pindex->nHeight - 1 : *consumer.position};
+        for (const auto& other : m_consumers) {
+            if (other.get() == &consumer || !other->position) continue;
+            const int behind{position - *other->position};
+            if (behind >= 0 && behind < window && pindex->nHeight - *other->position > window) return false;
+        }
+        consumer.position = position;
+
+        auto& shared{m_blocks[pindex]};
+        if (!shared) {
+            shared = std::make_shared<SharedBlock>();
+            shared->pindex = pindex;
+        }
+        shared->want_undo |= consumer.read_undo;
+        ++shared->refs;
+
+        auto slot{std::make_shared<Slot>()};
+        slot->consumer = &consumer;
+        slot->shared = shared;
+        slot->sequence = m_next_sequence++;
+        consumer.slots.push_back(std::move(slot));
+    }
+    m_work_cv.notify_one();
+    return true;
+}
+
+BlockReadAhead::Entry BlockReadAhead::Pop(Consumer& consumer)
+{
+    WAIT_LOCK(m_mutex, lock);
+    assert(!consumer.slots.empty());
+    std::shared_ptr<Slot> slot{consumer.slots.front()};
+    m_done_cv.wait(lock, [&] { return slot->done; });
+    consumer.slots.pop_front();
+    Release(slot);
+    consumer.position = slot->shared->pindex->nHeight;
+    // Subscriptions held back by this one may continue.
+    m_done_cv.notify_all();
+    return std::move(slot->entry);
+}
+
+void BlockReadAhead::Clear(Consumer& consumer)
+{
+    LOCK(m_mutex);
+    ClearLocked(consumer);
+}
+
+void BlockReadAhead::ClearLocked(Consumer& consumer)
+{
+    for (const auto& slot : consumer.slots) Release(slot);
+    consumer.slots.clear();
+}
+
+void BlockReadAhead::WaitForOthers(std::chrono::milliseconds timeout)
+{
+    WAIT_LOCK(m_mutex, lock);
+    m_done_cv.wait_for(lock, timeout);
+}
+
+const CBlockIndex* BlockReadAhead::Front(const Consumer& consumer) const
+{
+    LOCK(m_mutex);
+    return consumer.slots.empty() ? nullptr : consumer.slots.front()->shared->pindex;
+}
+
+const CBlockIndex* BlockReadAhead::Back(const Consumer& consumer) const
+{
+    LOCK(m_mutex);
+    return consumer.slots.empty() ? nullptr : consumer.slots.back()->shared->pindex;
+}
+
+size_t BlockReadAhead::Size(const Consumer& consumer) const
+{
+    LOCK(m_mutex);
+    return consumer.slots.size();
+}
+
+std::shared_ptr<BlockReadAhead::Slot> BlockReadAhead::NextWork()
+{
+    // Pick the oldest queued slot that no worker has started on, so that blocks become ready roughly
+    // in the order they are needed. Skip slots whose block another worker is reading; they can be
+    // picked up once it is done.
+    std::shared_ptr<Slot> best;
+    for (const auto& consumer : m_consumers) {
+        for (const auto& slot : consumer->slots) {
+            if (slot->started || slot->shared->reading) continue;
+            if (!best || slot->sequence < best->sequence) best = slot;
+            break;
+        }
+    }
+    return best;
+}
+
+void BlockReadAhead::Release(const std::shared_ptr<Slot>& slot)
+{
+    if (--slot->shared->refs > 0) return;
+    auto it{m_blocks.find(slot->shared->pindex)};
+    if (it != m_blocks.end() && it->second == slot->shared) m_blocks.erase(it);
+}
+
+void BlockReadAhead::ThreadWorker()
+{
+    WAIT_LOCK(m_mutex, lock);
+    while (true) {
+        if (m_stop) return;
+        std::shared_ptr<Slot> slot{NextWork()};
+        if (!slot) {
+            m_work_cv.wait(lock);
+            continue;
+        }
+
+        slot->started = true;
+        Consumer& consumer{*slot->consumer};
+        ++consumer.running;
+        const std::shared_ptr<SharedBlock> shared{slot->shared};
+        const CBlockIndex* pindex{shared->pindex};
+
+        // Read the block once for all subscriptions that queued it.
+        if (!shared->done) {
+            shared->reading = true;
+            const bool want_undo{shared->want_undo};
+            auto block{std::make_shared<CBlock>()};
+            std::shared_ptr<CBlockUndo> undo;
+            bool ok;
+            {
+                REVERSE_LOCK(lock, m_mutex);
+                ok = m_blockman.ReadBlock(*block, *pindex);
+                if (ok && want_undo) {
+                    undo = std::make_shared<CBlockUndo>();
+                    ok = pindex->nHeight == 0 || m_blockman.ReadBlockUndo(*undo, *pindex);
+                }
+            }
+            shared->block = std::move(block);
+            shared->undo = std::move(undo);
+            shared->ok = ok;
+            shared->reading = false;
+            shared->done = true;
+            m_work_cv.notify_all();
+        }
+
+        Entry entry;
+        entry.pindex = pindex;
+        entry.block = shared->block;
+        entry.undo = consumer.read_undo ? shared->undo : nullptr;
+        entry.ok = shared->ok;
+        const bool read_undo{consumer.read_undo};
+        const PrepareFn& prepare{consumer.prepare};
+        {
+            // The consumer stays alive while running is non-zero, and its
+            // read_undo and prepare members never change.
+            REVERSE_LOCK(lock, m_mutex);
+            // The block may have been read for subscriptions that did not need undo data.
+            if (entry.ok && read_undo && !entry.undo) {
+                auto undo{std::make_shared<CBlockUndo>()};
+                entry.ok = pindex->nHeight == 0 || m_blockman.ReadBlockUndo(*undo, *pindex);
+                entry.undo = std::move(undo);
+            }
+            if (entry.ok && prepare) {
+                interfaces::BlockInfo block_info{kernel::MakeBlockInfo(pindex, entry.block.get())};
+                block_info.undo_data = entry.undo.get();
+                entry.prepared = prepare(block_info);
+            }
+        }
+        slot->entry = std::move(entry);
+        slot->done = true;
+        --consumer.running;
+        m_done_cv.notify_all();
+    }
+}
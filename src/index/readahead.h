@@ -0,0 +1,191 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_READAHEAD_H
+#define BITCOIN_INDEX_READAHEAD_H
+
+#include <interfaces/chain.h>
+#include <sync.h>
+#include <threadsafety.h>
+
+#include <any>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class CBlockUndo;
+namespace node {
+class BlockManager;
+} // namespace node
+
+//! Number of blocks each read-ahead thread may have queued per subscription.
+static constexpr size_t READ_AHEAD_BLOCKS_PER_THREAD{8};
+
+/**
+ * Reads blocks, and optionally their undo data, on a pool of worker threads
+ * ahead of the index sync threads that consume them in chain order.
+ *
+ * Every index sync thread takes a Subscription, queues the blocks it is about
+ * to process with Push(), in the order it will process them, and takes them
+ * back with Pop(). At most `window` blocks are queued per subscription.
+ * Workers also run an optional per-subscription `prepare` function on every
+ * block, which lets an index move block-local work (such as computing a
+ * filter) off its sync thread.
+ *
+ * Subscriptions share their reads: a block queued by several subscriptions
+ * at the same time is read and deserialized only once. To keep indexes that
+ * sync the same range of blocks together, a subscription may not queue blocks
+ * more than `window` blocks ahead of the slowest subscription that is less
+ * than `window` blocks behind it. Subscriptions further behind do not hold
+ * others back, so an index rebuilding from genesis does not stall one that is
+ * only catching up on recent blocks.
+ */
+class BlockReadAhead
+{
+public:
+    using PrepareFn = std::function<std::any(const interfaces::BlockInfo&)>;
+
+    struct Entry {
+        const CBlockIndex* pindex{nullptr};
+        std::shared_ptr<const CBlock> block;
+        //! Undo data, if requested. Empty (not null) for the genesis block.
+        std::shared_ptr<const CBlockUndo> undo;
+        //! Result of the prepare function, if any.
+        std::any prepared;
+        //! Whether the block and requested undo data were read successfully.
+        bool ok{false};
+    };
+
+    class Subscription;
+
+    BlockReadAhead(node::BlockManager& blockman, int num_threads);
+    ~BlockReadAhead();
+
+    BlockReadAhead(const BlockReadAhead&) = delete;
+    BlockReadAhead& operator=(const BlockReadAhead&) = delete;
+
+    //! Start consuming blocks. The subscription must be destroyed before this object.
+    std::unique_ptr<Subscription> Subscribe(bool read_undo, PrepareFn prepare) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    //! A block read on behalf of all subscriptions that queued it.
+    struct SharedBlock {
+        const CBlockIndex* pindex{nullptr};
+        std::shared_ptr<const CBlock> block;
+        std::shared_ptr<const CBlockUndo> undo;
+        //! Whether undo data should be read along with the block.
+        bool want_undo{false};
+        bool reading{false};
+        bool done{false};
+        bool ok{false};
+        //! Number of queued slots referring to this block.
+        int refs{0};
+    };
+
+    struct Consumer;
+
+    //! A block queued by one subscription.
+    struct Slot {
+        Consumer* consumer{nullptr};
+        std::shared_ptr<SharedBlock> shared;
+        Entry entry;
+        //! Order in which slots were queued, across all subscriptions.
+        uint64_t sequence{0};
+        bool started{false};
+        bool done{false};
+    };
+
+    //! State of one subscription. Only accessed with m_mutex held.
+    struct Consumer {
+        bool read_undo{false};
+        PrepareFn prepare;
+        //! Queued blocks, oldest first. Workers keep their own reference to the slot they are
+        //! working on, so slots can be dropped by Clear() while in progress.
+        std::deque<std::shared_ptr<Slot>> slots;
+        //! Height of the last block taken with Pop(), or of the block before the first one queued.
+        std::optional<int> position;
+        //! Number of this subscription's slots workers are working on.
+        int running{0};
+    };
+
+    void Unsubscribe(Consumer& consumer) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    bool Push(Consumer& consumer, const CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    Entry Pop(Consumer& consumer) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void Clear(Consumer& consumer) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void ClearLocked(Consumer& consumer) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void WaitForOthers(std::chrono::milliseconds timeout) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    const CBlockIndex* Front(const Consumer& consumer) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    const CBlockIndex* Back(const Consumer& consumer) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    size_t Size(const Consumer& consumer) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    void ThreadWorker() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    //! Find the oldest queued slot that a worker can make progress on.
+    std::shared_ptr<Slot> NextWork() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Release(const std::shared_ptr<Slot>& slot) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    node::BlockManager& m_blockman;
+    const size_t m_window;
+
+    mutable Mutex m_mutex;
+    //! Signalled when a slot is queued, when a shared block has been read, or when the workers should stop.
+    std::condition_variable m_work_cv;
+    //! Signalled when a slot has been read, or when a subscription advanced or went away.
+    std::condition_variable m_done_cv;
+    //! Blocks currently queued by at least one subscription.
+    std::unordered_map<const CBlockIndex*, std::shared_ptr<SharedBlock>> m_blocks GUARDED_BY(m_mutex);
+    std::vector<std::unique_ptr<Consumer>> m_consumers GUARDED_BY(m_mutex);
+    uint64_t m_next_sequence GUARDED_BY(m_mutex){0};
+    bool m_stop GUARDED_BY(m_mutex){false};
+
+    std::vector<std::thread> m_threads;
+};
+
+/** One consumer of a BlockReadAhead, usually an index sync thread. */
+class BlockReadAhead::Subscription
+{
+public:
+    ~Subscription() { m_source.Unsubscribe(m_consumer); }
+
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    //! Queue a block for reading. Returns false, without queueing it, if the window is full or if
+    //! the block is too far ahead of a slower subscription.
+    bool Push(const CBlockIndex* pindex) { return m_source.Push(m_consumer, pindex); }
+
+    //! Take the oldest queued block, waiting until it has been read. Must not be called if Size() is 0.
+    Entry Pop() { return m_source.Pop(m_consumer); }
+
+    //! Discard all queued blocks, e.g. because a reorg made them stale.
+    void Clear() { m_source.Clear(m_consumer); }
+
+    //! Wait, at most for the given time, until another subscription made progress or went away.
+    void WaitForOthers(std::chrono::milliseconds timeout) { m_source.WaitForOthers(timeout); }
+
+    //! The oldest and the most recently queued block, or nullptr if none are queued.
+    const CBlockIndex* Front() const { return m_source.Front(m_consumer); }
+    const CBlockIndex* Back() const { return m_source.Back(m_consumer); }
+
+    size_t Size() const { return m_source.Size(m_consumer); }
+
+private:
+    friend class BlockReadAhead;
+
+    Subscription(BlockReadAhead& source, Consumer& consumer) : m_source{source}, m_consumer{consumer} {}
+
+    BlockReadAhead& m_source;
+    Consumer& m_consumer;
+};
+
+#endif // BITCOIN_INDEX_READAHEAD_H
@@ -0,0 +1,233 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/scriptindex.h>
+
+#include <common/args.h>
+#include <crypto/sha256.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <undo.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <ios>
+#include <utility>
+
+/**
+ * Keys are [DB_SCRIPT, SHA256(scriptPubKey), height, tx position, spend flag, input/output index],
+ * with all integers big-endian so that the history of a script is sorted in block chain order.
+ * Outputs have an OutputValue and spends a SpendValue.
+ */
+constexpr uint8_t DB_SCRIPT{'s'};
+
+std::unique_ptr<ScriptIndex> g_script_index;
+
+namespace {
+
+struct DBKey {
+    uint256 script_hash;
+    uint32_t height{0};
+    uint32_t tx_pos{0};
+    bool spend{false};
+    uint32_t index{0};
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SCRIPT);
+        s << script_hash;
+        ser_writedata32be(s, height);
+        ser_writedata32be(s, tx_pos);
+        ser_writedata8(s, spend);
+        ser_writedata32be(s, index);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_SCRIPT) {
+            throw std::ios_base::failure("Invalid format for script index DB key");
+        }
+        s >> script_hash;
+        height = ser_readdata32be(s);
+        tx_pos = ser_readdata32be(s);
+        spend = ser_readdata8(s) != 0;
+        index = ser_readdata32be(s);
+    }
+};
+
+struct OutputValue {
+    Txid txid;
+    CAmount amount{0};
+
+    SERIALIZE_METHODS(OutputValue, obj) { READWRITE(obj.txid, obj.amount); }
+};
+
+struct SpendValue {
+    Txid txid;
+    CAmount amount{0};
+    COutPoint prevout;
+
+    SERIALIZE_METHODS(SpendValue, obj) { READWRITE(obj.txid, obj.amount, obj.prevout); }
+};
+
+/** All index entries for one block. */
+struct BlockEntries {
+    std::vector<std::pair<DBKey, OutputValue>> outputs;
+    std::vector<std::pair<DBKey, SpendValue>> spends;
+};
+
+uint256 ScriptHash(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+BlockEntries ComputeBlockEntries(const interfaces::BlockInfo& block)
+{
+    BlockEntries entries;
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return entries;
+
+    const CBlock& data{*Assert(block.data)};
+    const CBlockUndo& undo{*Assert(block.undo_data)};
+    for (uint32_t tx_pos = 0; tx_pos < data.vtx.size(); ++tx_pos) {
+        const CTransaction& tx{*data.vtx[tx_pos]};
+        if (tx_pos > 0) {
+            const CTxUndo& tx_undo{undo.vtxundo.at(tx_pos - 1)};
+            for (uint32_t n = 0; n < tx.vin.size(); ++n) {
+                const CTxOut& spent{tx_undo.vprevout.at(n).out};
+                entries.spends.emplace_back(DBKey{ScriptHash(spent.scriptPubKey), uint32_t(block.height), tx_pos, /*spend=*/true, n},
+                                            SpendValue{tx.GetHash(), spent.nValue, tx.vin[n].prevout});
+            }
+        }
+        for (uint32_t n = 0; n < tx.vout.size(); ++n) {
+            const CTxOut& out{tx.vout[n]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            entries.outputs.emplace_back(DBKey{ScriptHash(out.scriptPubKey), uint32_t(block.height), tx_pos, /*spend=*/false, n},
+                                         OutputValue{tx.GetHash(), out.nValue});
+        }
+    }
+    return entries;
+}
+
+} // namespace
+
+/** Access to the script index database (indexes/scriptindex/) */
+class ScriptIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write the entries of a block to the DB.
+    [[nodiscard]] bool WriteEntries(const BlockEntries& entries);
+
+    /// Erase the entries of a block from the DB.
+    [[nodiscard]] bool EraseEntries(const BlockEntries& entries);
+};
+
+ScriptIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "scriptindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool ScriptIndex::DB::WriteEntries(const BlockEntries& entries)
+{
+    CDBBatch batch(*this);
+    for (const auto& [key, value] : entries.spends) batch.Write(key, value);
+    for (const auto& [key, value] : entries.outputs) batch.Write(key, value);
+    return WriteBatch(batch);
+}
+
+bool ScriptIndex::DB::EraseEntries(const BlockEntries& entries)
+{
+    CDBBatch batch(*this);
+    for (const auto& entry : entries.spends) batch.Erase(entry.first);
+    for (const auto& entry : entries.outputs) batch.Erase(entry.first);
+    return WriteBatch(batch);
+}
+
+ScriptIndex::ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "scriptindex"), m_db(std::make_unique<ScriptIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+ScriptIndex::~ScriptIndex() = default;
+
+interfaces::Chain::NotifyOptions ScriptIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.connect_undo_data = true;
+    options.disconnect_data = true;
+    options.disconnect_undo_data = true;
+    return options;
+}
+
+bool ScriptIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    return m_db->WriteEntries(ComputeBlockEntries(block));
+}
+
+std::any ScriptIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    return ComputeBlockEntries(block);
+}
+
+bool ScriptIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    return m_db->WriteEntries(std::any_cast<const BlockEntries&>(prepared));
+}
+
+bool ScriptIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    return m_db->EraseEntries(ComputeBlockEntries(block));
+}
+
+BaseIndex::DB& ScriptIndex::GetDB() const { return *m_db; }
+
+std::optional<ScriptHistory> ScriptIndex::FindScriptHistory(const CScript& script, int start_height, size_t limit) const
+{
+    const uint256 script_hash{ScriptHash(script)};
+    ScriptHistory history;
+
+    std::unique_ptr<CDBIterator> it{m_db->NewIterator()};
+    it->Seek(DBKey{script_hash, uint32_t(std::max(start_height, 0))});
+    for (; it->Valid(); it->Next()) {
+        DBKey key;
+        if (!it->GetKey(key) || key.script_hash != script_hash) break;
+        const int height{int(key.height)};
+        if (!history.entries.empty() && history.entries.size() >= limit && height != history.entries.back().height) {
+            history.next_height = height;
+            break;
+        }
+
+        ScriptHistoryEntry& entry{history.entries.emplace_back()};
+        entry.height = height;
+        entry.tx_pos = key.tx_pos;
+        entry.spend = key.spend;
+        entry.index = key.index;
+        bool ok;
+        if (key.spend) {
+            SpendValue value;
+            ok = it->GetValue(value);
+            entry.txid = value.txid;
+            entry.amount = value.amount;
+            entry.prevout = value.prevout;
+        } else {
+            OutputValue value;
+            ok = it->GetValue(value);
+            entry.txid = value.txid;
+            entry.amount = value.amount;
+        }
+        if (!ok) {
+            LogError("%s: Cannot read script index entry at height %d\n", __func__, height);
+            return std::nullopt;
+        }
+    }
+    return history;
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SCRIPTINDEX_H
+#define BITCOIN_INDEX_SCRIPTINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class CScript;
+
+static constexpr bool DEFAULT_SCRIPTINDEX{false};
+
+/** One appearance of a script in the block chain: an output paying to it, or an input spending such an output. */
+struct ScriptHistoryEntry {
+    int height{0};
+    //! Position of the transaction in its block.
+    uint32_t tx_pos{0};
+    //! Whether this is an input spending an output with the script, rather than an output paying to it.
+    bool spend{false};
+    //! Index of the input (for spends) or output (otherwise) within the transaction.
+    uint32_t index{0};
+    //! The transaction with the input or output.
+    Txid txid;
+    //! Value of the output, or of the output being spent.
+    CAmount amount{0};
+    //! For spends, the output being spent.
+    COutPoint prevout;
+};
+
+struct ScriptHistory {
+    //! Entries in block chain order.
+    std::vector<ScriptHistoryEntry> entries;
+    //! If the history was cut short by a limit, the height to continue from.
+    std::optional<int> next_height;
+};
+
+/**
+ * ScriptIndex records, for every scriptPubKey, the outputs paying to it and
+ * the inputs spending those outputs, ordered by block height and position in
+ * the block. Outputs that can never be spent (e.g. OP_RETURN) and the genesis
+ * block are not indexed.
+ */
+class ScriptIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~ScriptIndex() override;
+
+    /// Look up the history of a script from the given height on.
+    ///
+    /// @param[in]  script        The scriptPubKey to look up.
+    /// @param[in]  start_height  The height of the first block to include.
+    /// @param[in]  limit         Stop after this many entries, but not in the middle of a block.
+    /// @return  The history, or std::nullopt if the index could not be read.
+    std::optional<ScriptHistory> FindScriptHistory(const CScript& script, int start_height, size_t limit) const;
+};
+
+/// The global script history index. May be null.
+extern std::unique_ptr<ScriptIndex> g_script_index;
+
+#endif // BITCOIN_INDEX_SCRIPTINDEX_H
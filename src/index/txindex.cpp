@@ -54,11 +54,9 @@ TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
 
 TxIndex::~TxIndex() = default;
 
-bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+/** Compute the disk position of every transaction in a block. */
+static std::vector<std::pair<uint256, CDiskTxPos>> ComputeTxPositions(const interfaces::BlockInfo& block)
 {
-    // Exclude genesis block transaction because outputs are not spendable.
-    if (block.height == 0) return true;
-
     assert(block.data);
     CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block.data->vtx.size()));
     std::vector<std::pair<uint256, CDiskTxPos>> vPos;
@@ -67,7 +65,26 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
     }
-    return m_db->WriteTxs(vPos);
+    return vPos;
+}
+
+bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return true;
+
+    return m_db->WriteTxs(ComputeTxPositions(block));
+}
+
+std::any TxIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    if (block.height == 0) return {};
+    return ComputeTxPositions(block);
+}
+
+bool TxIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    return m_db->WriteTxs(std::any_cast<const std::vector<std::pair<uint256, CDiskTxPos>>&>(prepared));
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
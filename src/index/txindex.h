@@ -27,6 +27,10 @@ private:
 protected:
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
     BaseIndex::DB& GetDB() const override;
 
 public:
@@ -0,0 +1,126 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/txospenderindex.h>
+
+#include <common/args.h>
+#include <dbwrapper.h>
+#include <primitives/block.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+/** Keys are [DB_TXOSPENDER, spent outpoint] and values the TxoSpender of the outpoint. */
+constexpr uint8_t DB_TXOSPENDER{'o'};
+
+std::unique_ptr<TxoSpenderIndex> g_txospender_index;
+
+namespace {
+
+using BlockSpends = std::vector<std::pair<COutPoint, TxoSpender>>;
+
+BlockSpends ComputeBlockSpends(const interfaces::BlockInfo& block)
+{
+    BlockSpends spends;
+    const CBlock& data{*Assert(block.data)};
+    for (size_t i = 1; i < data.vtx.size(); ++i) {
+        const CTransaction& tx{*data.vtx[i]};
+        for (uint32_t n = 0; n < tx.vin.size(); ++n) {
+            spends.emplace_back(tx.vin[n].prevout, TxoSpender{tx.GetHash(), n, block.height, block.hash});
+        }
+    }
+    return spends;
+}
+
+} // namespace
+
+/** Access to the spender index database (indexes/txospenderindex/) */
+class TxoSpenderIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write the spends of a block to the DB.
+    [[nodiscard]] bool WriteSpends(const BlockSpends& spends);
+
+    /// Erase the spends of a block from the DB.
+    [[nodiscard]] bool EraseSpends(const BlockSpends& spends);
+};
+
+TxoSpenderIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "txospenderindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool TxoSpenderIndex::DB::WriteSpends(const BlockSpends& spends)
+{
+    CDBBatch batch(*this);
+    for (const auto& [outpoint, spender] : spends) {
+        batch.Write(std::make_pair(DB_TXOSPENDER, outpoint), spender);
+    }
+    return WriteBatch(batch);
+}
+
+bool TxoSpenderIndex::DB::EraseSpends(const BlockSpends& spends)
+{
+    CDBBatch batch(*this);
+    for (const auto& spend : spends) {
+        batch.Erase(std::make_pair(DB_TXOSPENDER, spend.first));
+    }
+    return WriteBatch(batch);
+}
+
+TxoSpenderIndex::TxoSpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "txospenderindex"), m_db(std::make_unique<TxoSpenderIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+TxoSpenderIndex::~TxoSpenderIndex() = default;
+
+interfaces::Chain::NotifyOptions TxoSpenderIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.disconnect_data = true;
+    return options;
+}
+
+bool TxoSpenderIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    return m_db->WriteSpends(ComputeBlockSpends(block));
+}
+
+std::any TxoSpenderIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    return ComputeBlockSpends(block);
+}
+
+bool TxoSpenderIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    return m_db->WriteSpends(std::any_cast<const BlockSpends&>(prepared));
+}
+
+bool TxoSpenderIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    return m_db->EraseSpends(ComputeBlockSpends(block));
+}
+
+BaseIndex::DB& TxoSpenderIndex::GetDB() const { return *m_db; }
+
+std::vector<std::optional<TxoSpender>> TxoSpenderIndex::FindSpenders(std::span<const COutPoint> outpoints) const
+{
+    // Look the outpoints up in key order, which keeps consecutive reads in the same
+    // LevelDB blocks when a batch contains several outputs of one transaction.
+    std::vector<size_t> order(outpoints.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return outpoints[a] < outpoints[b]; });
+
+    std::vector<std::optional<TxoSpender>> spenders(outpoints.size());
+    for (const size_t i : order) {
+        TxoSpender spender;
+        if (m_db->Read(std::make_pair(DB_TXOSPENDER, outpoints[i]), spender)) {
+            spenders[i] = std::move(spender);
+        }
+    }
+    return spenders;
+}
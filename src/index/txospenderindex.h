@@ -0,0 +1,79 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_TXOSPENDERINDEX_H
+#define BITCOIN_INDEX_TXOSPENDERINDEX_H
+
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+static constexpr bool DEFAULT_TXOSPENDERINDEX{false};
+
+/** The confirmed transaction input spending an output. */
+struct TxoSpender {
+    Txid txid;
+    //! Index of the spending input within the transaction.
+    uint32_t vin{0};
+    int height{0};
+    uint256 block_hash;
+
+    SERIALIZE_METHODS(TxoSpender, obj) { READWRITE(obj.txid, obj.vin, obj.height, obj.block_hash); }
+};
+
+/**
+ * TxoSpenderIndex records, for every output spent in the block chain, the
+ * transaction input that spent it. Together with the mempool this answers
+ * "has this output been spent, and by what?" without scanning blocks.
+ */
+class TxoSpenderIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit TxoSpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~TxoSpenderIndex() override;
+
+    /// Look up the spenders of a batch of outputs.
+    ///
+    /// @param[in]  outpoints  The outputs to look up.
+    /// @return  For every outpoint, in the same order, its spender or std::nullopt if it is unspent
+    ///          in the block chain (or unknown).
+    std::vector<std::optional<TxoSpender>> FindSpenders(std::span<const COutPoint> outpoints) const;
+};
+
+/// The global transaction output spender index. May be null.
+extern std::unique_ptr<TxoSpenderIndex> g_txospender_index;
+
+#endif // BITCOIN_INDEX_TXOSPENDERINDEX_H
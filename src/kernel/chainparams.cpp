@@ -150,8 +150,8 @@ public:
         genesis = CreateGenesisBlock(1719792000, 0, 0x207fffff, 1, 2000000000LL * COIN);
         consensus.hashGenesisBlock = genesis.GetHash();
 
-        assert(consensus.hashGenesisBlock == uint256{"0xa2a00f1b0fab74d41f63451c0655481eb22ef37f7cde115c0f25cef6b447bd7b"});
-        assert(genesis.hashMerkleRoot == uint256{"0xe9cdd17d0935491ae1bfa045800e17381f987f96991d40febf7b5cb7e293fba2"});
+        assert(consensus.hashGenesisBlock == uint256{"a2a00f1b0fab74d41f63451c0655481eb22ef37f7cde115c0f25cef6b447bd7b"});
+        assert(genesis.hashMerkleRoot == uint256{"e9cdd17d0935491ae1bfa045800e17381f987f96991d40febf7b5cb7e293fba2"});
 
         // Vertocoin seed nodes
         vSeeds.emplace_back("explorer.vertomax.com.");
@@ -22,6 +22,8 @@ class CChainParams;
 class ValidationSignals;
 
 static constexpr auto DEFAULT_MAX_TIP_AGE{24h};
+//! Percentage of the coins caches given to the background chainstate once the snapshot chainstate has caught up.
+static constexpr int DEFAULT_BACKGROUND_CACHE_PERCENT{95};
 
 namespace kernel {
 
@@ -46,6 +48,12 @@ struct ChainstateManagerOpts {
     ValidationSignals* signals{nullptr};
     //! Number of script check worker threads. Zero means no parallel verification.
     int worker_threads_num{0};
+    //! Number of script check worker threads dedicated to background validation of an
+    //! assumeutxo snapshot. If unset, the background chainstate shares the worker_threads_num threads.
+    std::optional<int> background_worker_threads_num{};
+    //! Percentage of the coins caches given to the background chainstate once the snapshot
+    //! chainstate is out of initial block download.
+    int background_cache_percent{DEFAULT_BACKGROUND_CACHE_PERCENT};
     size_t script_execution_cache_bytes{DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES};
     size_t signature_cache_bytes{DEFAULT_SIGNATURE_CACHE_BYTES};
 };
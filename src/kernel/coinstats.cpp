@@ -20,18 +20,28 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/overflow.h>
+#include <util/thread.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
 #include <iosfwd>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace kernel {
 
+//! Number of key ranges the UTXO set is split into when computing statistics on several threads.
+static constexpr int UTXO_STATS_SHARDS{1024};
+
 CCoinsStats::CCoinsStats(int block_height, const uint256& block_hash)
     : nHeight(block_height),
       hashBlock(block_hash) {}
@@ -60,6 +70,21 @@ static void ApplyCoinHash(HashWriter& ss, const COutPoint& outpoint, const Coin&
     TxOutSer(ss, outpoint, coin);
 }
 
+static void ApplyCoinHash(DataStream& ss, const COutPoint& outpoint, const Coin& coin)
+{
+    TxOutSer(ss, outpoint, coin);
+}
+
+void ApplyTxCoinsHash(DataStream& ss, std::span<std::pair<COutPoint, Coin>> coins)
+{
+    // Coins databases order them by VARINT-encoded output index, which is not numeric order from
+    // index 16512, encoded as 80 80 00, on.
+    std::sort(coins.begin(), coins.end(), [](const auto& a, const auto& b) { return a.first.n < b.first.n; });
+    for (const auto& [outpoint, coin] : coins) {
+        ApplyCoinHash(ss, outpoint, coin);
+    }
+}
+
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin)
 {
     DataStream ss{};
@@ -111,20 +136,56 @@ static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<u
     }
 }
 
-//! Calculate statistics about the unspent transaction output set
-template <typename T>
-static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+static void CombineStats(CCoinsStats& stats, const CCoinsStats& shard)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
-    assert(pcursor);
+    stats.nTransactions += shard.nTransactions;
+    stats.nTransactionOutputs += shard.nTransactionOutputs;
+    stats.nBogoSize += shard.nBogoSize;
+    stats.coins_count += shard.coins_count;
+    if (stats.total_amount.has_value() && shard.total_amount.has_value()) {
+        stats.total_amount = CheckedAdd(*stats.total_amount, *shard.total_amount);
+    } else {
+        stats.total_amount = std::nullopt;
+    }
+}
 
+static void CombineHash(HashWriter& ss, const DataStream& shard)
+{
+    ss.write(std::span<const std::byte>{shard.data(), shard.size()});
+}
+static void CombineHash(MuHash3072& muhash, const MuHash3072& shard)
+{
+    muhash *= shard;
+}
+static void CombineHash(std::nullptr_t, std::nullptr_t) {}
+
+//! Memory held by a computed shard until it is combined.
+static size_t ShardSize(const DataStream& shard) { return shard.size(); }
+static size_t ShardSize(const MuHash3072&) { return sizeof(MuHash3072); }
+static size_t ShardSize(std::nullptr_t) { return 0; }
+
+/** First txid of a shard of the UTXO set. Shards are ranges of the leading 16 bits of the txid. */
+static Txid ShardStart(int shard)
+{
+    const unsigned int prefix = shard * (0x10000 / UTXO_STATS_SHARDS);
+    uint256 start;
+    start.begin()[0] = prefix >> 8;
+    start.begin()[1] = prefix & 0xff;
+    return Txid::FromUint256(start);
+}
+
+//! Apply the coins from the cursor's position up to (not including) txid end to the statistics
+template <typename T>
+static bool ApplyCoins(CCoinsViewCursor& cursor, const std::optional<Txid>& end, CCoinsStats& stats, T& hash_obj, const std::function<void()>& interruption_point)
+{
     Txid prevkey;
     std::map<uint32_t, Coin> outputs;
-    while (pcursor->Valid()) {
+    while (cursor.Valid()) {
         if (interruption_point) interruption_point();
         COutPoint key;
         Coin coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
+            if (end && !(key.hash < *end)) break;
             if (!outputs.empty() && key.hash != prevkey) {
                 ApplyStats(stats, prevkey, outputs);
                 ApplyHash(hash_obj, prevkey, outputs);
@@ -137,12 +198,131 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
             LogError("%s: unable to read value\n", __func__);
             return false;
         }
-        pcursor->Next();
+        cursor.Next();
     }
     if (!outputs.empty()) {
         ApplyStats(stats, prevkey, outputs);
         ApplyHash(hash_obj, prevkey, outputs);
     }
+    return true;
+}
+
+/**
+ * Calculate statistics about the unspent transaction output set on one thread per cursor.
+ *
+ * The set is split into UTXO_STATS_SHARDS ranges of txids, which the threads compute into their own
+ * statistics and hash object of type S: a serialization of the shard for HASH_SERIALIZED, or a MuHash
+ * of the shard. Shards are then combined into hash_obj in order, so the result is the same as when
+ * computed by one thread. The serializations of a slow shard and of the ones after it have to be kept
+ * until it is done, so threads only start new shards while the computed ones waiting to be combined
+ * take up less than max_buffered bytes.
+ */
+template <typename T, typename S>
+static bool ComputeUTXOStatsParallel(std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, CCoinsStats& stats, T& hash_obj, const std::function<void()>& interruption_point, size_t max_buffered)
+{
+    struct StopShards {};
+    struct Shard {
+        CCoinsStats stats;
+        S hash_obj{};
+        bool done{false};
+        bool ok{false};
+    };
+
+    std::vector<Shard> shards(UTXO_STATS_SHARDS);
+    Mutex mutex;
+    std::condition_variable cv;
+    int next_shard{0};
+    int combined{0};
+    size_t buffered{0};
+    size_t max_seen_buffered{0};
+    std::atomic<bool> stop{false};
+
+    auto worker = [&](CCoinsViewCursor& cursor) {
+        const std::function<void()> check_stop{[&] { if (stop) throw StopShards{}; }};
+        while (true) {
+            int shard;
+            {
+                WAIT_LOCK(mutex, lock);
+                // The shard to be combined next is always started, or the computation would stall.
+                cv.wait(lock, [&] { return stop || next_shard >= UTXO_STATS_SHARDS || next_shard == combined || buffered < max_buffered; });
+                if (stop || next_shard >= UTXO_STATS_SHARDS) return;
+                shard = next_shard++;
+            }
+            Shard result;
+            try {
+                const std::optional<Txid> end{shard + 1 < UTXO_STATS_SHARDS ? std::optional{ShardStart(shard + 1)} : std::nullopt};
+                result.ok = cursor.Seek(COutPoint{ShardStart(shard), 0}) && ApplyCoins(cursor, end, result.stats, result.hash_obj, check_stop);
+            } catch (const StopShards&) {
+                return;
+            } catch (const std::exception& e) {
+                LogError("%s: unable to read shard %d: %s\n", __func__, shard, e.what());
+                result.ok = false;
+            }
+            {
+                LOCK(mutex);
+                result.done = true;
+                buffered += ShardSize(result.hash_obj);
+                max_seen_buffered = std::max(max_seen_buffered, buffered);
+                shards[shard] = std::move(result);
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        threads.emplace_back(&util::TraceThread, strprintf("utxostats.%d", i), [&worker, &cursor = *cursors[i]] { worker(cursor); });
+    }
+    const auto stop_threads = [&] {
+        WITH_LOCK(mutex, stop = true);
+        cv.notify_all();
+        for (std::thread& thread : threads) thread.join();
+    };
+
+    bool ok{true};
+    try {
+        for (int i = 0; i < UTXO_STATS_SHARDS; ++i) {
+            Shard shard;
+            while (true) {
+                if (interruption_point) interruption_point();
+                WAIT_LOCK(mutex, lock);
+                if (cv.wait_for(lock, std::chrono::milliseconds{100}, [&] { return shards[i].done; })) {
+                    shard = std::move(shards[i]);
+                    break;
+                }
+            }
+            if (!shard.ok) {
+                ok = false;
+                break;
+            }
+            CombineStats(stats, shard.stats);
+            CombineHash(hash_obj, shard.hash_obj);
+            {
+                LOCK(mutex);
+                buffered -= ShardSize(shard.hash_obj);
+                ++combined;
+            }
+            cv.notify_all();
+        }
+    } catch (...) {
+        stop_threads();
+        throw;
+    }
+    stop_threads();
+    LogDebug(BCLog::COINDB, "Computed UTXO set statistics on %d threads, with up to %u bytes of shards waiting to be combined\n", cursors.size(), max_seen_buffered);
+    return ok;
+}
+
+//! Calculate statistics about the unspent transaction output set
+template <typename T, typename S>
+static bool ComputeUTXOStats(CCoinsView* view, std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, CCoinsStats& stats, T hash_obj, S shard_hash_obj, const std::function<void()>& interruption_point, size_t max_buffered)
+{
+    // Use one thread per cursor, if the cursors can be positioned at the start of a shard.
+    if (cursors.size() > 1 && cursors.front()->Seek(COutPoint{Txid{}, 0})) {
+        if (!ComputeUTXOStatsParallel<T, S>(cursors, stats, hash_obj, interruption_point, max_buffered)) return false;
+    } else {
+        if (!ApplyCoins(*cursors.front(), /*end=*/std::nullopt, stats, hash_obj, interruption_point)) return false;
+    }
 
     FinalizeHash(hash_obj, stats);
 
@@ -151,23 +331,35 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
     return true;
 }
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point)
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point, int num_threads, size_t max_buffered)
 {
-    CBlockIndex* pindex = WITH_LOCK(::cs_main, return blockman.LookupBlockIndex(view->GetBestBlock()));
+    CBlockIndex* pindex;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    {
+        // Database cursors iterate over a snapshot taken when they are created. Create all of them
+        // under cs_main, which is held while the coins database is written to, so that they see the
+        // same state as each other and as the best block looked up here.
+        LOCK(::cs_main);
+        pindex = blockman.LookupBlockIndex(view->GetBestBlock());
+        for (int i = 0; i < std::clamp(num_threads, 1, MAX_UTXO_STATS_THREADS); ++i) {
+            cursors.push_back(view->Cursor());
+            assert(cursors.back());
+        }
+    }
     CCoinsStats stats{Assert(pindex)->nHeight, pindex->GetBlockHash()};
 
     bool success = [&]() -> bool {
         switch (hash_type) {
         case(CoinStatsHashType::HASH_SERIALIZED): {
             HashWriter ss{};
-            return ComputeUTXOStats(view, stats, ss, interruption_point);
+            return ComputeUTXOStats(view, cursors, stats, ss, DataStream{}, interruption_point, max_buffered);
         }
         case(CoinStatsHashType::MUHASH): {
             MuHash3072 muhash;
-            return ComputeUTXOStats(view, stats, muhash, interruption_point);
+            return ComputeUTXOStats(view, cursors, stats, muhash, MuHash3072{}, interruption_point, max_buffered);
         }
         case(CoinStatsHashType::NONE): {
-            return ComputeUTXOStats(view, stats, nullptr, interruption_point);
+            return ComputeUTXOStats(view, cursors, stats, nullptr, nullptr, interruption_point, max_buffered);
         }
         } // no default case, so the compiler can warn about missing cases
         assert(false);
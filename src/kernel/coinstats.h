@@ -10,9 +10,12 @@
 #include <streams.h>
 #include <uint256.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <optional>
+#include <span>
+#include <utility>
 
 class CCoinsView;
 class Coin;
@@ -23,6 +26,11 @@ class BlockManager;
 } // namespace node
 
 namespace kernel {
+//! Maximum number of threads ComputeUTXOStats uses.
+static constexpr int MAX_UTXO_STATS_THREADS{16};
+//! Default number of bytes of computed shards ComputeUTXOStats keeps waiting to be hashed in order.
+static constexpr size_t DEFAULT_UTXO_STATS_MAX_BUFFERED{32 << 20};
+
 enum class CoinStatsHashType {
     HASH_SERIALIZED,
     MUHASH,
@@ -74,9 +82,21 @@ struct CCoinsStats {
 uint64_t GetBogoSize(const CScript& script_pub_key);
 
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
+//! Append the data hashed for the coins of one transaction with CoinStatsHashType::HASH_SERIALIZED
+//! to the stream. They are hashed in the order of their output index, so they are sorted first.
+void ApplyTxCoinsHash(DataStream& ss, std::span<std::pair<COutPoint, Coin>> coins);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
-std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
+/**
+ * Calculate statistics about the unspent transaction output set.
+ *
+ * @param[in] num_threads  Number of threads to read and hash the set on, up to MAX_UTXO_STATS_THREADS.
+ *                         Only views with cursors that can seek, such as CCoinsViewDB, use more than one.
+ * @param[in] max_buffered Bytes of shards computed ahead that may wait to be combined, for
+ *                         HASH_SERIALIZED mostly. Threads stop taking new shards beyond it, except
+ *                         the one to be combined next, so each can exceed it by one shard.
+ */
+std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {}, int num_threads = 1, size_t max_buffered = DEFAULT_UTXO_STATS_MAX_BUFFERED);
 } // namespace kernel
 
 #endif // BITCOIN_KERNEL_COINSTATS_H
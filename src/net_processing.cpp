@@ -195,6 +195,8 @@ static constexpr double MAX_ADDR_RATE_PER_SECOND{0.1};
 static constexpr size_t MAX_ADDR_PROCESSING_TOKEN_BUCKET{MAX_ADDR_TO_SEND};
 /** The compactblocks version we support. See BIP 152. */
 static constexpr uint64_t CMPCTBLOCKS_VERSION{2};
+/** Maximum number of orphans whose scripts are prechecked in one batch, see -orphanprecheck. */
+static constexpr size_t MAX_ORPHAN_PRECHECK_TXS{25};
 
 // Internal stuff
 namespace {
@@ -3118,6 +3120,15 @@ void PeerManagerImpl::ProcessPackageResult(const node::PackageToValidate& packag
 bool PeerManagerImpl::ProcessOrphanTx(Peer& peer)
 {
     AssertLockHeld(g_msgproc_mutex);
+
+    if (m_opts.orphan_precheck) {
+        // Verify the scripts of orphans newly added to this peer's work set as one parallel batch, so that
+        // accepting them one at a time below (and in later calls) mostly hits the signature cache. This
+        // does not hold cs_main while the scripts are being verified.
+        const auto txs{WITH_LOCK(m_tx_download_mutex, return m_txdownloadman.GetTxsToPrecheck(peer.m_id, MAX_ORPHAN_PRECHECK_TXS))};
+        if (txs.size() > 1) m_chainman.PrecheckTransactionScripts(txs);
+    }
+
     LOCK2(::cs_main, m_tx_download_mutex);
 
     CTransactionRef porphanTx = nullptr;
@@ -5922,7 +5933,7 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
             // If a snapshot chainstate is in use, we want to find its next blocks
             // before the background chainstate to prioritize getting to network tip.
             FindNextBlocksToDownload(*peer, get_inflight_budget(), vToDownload, staller);
-            if (m_chainman.BackgroundSyncInProgress() && !IsLimitedPeer(*peer)) {
+            if (m_chainman.BackgroundSyncInProgress() && !m_chainman.IsBackgroundSyncPaused() && !IsLimitedPeer(*peer)) {
                 // If the background tip is not an ancestor of the snapshot block,
                 // we need to start requesting blocks from their last common ancestor.
                 const CBlockIndex *from_tip = LastCommonAncestor(m_chainman.GetBackgroundSyncTip(), m_chainman.GetSnapshotBaseBlock());
@@ -31,13 +31,16 @@
 #include <util/batchpriority.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/fs_helpers.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
 #include <validation.h>
 
+#include <array>
 #include <cstddef>
 #include <map>
+#include <memory>
 #include <optional>
 #include <unordered_map>
 
@@ -47,6 +50,7 @@ static constexpr uint8_t DB_BLOCK_INDEX{'b'};
 static constexpr uint8_t DB_FLAG{'F'};
 static constexpr uint8_t DB_REINDEX_FLAG{'R'};
 static constexpr uint8_t DB_LAST_BLOCK{'l'};
+static constexpr uint8_t DB_INDEX_SNAPSHOT{'S'};
 // Keys used in previous version that might still be found in the DB:
 // BlockTreeDB::DB_TXINDEX_BLOCK{'T'};
 // BlockTreeDB::DB_TXINDEX{'t'}
@@ -86,9 +90,25 @@ bool BlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockFi
     for (const CBlockIndex* bi : blockinfo) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, bi->GetBlockHash()), CDiskBlockIndex{bi});
     }
+    // Any change to the block index invalidates a previously written snapshot.
+    batch.Erase(DB_INDEX_SNAPSHOT);
     return WriteBatch(batch, true);
 }
 
+bool BlockTreeDB::WriteIndexSnapshotChecksum(const uint256& checksum)
+{
+    return Write(DB_INDEX_SNAPSHOT, checksum, /*fSync=*/true);
+}
+
+std::optional<uint256> BlockTreeDB::ReadIndexSnapshotChecksum()
+{
+    uint256 checksum;
+    if (!Read(DB_INDEX_SNAPSHOT, checksum)) {
+        return std::nullopt;
+    }
+    return checksum;
+}
+
 bool BlockTreeDB::WriteFlag(const std::string& name, bool fValue)
 {
     return Write(std::make_pair(DB_FLAG, name), fValue ? uint8_t{'1'} : uint8_t{'0'});
@@ -104,6 +124,31 @@ bool BlockTreeDB::ReadFlag(const std::string& name, bool& fValue)
     return true;
 }
 
+//! Fill in the block index entry for `hash` from its on-disk representation.
+static CBlockIndex* PopulateBlockIndex(const CDiskBlockIndex& diskindex, const uint256& hash, const Consensus::Params& consensusParams, const std::function<CBlockIndex*(const uint256&)>& insertBlockIndex)
+{
+    // Construct block index object
+    CBlockIndex* pindexNew = insertBlockIndex(hash);
+    pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
+    pindexNew->nHeight        = diskindex.nHeight;
+    pindexNew->nFile          = diskindex.nFile;
+    pindexNew->nDataPos       = diskindex.nDataPos;
+    pindexNew->nUndoPos       = diskindex.nUndoPos;
+    pindexNew->nVersion       = diskindex.nVersion;
+    pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+    pindexNew->nTime          = diskindex.nTime;
+    pindexNew->nBits          = diskindex.nBits;
+    pindexNew->nNonce         = diskindex.nNonce;
+    pindexNew->nStatus        = diskindex.nStatus;
+    pindexNew->nTx            = diskindex.nTx;
+
+    if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams)) {
+        LogError("%s: CheckProofOfWork failed: %s\n", __func__, pindexNew->ToString());
+        return nullptr;
+    }
+    return pindexNew;
+}
+
 bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
 {
     AssertLockHeld(::cs_main);
@@ -117,23 +162,7 @@ bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, s
         if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
             CDiskBlockIndex diskindex;
             if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.ConstructBlockHash());
-                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
-                pindexNew->nHeight        = diskindex.nHeight;
-                pindexNew->nFile          = diskindex.nFile;
-                pindexNew->nDataPos       = diskindex.nDataPos;
-                pindexNew->nUndoPos       = diskindex.nUndoPos;
-                pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime          = diskindex.nTime;
-                pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nStatus        = diskindex.nStatus;
-                pindexNew->nTx            = diskindex.nTx;
-
-                if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams)) {
-                    LogError("%s: CheckProofOfWork failed: %s\n", __func__, pindexNew->ToString());
+                if (!PopulateBlockIndex(diskindex, diskindex.ConstructBlockHash(), consensusParams, insertBlockIndex)) {
                     return false;
                 }
 
@@ -152,6 +181,47 @@ bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, s
 } // namespace kernel
 
 namespace node {
+static constexpr std::array<uint8_t, 4> INDEX_SNAPSHOT_MAGIC{'b', 'i', 'd', 'x'};
+static constexpr uint8_t INDEX_SNAPSHOT_VERSION{1};
+
+/**
+ * Summarize the block index and block file state recorded in the block tree
+ * database. Every block index write (a new header, a block stored, a status
+ * change such as invalidateblock) and every block file change or prune alters
+ * it, so a block index snapshot can be checked against it even if the database
+ * was written by a version which does not know about snapshots.
+ */
+static uint256 BlockTreeFingerprint(BlockTreeDB& db)
+{
+    int last_file{0};
+    db.ReadLastBlockFile(last_file);
+    bool have_pruned{false};
+    db.ReadFlag("prunedblockfiles", have_pruned);
+    HashWriter hasher{};
+    hasher << last_file << have_pruned;
+    // Read the same files as LoadBlockIndexDB: all up to the last one, and any after it.
+    for (int file{0}; true; ++file) {
+        CBlockFileInfo info;
+        if (!db.ReadBlockFileInfo(file, info) && file > last_file) break;
+        hasher << info;
+    }
+    // Read the same entries as LoadBlockIndexGuts. This walks the database,
+    // but skips building the block tree from it, which is the slow part.
+    uint64_t entries{0};
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    for (pcursor->Seek(std::make_pair(kernel::DB_BLOCK_INDEX, uint256())); pcursor->Valid(); pcursor->Next()) {
+        std::pair<uint8_t, uint256> key;
+        CDiskBlockIndex diskindex;
+        if (!pcursor->GetKey(key) || key.first != kernel::DB_BLOCK_INDEX) break;
+        if (!pcursor->GetValue(diskindex)) {
+            throw std::ios_base::failure{"failed to read block index entry"};
+        }
+        hasher << key.second << diskindex;
+        ++entries;
+    }
+    hasher << entries;
+    return hasher.GetSHA256();
+}
 
 bool CBlockIndexWorkComparator::operator()(const CBlockIndex* pa, const CBlockIndex* pb) const
 {
@@ -395,13 +465,170 @@ CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
     return pindex;
 }
 
-bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
+fs::path BlockManager::GetBlockIndexSnapshotPath() const
+{
+    return m_opts.blocks_dir / "blockindex.snapshot";
+}
+
+bool BlockManager::WriteBlockIndexSnapshot()
+{
+    AssertLockHeld(::cs_main);
+    if (!m_opts.block_index_snapshot || !m_block_index_loaded) {
+        return true;
+    }
+    if (!m_dirty_blockindex.empty()) {
+        LogWarning("Not writing block index snapshot, %u entries have not been flushed\n", m_dirty_blockindex.size());
+        return false;
+    }
+
+    std::vector<CBlockIndex*> entries{GetAllBlockIndices()};
+    std::sort(entries.begin(), entries.end(), CBlockIndexHeightOnlyComparator());
+
+    const fs::path path{GetBlockIndexSnapshotPath()};
+    const fs::path path_tmp{path + ".new"};
+    AutoFile file{fsbridge::fopen(path_tmp, "wb")};
+    if (file.IsNull()) {
+        LogError("%s: Failed to open file %s\n", __func__, fs::PathToString(path_tmp));
+        return false;
+    }
+
+    uint256 checksum;
+    try {
+        HashedSourceWriter writer{file};
+        writer << INDEX_SNAPSHOT_MAGIC << INDEX_SNAPSHOT_VERSION << BlockTreeFingerprint(*m_block_tree_db) << uint64_t{entries.size()};
+        for (const CBlockIndex* pindex : entries) {
+            writer << pindex->GetBlockHash() << CDiskBlockIndex{pindex};
+        }
+        checksum = writer.GetHash();
+        file << checksum;
+    } catch (const std::exception& e) {
+        (void)file.fclose();
+        fs::remove(path_tmp);
+        LogError("%s: Serialize or I/O error - %s\n", __func__, e.what());
+        return false;
+    }
+    if (!file.Commit() || file.fclose() != 0) {
+        fs::remove(path_tmp);
+        LogError("%s: Failed to flush file %s\n", __func__, fs::PathToString(path_tmp));
+        return false;
+    }
+    if (!RenameOver(path_tmp, path)) {
+        fs::remove(path_tmp);
+        LogError("%s: Rename-into-place failed\n", __func__);
+        return false;
+    }
+    // Only tie the snapshot to the database once it is safely on disk.
+    if (!m_block_tree_db->WriteIndexSnapshotChecksum(checksum)) {
+        LogError("%s: Failed to record block index snapshot checksum\n", __func__);
+        return false;
+    }
+    LogInfo("Wrote block index snapshot with %u entries to %s\n", entries.size(), fs::PathToString(path));
+    return true;
+}
+
+bool BlockManager::LoadBlockIndexSnapshot(std::vector<CBlockIndex*>& sorted_by_height)
 {
-    if (!m_block_tree_db->LoadBlockIndexGuts(
-            GetConsensus(), [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, m_interrupt)) {
+    AssertLockHeld(cs_main);
+    const fs::path path{GetBlockIndexSnapshotPath()};
+    const std::optional<uint256> expected_checksum{m_block_tree_db->ReadIndexSnapshotChecksum()};
+    if (!expected_checksum) {
+        // Any leftover snapshot predates later database writes and is useless.
+        std::error_code ec;
+        fs::remove(path, ec);
+        return false;
+    }
+
+    std::vector<std::byte> data;
+    {
+        AutoFile file{fsbridge::fopen(path, "rb")};
+        std::error_code ec;
+        const auto file_size{fs::file_size(path, ec)};
+        if (file.IsNull() || ec) {
+            LogWarning("Block index snapshot %s could not be opened, falling back to the block tree database\n", fs::PathToString(path));
+            return false;
+        }
+        try {
+            data.resize(file_size);
+            file.read(data);
+        } catch (const std::exception& e) {
+            LogWarning("Failed to read block index snapshot: %s\n", e.what());
+            return false;
+        }
+    }
+    if (data.size() < uint256::size()) {
+        LogWarning("Block index snapshot %s is truncated, falling back to the block tree database\n", fs::PathToString(path));
         return false;
     }
 
+    const std::span<const std::byte> payload{std::span{data}.first(data.size() - uint256::size())};
+    uint256 stored_checksum;
+    SpanReader{std::span{data}.last(uint256::size())} >> stored_checksum;
+    HashWriter hasher{};
+    hasher.write(payload);
+    if (stored_checksum != *expected_checksum || hasher.GetHash() != *expected_checksum) {
+        LogWarning("Block index snapshot %s does not match the block tree database, falling back to it\n", fs::PathToString(path));
+        return false;
+    }
+
+    const auto insert{[this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }};
+    bool ok{true};
+    try {
+        SpanReader reader{payload};
+        std::array<uint8_t, 4> magic;
+        uint8_t version;
+        uint256 fingerprint;
+        uint64_t count;
+        reader >> magic >> version;
+        if (magic != INDEX_SNAPSHOT_MAGIC || version != INDEX_SNAPSHOT_VERSION) {
+            throw std::ios_base::failure{"unknown snapshot format"};
+        }
+        reader >> fingerprint >> count;
+        if (fingerprint != BlockTreeFingerprint(*m_block_tree_db)) {
+            throw std::ios_base::failure{"block tree database changed since the snapshot was written"};
+        }
+        sorted_by_height.reserve(count);
+        m_block_index.reserve(count);
+        for (uint64_t i{0}; i < count && !m_interrupt; ++i) {
+            uint256 hash;
+            CDiskBlockIndex diskindex;
+            reader >> hash >> diskindex;
+            CBlockIndex* pindex{kernel::PopulateBlockIndex(diskindex, hash, GetConsensus(), insert)};
+            if (!pindex) {
+                ok = false;
+                break;
+            }
+            sorted_by_height.push_back(pindex);
+        }
+        if (ok && !m_interrupt && !reader.empty()) {
+            throw std::ios_base::failure{"trailing data"};
+        }
+    } catch (const std::exception& e) {
+        LogWarning("Failed to deserialize block index snapshot: %s\n", e.what());
+        ok = false;
+    }
+    if (!ok || m_interrupt) {
+        sorted_by_height.clear();
+        m_block_index.clear();
+        return false;
+    }
+    LogInfo("Loaded %u block index entries from snapshot %s\n", sorted_by_height.size(), fs::PathToString(path));
+    return true;
+}
+
+bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
+{
+    std::vector<CBlockIndex*> vSortedByHeight;
+    if (!m_opts.block_index_snapshot || !m_block_index.empty() || !LoadBlockIndexSnapshot(vSortedByHeight)) {
+        if (m_interrupt) return false;
+        if (!m_block_tree_db->LoadBlockIndexGuts(
+                GetConsensus(), [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, m_interrupt)) {
+            return false;
+        }
+        vSortedByHeight = GetAllBlockIndices();
+        std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
+                  CBlockIndexHeightOnlyComparator());
+    }
+
     if (snapshot_blockhash) {
         const std::optional<AssumeutxoData> maybe_au_data = GetParams().AssumeutxoForBlockhash(*snapshot_blockhash);
         if (!maybe_au_data) {
@@ -427,10 +654,6 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
     Assert(m_snapshot_height.has_value() == snapshot_blockhash.has_value());
 
     // Calculate nChainWork
-    std::vector<CBlockIndex*> vSortedByHeight{GetAllBlockIndices()};
-    std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
-              CBlockIndexHeightOnlyComparator());
-
     CBlockIndex* previous_index{nullptr};
     for (CBlockIndex* pindex : vSortedByHeight) {
         if (m_interrupt) return false;
@@ -555,6 +778,7 @@ bool BlockManager::LoadBlockIndexDB(const std::optional<uint256>& snapshot_block
     m_block_tree_db->ReadReindexing(fReindexing);
     if (fReindexing) m_blockfiles_indexed = false;
 
+    m_block_index_loaded = true;
     return true;
 }
 
@@ -59,6 +59,10 @@ public:
     void ReadReindexing(bool& fReindexing);
     bool WriteFlag(const std::string& name, bool fValue);
     bool ReadFlag(const std::string& name, bool& fValue);
+    //! Record the checksum of a block index snapshot matching the current database contents.
+    bool WriteIndexSnapshotChecksum(const uint256& checksum);
+    //! Return the checksum of the block index snapshot, if one is valid for the current database contents.
+    std::optional<uint256> ReadIndexSnapshotChecksum();
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 };
@@ -151,6 +155,21 @@ private:
     bool LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /**
+     * Load the blocktree from the snapshot file written by
+     * WriteBlockIndexSnapshot() instead of iterating the block tree database.
+     * Only succeeds if the snapshot checksum matches the one recorded in the
+     * database, which is erased by any subsequent block index write, and the
+     * block index entries and block files in the database are still the ones
+     * the snapshot was taken of, in case a version without snapshot support
+     * wrote to it in between.
+     *
+     * @param[out] sorted_by_height  The loaded entries, ordered by height.
+     * @returns false if no valid snapshot was found, in which case m_block_index is left empty.
+     */
+    bool LoadBlockIndexSnapshot(std::vector<CBlockIndex*>& sorted_by_height)
+        EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     /** Return false if block file or undo file flushing fails. */
     [[nodiscard]] bool FlushBlockFile(int blockfile_num, bool fFinalize, bool finalize_undo);
 
@@ -243,6 +262,9 @@ private:
     /** Dirty block file entries. */
     std::set<int> m_dirty_fileinfo;
 
+    /** Whether LoadBlockIndexDB() completed, so m_block_index mirrors the block tree database. */
+    bool m_block_index_loaded GUARDED_BY(::cs_main){false};
+
     /**
      * Map from external index name to oldest block that must not be pruned.
      *
@@ -301,6 +323,16 @@ public:
     std::unique_ptr<BlockTreeDB> m_block_tree_db GUARDED_BY(::cs_main);
 
     bool WriteBlockIndexDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /**
+     * Write the in-memory block index to a flat snapshot file, so that the next
+     * startup can skip iterating the block tree database. A no-op unless
+     * enabled through BlockManagerOpts. All block index entries must have been
+     * flushed to the database already, typically at shutdown.
+     */
+    bool WriteBlockIndexSnapshot() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    fs::path GetBlockIndexSnapshotPath() const;
+
     bool LoadBlockIndexDB(const std::optional<uint256>& snapshot_blockhash)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
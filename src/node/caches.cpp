@@ -5,7 +5,9 @@
 #include <node/caches.h>
 
 #include <common/args.h>
+#include <index/scriptindex.h>
 #include <index/txindex.h>
+#include <index/txospenderindex.h>
 #include <kernel/caches.h>
 #include <logging.h>
 #include <util/byte_units.h>
@@ -17,6 +19,10 @@
 // a meaningful difference: https://github.com/bitcoin/bitcoin/pull/8273#issuecomment-229601991
 //! Max memory allocated to tx index DB specific cache in bytes.
 static constexpr size_t MAX_TX_INDEX_CACHE{1024_MiB};
+//! Max memory allocated to script index DB specific cache in bytes.
+static constexpr size_t MAX_SCRIPT_INDEX_CACHE{1024_MiB};
+//! Max memory allocated to transaction output spender index DB specific cache in bytes.
+static constexpr size_t MAX_TXOSPENDER_INDEX_CACHE{1024_MiB};
 //! Max memory allocated to all block filter index caches combined in bytes.
 static constexpr size_t MAX_FILTER_INDEX_CACHE{1024_MiB};
 //! Maximum dbcache size on 32-bit systems.
@@ -37,6 +43,10 @@ CacheSizes CalculateCacheSizes(const ArgsManager& args, size_t n_indexes)
     IndexCacheSizes index_sizes;
     index_sizes.tx_index = std::min(total_cache / 8, args.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? MAX_TX_INDEX_CACHE : 0);
     total_cache -= index_sizes.tx_index;
+    index_sizes.script_index = std::min(total_cache / 8, args.GetBoolArg("-scriptindex", DEFAULT_SCRIPTINDEX) ? MAX_SCRIPT_INDEX_CACHE : 0);
+    total_cache -= index_sizes.script_index;
+    index_sizes.txospender_index = std::min(total_cache / 8, args.GetBoolArg("-txospenderindex", DEFAULT_TXOSPENDERINDEX) ? MAX_TXOSPENDER_INDEX_CACHE : 0);
+    total_cache -= index_sizes.txospender_index;
     if (n_indexes > 0) {
         size_t max_cache = std::min(total_cache / 8, MAX_FILTER_INDEX_CACHE);
         index_sizes.filter_index = max_cache / n_indexes;
@@ -59,6 +59,20 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
     // Subtract 1 because the main thread counts towards the par threads.
     opts.worker_threads_num = script_threads - 1;
 
+    if (auto value{args.GetIntArg("-backgroundpar")}) {
+        // Same interpretation as -par.
+        int64_t background_threads{*value};
+        if (background_threads <= 0) background_threads += GetNumCores();
+        opts.background_worker_threads_num = std::clamp<int64_t>(background_threads - 1, 0, MAX_SCRIPTCHECK_THREADS);
+    }
+
+    if (auto value{args.GetIntArg("-backgroundcache")}) {
+        if (*value < 1 || *value > 99) {
+            return util::Error{Untranslated(strprintf("Invalid -backgroundcache=%d, must be between 1 and 99", *value))};
+        }
+        opts.background_cache_percent = *value;
+    }
+
     if (auto max_size = args.GetIntArg("-maxsigcachesize")) {
         // 1. When supplied with a max_size of 0, both the signature cache and
         //    script execution cache create the minimum possible cache (2
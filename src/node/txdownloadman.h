@@ -165,6 +165,10 @@ public:
     /** Returns next orphan tx to consider, or nullptr if none exist. */
     CTransactionRef GetTxToReconsider(NodeId nodeid);
 
+    /** Returns up to max_count orphans added to this peer's work set and not returned by this function yet,
+     *  without removing them from it. */
+    std::vector<CTransactionRef> GetTxsToPrecheck(NodeId nodeid, size_t max_count);
+
     /** Check that all data structures are empty. */
     void CheckIsEmpty() const;
 
@@ -75,6 +75,10 @@ CTransactionRef TxDownloadManager::GetTxToReconsider(NodeId nodeid)
 {
     return m_impl->GetTxToReconsider(nodeid);
 }
+std::vector<CTransactionRef> TxDownloadManager::GetTxsToPrecheck(NodeId nodeid, size_t max_count)
+{
+    return m_impl->GetTxsToPrecheck(nodeid, max_count);
+}
 void TxDownloadManager::CheckIsEmpty() const
 {
     m_impl->CheckIsEmpty();
@@ -575,6 +579,11 @@ CTransactionRef TxDownloadManagerImpl::GetTxToReconsider(NodeId nodeid)
     return m_orphanage.GetTxToReconsider(nodeid);
 }
 
+std::vector<CTransactionRef> TxDownloadManagerImpl::GetTxsToPrecheck(NodeId nodeid, size_t max_count)
+{
+    return m_orphanage.GetTxsToPrecheck(nodeid, max_count);
+}
+
 void TxDownloadManagerImpl::CheckIsEmpty(NodeId nodeid)
 {
     assert(m_txrequest.Count(nodeid) == 0);
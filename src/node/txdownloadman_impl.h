@@ -184,6 +184,7 @@ public:
 
     bool HaveMoreWork(NodeId nodeid);
     CTransactionRef GetTxToReconsider(NodeId nodeid);
+    std::vector<CTransactionRef> GetTxsToPrecheck(NodeId nodeid, size_t max_count);
 
     void CheckIsEmpty();
     void CheckIsEmpty(NodeId nodeid);
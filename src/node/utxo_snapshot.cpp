@@ -20,6 +20,20 @@
 
 namespace node {
 
+Txid SnapshotChunkStart(uint32_t chunk)
+{
+    uint256 start;
+    start.begin()[0] = chunk >> 4;
+    start.begin()[1] = (chunk & 0xf) << 4;
+    return Txid::FromUint256(start);
+}
+
+uint32_t SnapshotChunkOf(const Txid& txid)
+{
+    const unsigned char* begin{UCharCast(txid.begin())};
+    return (uint32_t{begin[0]} << 4) | (begin[1] >> 4);
+}
+
 bool WriteSnapshotBaseBlockhash(Chainstate& snapshot_chainstate)
 {
     AssertLockHeld(::cs_main);
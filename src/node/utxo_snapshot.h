@@ -9,6 +9,7 @@
 #include <chainparams.h>
 #include <kernel/chainparams.h>
 #include <kernel/cs_main.h>
+#include <primitives/transaction.h>
 #include <serialize.h>
 #include <sync.h>
 #include <uint256.h>
@@ -23,6 +24,13 @@
 // UTXO set snapshot magic bytes
 static constexpr std::array<uint8_t, 5> SNAPSHOT_MAGIC_BYTES = {'u', 't', 'x', 'o', 0xff};
 
+//! Number of chunks a chunked snapshot is written in. Chunk i holds the coins
+//! whose txids start with the 12-bit prefix i, in the same order as in the
+//! coins database.
+static constexpr uint32_t SNAPSHOT_CHUNKS{4096};
+//! Largest chunk a chunked snapshot may contain, to bound memory when loading it.
+static constexpr uint64_t MAX_SNAPSHOT_CHUNK_SIZE{256 << 20};
+
 class Chainstate;
 
 namespace node {
@@ -32,10 +40,17 @@ namespace node {
 //! before being used. Thus, new fields should be added only if needed.
 class SnapshotMetadata
 {
+public:
     inline static const uint16_t VERSION{2};
-    const std::set<uint16_t> m_supported_versions{VERSION};
+    //! Version in which the coins are stored in SNAPSHOT_CHUNKS separately
+    //! checksummed chunks, each preceded by a SnapshotChunkHeader.
+    inline static const uint16_t CHUNKED_VERSION{3};
+private:
+    const std::set<uint16_t> m_supported_versions{VERSION, CHUNKED_VERSION};
     const MessageStartChars m_network_magic;
 public:
+    uint16_t m_version{VERSION};
+
     //! The hash of the block that reflects the tip of the chain for the
     //! UTXO set contained in this snapshot.
     uint256 m_base_blockhash;
@@ -45,6 +60,9 @@ public:
     //! during snapshot load to estimate progress of UTXO set reconstruction.
     uint64_t m_coins_count = 0;
 
+    //! The number of chunks the coins are stored in. Only serialized for chunked snapshots.
+    uint32_t m_chunk_count = 0;
+
     SnapshotMetadata(
         const MessageStartChars network_magic) :
             m_network_magic(network_magic) { }
@@ -56,13 +74,16 @@ public:
             m_base_blockhash(base_blockhash),
             m_coins_count(coins_count) { }
 
+    bool IsChunked() const { return m_version >= CHUNKED_VERSION; }
+
     template <typename Stream>
     inline void Serialize(Stream& s) const {
         s << SNAPSHOT_MAGIC_BYTES;
-        s << VERSION;
+        s << m_version;
         s << m_network_magic;
         s << m_base_blockhash;
         s << m_coins_count;
+        if (IsChunked()) s << m_chunk_count;
     }
 
     template <typename Stream>
@@ -75,10 +96,9 @@ public:
         }
 
         // Read the version
-        uint16_t version;
-        s >> version;
-        if (m_supported_versions.find(version) == m_supported_versions.end()) {
-            throw std::ios_base::failure(strprintf("Version of snapshot %s does not match any of the supported versions.", version));
+        s >> m_version;
+        if (m_supported_versions.find(m_version) == m_supported_versions.end()) {
+            throw std::ios_base::failure(strprintf("Version of snapshot %s does not match any of the supported versions.", m_version));
         }
 
         // Read the network magic (pchMessageStart)
@@ -98,9 +118,28 @@ public:
 
         s >> m_base_blockhash;
         s >> m_coins_count;
+        if (IsChunked()) s >> m_chunk_count;
     }
 };
 
+//! Precedes the coins of each chunk in a chunked snapshot.
+struct SnapshotChunkHeader {
+    //! Number of coins in the chunk.
+    uint64_t coins_count{0};
+    //! Size of the serialized coins in bytes.
+    uint64_t size{0};
+    //! Double SHA256 of the serialized coins.
+    uint256 hash;
+
+    SERIALIZE_METHODS(SnapshotChunkHeader, obj) { READWRITE(obj.coins_count, obj.size, obj.hash); }
+};
+
+//! First possible txid in the given chunk of a chunked snapshot.
+Txid SnapshotChunkStart(uint32_t chunk);
+
+//! The chunk of a chunked snapshot that coins of the given transaction belong to.
+uint32_t SnapshotChunkOf(const Txid& txid);
+
 //! The file in the snapshot chainstate dir which stores the base blockhash. This is
 //! needed to reconstruct snapshot chainstates on init.
 //!
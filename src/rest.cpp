@@ -15,15 +15,23 @@
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
+#include <index/txospenderindex.h>
+#include <kernel/chain.h>
+#include <kernel/mempool_entry.h>
+#include <kernel/mempool_removal_reason.h>
+#include <logging.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <rpc/blockchain.h>
+#include <rpc/jsonstream.h>
 #include <rpc/mempool.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
+#include <script/script.h>
+#include <script/solver.h>
 #include <streams.h>
 #include <sync.h>
 #include <txmempool.h>
@@ -31,9 +39,18 @@
 #include <util/any.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/time.h>
+#include <util/translation.h>
 #include <validation.h>
+#include <validationinterface.h>
 
 #include <any>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <list>
+#include <span>
+#include <string_view>
 #include <vector>
 
 #include <univalue.h>
@@ -43,7 +60,19 @@ using node::NodeContext;
 using util::SplitString;
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
+static constexpr size_t MAX_TXOSPENDERS_OUTPOINTS{10000};
 static constexpr unsigned int MAX_REST_HEADERS_RESULTS = 2000;
+static constexpr size_t MAX_REST_BLOCKS_RESULTS{1000};
+static constexpr size_t MAX_REST_TXS{1000};
+//! Maximum number of clients subscribed to /rest/events at once.
+static constexpr size_t MAX_REST_EVENT_SUBSCRIBERS{100};
+//! Bytes of events that may be waiting to be sent to a subscriber. Further
+//! events are dropped for it until it catches up.
+static constexpr size_t MAX_REST_EVENT_PENDING{4 << 20};
+//! Memory used by the recent events kept to be replayed to subscribers that reconnect.
+static constexpr size_t MAX_REST_EVENT_HISTORY{16 << 20};
+//! Interval of the comments that keep idle event streams open.
+static constexpr std::chrono::seconds REST_EVENT_KEEPALIVE{15};
 
 static const struct {
     RESTResponseFormat rf;
@@ -76,6 +105,56 @@ static bool RESTERR(HTTPRequest* req, enum HTTPStatusCode status, std::string me
     return false;
 }
 
+/** Reply with the JSON document produced by `write`, sent in chunks as it is written if it gets large. */
+static void WriteJSONReply(HTTPRequest* req, const std::function<void(JSONStreamWriter&)>& write)
+{
+    JSONStreamWriter stream{[req](std::string_view data) {
+        if (!req->IsChunkedReplyStarted()) {
+            req->WriteHeader("Content-Type", "application/json");
+            req->StartChunkedReply(HTTP_OK);
+        }
+        return req->WriteReplyChunk(data);
+    }};
+    write(stream);
+    const std::string tail{stream.TakeBuffer() + "\n"};
+    if (stream.Flushed()) {
+        // A reply that could not be written completely must not look complete.
+        if (stream.Failed() || !req->WriteReplyChunk(tail)) {
+            req->AbortChunkedReply();
+        } else {
+            req->EndChunkedReply();
+        }
+    } else {
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, tail);
+    }
+}
+
+/**
+ * Send a part of a bin or hex reply, which is sent in chunks as it is produced.
+ *
+ * @returns false if the client went away.
+ */
+static bool WriteBinaryChunk(HTTPRequest* req, RESTResponseFormat rf, std::span<const std::byte> data)
+{
+    if (!req->IsChunkedReplyStarted()) {
+        req->WriteHeader("Content-Type", rf == RESTResponseFormat::BINARY ? "application/octet-stream" : "text/plain");
+        req->StartChunkedReply(HTTP_OK);
+    }
+    if (rf == RESTResponseFormat::BINARY) return req->WriteReplyChunk(data);
+    return req->WriteReplyChunk(HexStr(data));
+}
+
+/** Finish a reply started by WriteBinaryChunk. */
+static void EndBinaryReply(HTTPRequest* req, RESTResponseFormat rf)
+{
+    if (rf == RESTResponseFormat::HEX && !req->WriteReplyChunk("\n")) {
+        req->AbortChunkedReply();
+        return;
+    }
+    req->EndChunkedReply();
+}
+
 /**
  * Get the node context.
  *
@@ -434,25 +513,24 @@ static bool rest_block(const std::any& context,
     switch (rf) {
     case RESTResponseFormat::BINARY: {
         req->WriteHeader("Content-Type", "application/octet-stream");
-        req->WriteReply(HTTP_OK, block_data);
+        req->WriteReply(HTTP_OK, std::move(block_data));
         return true;
     }
 
     case RESTResponseFormat::HEX: {
-        const std::string strHex{HexStr(block_data) + "\n"};
+        std::string strHex(block_data.size() * 2 + 1, '\n');
+        HexEncode(block_data, std::span{strHex}.first(block_data.size() * 2));
         req->WriteHeader("Content-Type", "text/plain");
-        req->WriteReply(HTTP_OK, strHex);
+        req->WriteReply(HTTP_OK, std::move(strHex));
         return true;
     }
 
     case RESTResponseFormat::JSON: {
         CBlock block{};
-        DataStream block_stream{block_data};
-        block_stream >> TX_WITH_WITNESS(block);
-        UniValue objBlock = blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
-        std::string strJSON = objBlock.write() + "\n";
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        SpanReader{block_data} >> TX_WITH_WITNESS(block);
+        WriteJSONReply(req, [&](JSONStreamWriter& stream) {
+            blockToJSON(stream, chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+        });
         return true;
     }
 
@@ -462,6 +540,84 @@ static bool rest_block(const std::any& context,
     }
 }
 
+static bool rest_blocks(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string height_str;
+    const RESTResponseFormat rf = ParseDataFormat(height_str, uri_part);
+    if (rf != RESTResponseFormat::BINARY && rf != RESTResponseFormat::HEX) {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: bin, hex)");
+    }
+
+    const auto start_height{ToIntegral<int32_t>(height_str)};
+    if (!start_height || *start_height < 0) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height: " + SanitizeString(height_str, SAFE_CHARS_URI));
+    }
+
+    std::string raw_count;
+    std::string raw_undo;
+    try {
+        raw_count = req->GetQueryParameter("count").value_or("1");
+        raw_undo = req->GetQueryParameter("undo").value_or("false");
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+    const auto count{ToIntegral<size_t>(raw_count)};
+    if (!count || *count < 1 || *count > MAX_REST_BLOCKS_RESULTS) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Block count is invalid or out of acceptable range (1-%u): %s", MAX_REST_BLOCKS_RESULTS, raw_count));
+    }
+    if (raw_undo != "true" && raw_undo != "false") {
+        return RESTERR(req, HTTP_BAD_REQUEST, "The \"undo\" query parameter must be true or false.");
+    }
+    const bool with_undo{raw_undo == "true"};
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+    ChainstateManager& chainman = *maybe_chainman;
+    std::vector<const CBlockIndex*> blocks;
+    {
+        LOCK(cs_main);
+        const CChain& active_chain = chainman.ActiveChain();
+        if (*start_height > active_chain.Height()) {
+            return RESTERR(req, HTTP_NOT_FOUND, "Block height out of range");
+        }
+        for (const CBlockIndex* pindex{active_chain[*start_height]}; pindex && blocks.size() < *count; pindex = active_chain.Next(pindex)) {
+            if (!(pindex->nStatus & BLOCK_HAVE_DATA) || (with_undo && pindex->nHeight > 0 && !(pindex->nStatus & BLOCK_HAVE_UNDO))) {
+                if (chainman.m_blockman.IsBlockPruned(*pindex)) {
+                    return RESTERR(req, HTTP_NOT_FOUND, pindex->GetBlockHash().GetHex() + " not available (pruned data)");
+                }
+                return RESTERR(req, HTTP_NOT_FOUND, pindex->GetBlockHash().GetHex() + " not available (not fully downloaded)");
+            }
+            blocks.push_back(pindex);
+        }
+    }
+
+    // Blocks are sent as they are read from disk, so if one cannot be read
+    // after the reply was started, the connection is closed without finishing
+    // the reply.
+    std::vector<std::byte> block_data;
+    DataStream undo_stream;
+    for (const CBlockIndex* pindex : blocks) {
+        const FlatFilePos pos{WITH_LOCK(cs_main, return pindex->GetBlockPos())};
+        bool read{chainman.m_blockman.ReadRawBlock(block_data, pos)};
+        if (read && with_undo) {
+            CBlockUndo block_undo;
+            read = pindex->nHeight == 0 || chainman.m_blockman.ReadBlockUndo(block_undo, *pindex);
+            undo_stream.clear();
+            SerializeBlockUndo(undo_stream, block_undo);
+        }
+        if (!read && !req->IsChunkedReplyStarted()) {
+            return RESTERR(req, HTTP_NOT_FOUND, pindex->GetBlockHash().GetHex() + " not found");
+        }
+        if (!read || !WriteBinaryChunk(req, rf, block_data) || (with_undo && !WriteBinaryChunk(req, rf, undo_stream))) {
+            req->AbortChunkedReply();
+            return false;
+        }
+    }
+    EndBinaryReply(req, rf);
+    return true;
+}
+
 static bool rest_block_extended(const std::any& context, HTTPRequest* req, const std::string& uri_part)
 {
     return rest_block(context, req, uri_part, TxVerbosity::SHOW_DETAILS_AND_PREVOUT);
@@ -795,6 +951,10 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
             if (verbose && mempool_sequence) {
                 return RESTERR(req, HTTP_BAD_REQUEST, "Verbose results cannot contain mempool sequence values. (hint: set \"verbose=false\")");
             }
+            if (verbose) {
+                WriteJSONReply(req, [&](JSONStreamWriter& stream) { MempoolToJSON(stream, *mempool); });
+                return true;
+            }
             str_json = MempoolToJSON(*mempool, verbose, mempool_sequence).write() + "\n";
         } else {
             str_json = MempoolInfoToJSON(*mempool).write() + "\n";
@@ -869,6 +1029,124 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
     }
 }
 
+static bool rest_txs(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, uri_part);
+
+    if (!g_txindex) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Transaction index is not enabled (start the node with -txindex)");
+    }
+
+    // Txids are sent over the URI (/rest/txs/txid1/txid2/...) or, for larger
+    // batches, as a serialized vector in the body of a bin or hex request.
+    std::vector<Txid> txids;
+    if (param.length() > 1) {
+        for (const std::string& part : SplitString(param.substr(1), '/')) {
+            auto txid{Txid::FromHex(part)};
+            if (!txid) {
+                return RESTERR(req, HTTP_BAD_REQUEST, "Parse error");
+            }
+            txids.push_back(*txid);
+        }
+    }
+
+    std::string body{req->ReadBody()};
+    if (!body.empty()) {
+        if (!txids.empty()) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Combination of URI scheme inputs and raw post data is not allowed");
+        }
+        if (rf == RESTResponseFormat::HEX) {
+            if (!IsHex(body)) return RESTERR(req, HTTP_BAD_REQUEST, "Parse error");
+            const std::vector<unsigned char> data{ParseHex(body)};
+            body.assign(data.begin(), data.end());
+        } else if (rf != RESTResponseFormat::BINARY) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Raw post data is only allowed for bin and hex requests");
+        }
+        try {
+            SpanReader{MakeUCharSpan(body)} >> txids;
+        } catch (const std::ios_base::failure&) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Parse error");
+        }
+    }
+
+    if (txids.empty()) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Error: empty request");
+    }
+    if (txids.size() > MAX_REST_TXS) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Error: max txids exceeded (max: %d, tried: %d)", MAX_REST_TXS, txids.size()));
+    }
+
+    const NodeContext* const node = GetNodeContext(context, req);
+    if (!node) return false;
+    g_txindex->BlockUntilSyncedToCurrentChain();
+    std::vector<CTransactionRef> txs;
+    std::vector<uint256> block_hashes;
+    txs.reserve(txids.size());
+    block_hashes.reserve(txids.size());
+    for (const Txid& txid : txids) {
+        uint256 block_hash{};
+        txs.push_back(GetTransaction(/*block_index=*/nullptr, node->mempool.get(), txid.ToUint256(), block_hash, node->chainman->m_blockman));
+        block_hashes.push_back(block_hash);
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::BINARY:
+    case RESTResponseFormat::HEX: {
+        // A bitmap of found transactions, followed by those, as in /rest/getutxos/.
+        // The transactions are sent one at a time.
+        std::vector<unsigned char> bitmap((txs.size() + 7) / 8);
+        size_t found{0};
+        for (size_t i = 0; i < txs.size(); ++i) {
+            if (!txs[i]) continue;
+            bitmap[i / 8] |= 1 << (i % 8);
+            ++found;
+        }
+        // The transactions were all read before the reply is started, so it
+        // can only fail to be sent. Like in rest_blocks, the connection is
+        // then closed without finishing the reply.
+        DataStream ss_tx{};
+        ss_tx << bitmap;
+        WriteCompactSize(ss_tx, found);
+        if (!WriteBinaryChunk(req, rf, ss_tx)) {
+            req->AbortChunkedReply();
+            return false;
+        }
+        for (const CTransactionRef& tx : txs) {
+            if (!tx) continue;
+            ss_tx.clear();
+            ss_tx << TX_WITH_WITNESS(tx);
+            if (!WriteBinaryChunk(req, rf, ss_tx)) {
+                req->AbortChunkedReply();
+                return false;
+            }
+        }
+        EndBinaryReply(req, rf);
+        return true;
+    }
+    case RESTResponseFormat::JSON: {
+        WriteJSONReply(req, [&](JSONStreamWriter& stream) {
+            stream.BeginArray();
+            for (size_t i = 0; i < txs.size(); ++i) {
+                if (!txs[i]) {
+                    stream.Value(NullUniValue);
+                    continue;
+                }
+                UniValue tx_json(UniValue::VOBJ);
+                TxToUniv(*txs[i], /*block_hash=*/block_hashes[i], /*entry=*/tx_json);
+                stream.Value(tx_json);
+            }
+            stream.EndArray();
+        });
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+}
+
 static bool rest_getutxos(const std::any& context, HTTPRequest* req, const std::string& uri_part)
 {
     if (!CheckWarmup(req))
@@ -1063,6 +1341,111 @@ static bool rest_getutxos(const std::any& context, HTTPRequest* req, const std::
     }
 }
 
+static bool rest_txospenders(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, uri_part);
+
+    if (!g_txospender_index) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Transaction output spender index is not enabled (start the node with -txospenderindex)");
+    }
+
+    // Outpoints are sent over the URI (/rest/txospenders/txid1-n/txid2-n/...) or,
+    // for larger batches, as a serialized vector in the body of a bin or hex request.
+    std::vector<COutPoint> outpoints;
+    if (param.length() > 1) {
+        for (const std::string& part : SplitString(param.substr(1), '/')) {
+            const auto txid_out{util::Split<std::string_view>(part, '-')};
+            if (txid_out.size() != 2) {
+                return RESTERR(req, HTTP_BAD_REQUEST, "Parse error");
+            }
+            auto txid{Txid::FromHex(txid_out.at(0))};
+            auto output{ToIntegral<uint32_t>(txid_out.at(1))};
+            if (!txid || !output) {
+                return RESTERR(req, HTTP_BAD_REQUEST, "Parse error");
+            }
+            outpoints.emplace_back(*txid, *output);
+        }
+    }
+
+    std::string body{req->ReadBody()};
+    if (!body.empty()) {
+        if (!outpoints.empty()) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Combination of URI scheme inputs and raw post data is not allowed");
+        }
+        if (rf == RESTResponseFormat::HEX) {
+            if (!IsHex(body)) return RESTERR(req, HTTP_BAD_REQUEST, "Parse error");
+            const std::vector<unsigned char> data{ParseHex(body)};
+            body.assign(data.begin(), data.end());
+        } else if (rf != RESTResponseFormat::BINARY) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Raw post data is only allowed for bin and hex requests");
+        }
+        try {
+            SpanReader{MakeUCharSpan(body)} >> outpoints;
+        } catch (const std::ios_base::failure&) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Parse error");
+        }
+    }
+
+    if (outpoints.empty()) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Error: empty request");
+    }
+    if (outpoints.size() > MAX_TXOSPENDERS_OUTPOINTS) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Error: max outpoints exceeded (max: %d, tried: %d)", MAX_TXOSPENDERS_OUTPOINTS, outpoints.size()));
+    }
+
+    if (!g_txospender_index->BlockUntilSyncedToCurrentChain()) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Transaction output spender index is still syncing");
+    }
+    const std::vector<std::optional<TxoSpender>> spenders{g_txospender_index->FindSpenders(outpoints)};
+
+    switch (rf) {
+    case RESTResponseFormat::BINARY:
+    case RESTResponseFormat::HEX: {
+        // A bitmap of spent outputs, followed by the spenders of those, as in /rest/getutxos/.
+        std::vector<unsigned char> bitmap((spenders.size() + 7) / 8);
+        std::vector<TxoSpender> found;
+        for (size_t i = 0; i < spenders.size(); ++i) {
+            if (!spenders[i]) continue;
+            bitmap[i / 8] |= 1 << (i % 8);
+            found.push_back(*spenders[i]);
+        }
+        DataStream ss_spenders{};
+        ss_spenders << bitmap << found;
+        if (rf == RESTResponseFormat::BINARY) {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            req->WriteReply(HTTP_OK, ss_spenders);
+        } else {
+            req->WriteHeader("Content-Type", "text/plain");
+            req->WriteReply(HTTP_OK, HexStr(ss_spenders) + "\n");
+        }
+        return true;
+    }
+    case RESTResponseFormat::JSON: {
+        UniValue result(UniValue::VARR);
+        for (size_t i = 0; i < outpoints.size(); ++i) {
+            UniValue o(UniValue::VOBJ);
+            o.pushKV("txid", outpoints[i].hash.ToString());
+            o.pushKV("vout", (uint64_t)outpoints[i].n);
+            if (const auto& spender{spenders[i]}) {
+                o.pushKV("spendingtxid", spender->txid.ToString());
+                o.pushKV("spendingvin", spender->vin);
+                o.pushKV("blockhash", spender->block_hash.GetHex());
+                o.pushKV("height", spender->height);
+            }
+            result.push_back(std::move(o));
+        }
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, result.write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+}
+
 static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
                        const std::string& str_uri_part)
 {
@@ -1113,6 +1496,357 @@ static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
     }
 }
 
+static bool rest_script_history(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string script_hex;
+    const RESTResponseFormat rf = ParseDataFormat(script_hex, uri_part);
+
+    if (!IsHex(script_hex)) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid scriptPubKey: " + SanitizeString(script_hex, SAFE_CHARS_URI));
+    }
+    const std::vector<unsigned char> script_data{ParseHex(script_hex)};
+
+    std::string raw_start_height;
+    std::string raw_limit;
+    try {
+        raw_start_height = req->GetQueryParameter("start_height").value_or("0");
+        raw_limit = req->GetQueryParameter("limit").value_or(util::ToString(DEFAULT_SCRIPT_HISTORY_LIMIT));
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+    const auto start_height{ToIntegral<int32_t>(raw_start_height)};
+    const auto limit{ToIntegral<int32_t>(raw_limit)};
+    if (!start_height || !limit) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "The \"start_height\" and \"limit\" query parameters must be integers.");
+    }
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        UniValue history;
+        try {
+            history = ScriptHistoryToJSON(*maybe_chainman, {CScript(script_data.begin(), script_data.end())}, *start_height, *limit);
+        } catch (const UniValue& error) {
+            return RESTERR(req, error.find_value("code").getInt<int>() == RPC_INVALID_PARAMETER ? HTTP_BAD_REQUEST : HTTP_SERVICE_UNAVAILABLE,
+                           error.find_value("message").get_str());
+        }
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, history.write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
+bool RESTEventFilter::Matches(const CTransaction& tx) const
+{
+    if (scripts.empty() && output_types.empty()) return true;
+    std::vector<std::vector<unsigned char>> solutions;
+    for (const CTxOut& txout : tx.vout) {
+        if (scripts.contains(txout.scriptPubKey)) return true;
+        if (!output_types.empty() && output_types.contains(Solver(txout.scriptPubKey, solutions))) return true;
+    }
+    return false;
+}
+
+util::Result<RESTEventFilter> ParseRESTEventFilter(const std::optional<std::string>& types,
+                                                   const std::optional<std::string>& scripts,
+                                                   const std::optional<std::string>& output_types)
+{
+    RESTEventFilter filter;
+    if (types) {
+        for (const std::string& type : SplitString(*types, ',')) {
+            if (std::ranges::find(REST_EVENT_TYPES, type) == REST_EVENT_TYPES.end()) {
+                return util::Error{Untranslated(strprintf("Unknown event type: %s", type))};
+            }
+            filter.types.insert(type);
+        }
+    }
+    if (scripts) {
+        for (const std::string& script : SplitString(*scripts, ',')) {
+            if (script.empty() || !IsHex(script)) {
+                return util::Error{Untranslated(strprintf("Invalid script: %s", script))};
+            }
+            const std::vector<unsigned char> data{ParseHex(script)};
+            filter.scripts.emplace(data.begin(), data.end());
+        }
+    }
+    if (output_types) {
+        for (const std::string& name : SplitString(*output_types, ',')) {
+            std::optional<TxoutType> output_type;
+            for (int i{0}; i <= static_cast<int>(TxoutType::WITNESS_UNKNOWN); ++i) {
+                if (GetTxnOutputType(static_cast<TxoutType>(i)) == name) output_type = static_cast<TxoutType>(i);
+            }
+            if (!output_type) {
+                return util::Error{Untranslated(strprintf("Unknown output type: %s", name))};
+            }
+            filter.output_types.insert(*output_type);
+        }
+    }
+    return filter;
+}
+
+namespace {
+/** An event sent by /rest/events. */
+struct RESTEvent {
+    uint64_t sequence;
+    std::string_view type;
+    //! Transaction of tx_added and tx_removed events, to filter them.
+    CTransactionRef tx;
+    //! The event in the text/event-stream format.
+    std::string text;
+
+    size_t Usage() const { return sizeof(*this) + text.size() + (tx ? tx->GetTotalSize() : 0); }
+};
+
+/**
+ * Sends validation events to the subscribers of /rest/events as server-sent
+ * events, and keeps the recent ones to replay them to subscribers that
+ * reconnect. Each event has a sequence number, one more than the one before,
+ * as its SSE id. Events that a subscriber misses, because it did not keep up
+ * or they are no longer kept, are reported to it with a "gap" event before
+ * the next one it gets.
+ *
+ * Events are written without waiting for subscribers, from the thread that
+ * delivers validation events, and no worker thread is held while a stream
+ * is open. Validation events are only delivered to it once the first
+ * subscriber connected, so that a node nobody listens to does not format
+ * and keep them.
+ */
+class RESTEventPublisher final : public CValidationInterface
+{
+    struct Subscriber {
+        std::unique_ptr<HTTPRequest> req;
+        RESTEventFilter filter;
+        //! Sequence number of the first event missed since the last one sent.
+        std::optional<uint64_t> gap_from;
+    };
+
+    Mutex m_mutex;
+    uint64_t m_next_sequence GUARDED_BY(m_mutex){1};
+    std::deque<RESTEvent> m_history GUARDED_BY(m_mutex);
+    size_t m_history_usage GUARDED_BY(m_mutex){0};
+    std::list<Subscriber> m_subscribers GUARDED_BY(m_mutex);
+    std::unique_ptr<HTTPEvent> m_keepalive GUARDED_BY(m_mutex);
+    bool m_stopped GUARDED_BY(m_mutex){false};
+
+    /** Send an event to a subscriber, if it wants it. Returns false if the subscriber went away. */
+    static bool Send(Subscriber& sub, const RESTEvent& event)
+    {
+        if (!sub.filter.WantsType(event.type) || (event.tx && !sub.filter.Matches(*event.tx))) return true;
+        HTTPRequest::ChunkResult result;
+        if (sub.gap_from) {
+            const std::string gap{strprintf("event: gap\ndata: {\"from\":%d,\"to\":%d}\n\n", *sub.gap_from, event.sequence - 1)};
+            result = sub.req->TryWriteReplyChunk(gap + event.text, MAX_REST_EVENT_PENDING);
+        } else {
+            result = sub.req->TryWriteReplyChunk(event.text, MAX_REST_EVENT_PENDING);
+        }
+        switch (result) {
+        case HTTPRequest::ChunkResult::SENT:
+            sub.gap_from.reset();
+            return true;
+        case HTTPRequest::ChunkResult::FULL:
+            if (!sub.gap_from) sub.gap_from = event.sequence;
+            return true;
+        case HTTPRequest::ChunkResult::CLOSED:
+            sub.req->EndChunkedReply();
+            return false;
+        } // no default case, so the compiler can warn about missing cases
+        assert(false);
+    }
+
+    void Publish(std::string_view type, CTransactionRef tx, const UniValue& data) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        if (m_stopped) return;
+        const uint64_t sequence{m_next_sequence++};
+        RESTEvent& event{m_history.emplace_back(RESTEvent{sequence, type, std::move(tx), strprintf("id: %d\nevent: %s\ndata: %s\n\n", sequence, type, data.write())})};
+        m_history_usage += event.Usage();
+        for (auto it{m_subscribers.begin()}; it != m_subscribers.end();) {
+            it = Send(*it, event) ? std::next(it) : m_subscribers.erase(it);
+        }
+        while (m_history_usage > MAX_REST_EVENT_HISTORY) {
+            m_history_usage -= m_history.front().Usage();
+            m_history.pop_front();
+        }
+    }
+
+    void KeepAlive() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        for (auto it{m_subscribers.begin()}; it != m_subscribers.end();) {
+            if (it->req->TryWriteReplyChunk(": keepalive\n\n", MAX_REST_EVENT_PENDING) == HTTPRequest::ChunkResult::CLOSED) {
+                it->req->EndChunkedReply();
+                it = m_subscribers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (m_keepalive) {
+            struct timeval tv{MillisToTimeval(REST_EVENT_KEEPALIVE)};
+            m_keepalive->trigger(&tv);
+        }
+    }
+
+protected:
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override
+    {
+        UniValue data{UniValue::VOBJ};
+        data.pushKV("hash", pindexNew->GetBlockHash().GetHex());
+        data.pushKV("height", pindexNew->nHeight);
+        data.pushKV("initialblockdownload", fInitialDownload);
+        Publish("tip", nullptr, data);
+    }
+
+    void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override
+    {
+        // Blocks validated in the background for an assumeutxo snapshot are not new.
+        if (role == ChainstateRole::BACKGROUND) return;
+        UniValue data{UniValue::VOBJ};
+        data.pushKV("hash", pindex->GetBlockHash().GetHex());
+        data.pushKV("height", pindex->nHeight);
+        data.pushKV("previousblockhash", block->hashPrevBlock.GetHex());
+        data.pushKV("time", block->GetBlockTime());
+        data.pushKV("nTx", block->vtx.size());
+        Publish("block", nullptr, data);
+    }
+
+    void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override
+    {
+        const CTransactionRef& ptx{tx.info.m_tx};
+        UniValue data{UniValue::VOBJ};
+        data.pushKV("txid", ptx->GetHash().GetHex());
+        data.pushKV("wtxid", ptx->GetWitnessHash().GetHex());
+        data.pushKV("vsize", tx.info.m_virtual_transaction_size);
+        data.pushKV("fee", ValueFromAmount(tx.info.m_fee));
+        data.pushKV("mempool_sequence", mempool_sequence);
+        Publish("tx_added", ptx, data);
+    }
+
+    void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override
+    {
+        UniValue data{UniValue::VOBJ};
+        data.pushKV("txid", tx->GetHash().GetHex());
+        data.pushKV("wtxid", tx->GetWitnessHash().GetHex());
+        data.pushKV("reason", RemovalReasonToString(reason));
+        data.pushKV("mempool_sequence", mempool_sequence);
+        Publish("tx_removed", tx, data);
+    }
+
+public:
+    explicit RESTEventPublisher(struct event_base* base)
+    {
+        LOCK(m_mutex);
+        m_keepalive = std::make_unique<HTTPEvent>(base, /*deleteWhenTriggered=*/false, [this] { KeepAlive(); });
+        struct timeval tv{MillisToTimeval(REST_EVENT_KEEPALIVE)};
+        m_keepalive->trigger(&tv);
+    }
+
+    /**
+     * Take over the request of a new subscriber, start its stream and send it
+     * the kept events after `last_seen`, if set.
+     *
+     * @returns false, leaving the request alone, if there are too many subscribers or it is shutting down
+     */
+    bool Subscribe(HTTPRequest* req, RESTEventFilter filter, std::optional<uint64_t> last_seen) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        if (m_stopped || m_subscribers.size() >= MAX_REST_EVENT_SUBSCRIBERS) return false;
+        Subscriber sub{req->Detach(), std::move(filter), std::nullopt};
+        sub.req->WriteHeader("Content-Type", "text/event-stream");
+        sub.req->WriteHeader("Cache-Control", "no-cache");
+        sub.req->StartChunkedReply(HTTP_OK);
+        if (last_seen) {
+            // Sequence numbers start over when the node restarts.
+            const uint64_t from{*last_seen < m_next_sequence ? *last_seen + 1 : 1};
+            const uint64_t oldest{m_history.empty() ? m_next_sequence : m_history.front().sequence};
+            if (from < oldest) sub.gap_from = from;
+            for (const RESTEvent& event : m_history) {
+                if (event.sequence >= from && !Send(sub, event)) return true;
+            }
+        }
+        m_subscribers.push_back(std::move(sub));
+        return true;
+    }
+
+    /** End all streams. */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        // Freed without the lock, as freeing it waits for a running KeepAlive.
+        std::unique_ptr<HTTPEvent> keepalive;
+        {
+            LOCK(m_mutex);
+            m_stopped = true;
+            keepalive = std::move(m_keepalive);
+            for (Subscriber& sub : m_subscribers) {
+                sub.req->EndChunkedReply();
+            }
+            m_subscribers.clear();
+        }
+    }
+};
+} // namespace
+
+//! Set by StartREST if validation events are available.
+static std::shared_ptr<RESTEventPublisher> g_rest_events;
+static Mutex g_rest_events_mutex;
+//! Where g_rest_events is registered on the first subscription. Cleared by StopREST.
+static ValidationSignals* g_rest_events_signals GUARDED_BY(g_rest_events_mutex){nullptr};
+static bool g_rest_events_registered GUARDED_BY(g_rest_events_mutex){false};
+
+static bool rest_events(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    if (!uri_part.empty() && uri_part[0] != '?') {
+        return RESTERR(req, HTTP_NOT_FOUND, "Invalid URI format. Expected /rest/events?types=<types>&scripts=<scripts>&outputtypes=<types>&since=<id>");
+    }
+    if (!g_rest_events) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Events are not available");
+    }
+
+    std::optional<std::string> raw_types, raw_scripts, raw_output_types, raw_since;
+    try {
+        raw_types = req->GetQueryParameter("types");
+        raw_scripts = req->GetQueryParameter("scripts");
+        raw_output_types = req->GetQueryParameter("outputtypes");
+        raw_since = req->GetQueryParameter("since");
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+    auto filter{ParseRESTEventFilter(raw_types, raw_scripts, raw_output_types)};
+    if (!filter) {
+        return RESTERR(req, HTTP_BAD_REQUEST, util::ErrorString(filter).original);
+    }
+
+    // Clients reconnecting with EventSource send the id of the last event they got.
+    if (!raw_since) {
+        if (auto [found, last_event_id]{req->GetHeader("Last-Event-ID")}; found) raw_since = last_event_id;
+    }
+    std::optional<uint64_t> last_seen;
+    if (raw_since) {
+        last_seen = ToIntegral<uint64_t>(*raw_since);
+        if (!last_seen) return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Invalid event id: %s", *raw_since));
+    }
+
+    {
+        LOCK(g_rest_events_mutex);
+        if (g_rest_events_signals && !g_rest_events_registered) {
+            LogDebug(BCLog::HTTP, "First subscriber to /rest/events, recording validation events\n");
+            g_rest_events_signals->RegisterSharedValidationInterface(g_rest_events);
+            g_rest_events_registered = true;
+        }
+    }
+    if (!g_rest_events->Subscribe(req, std::move(*filter), last_seen)) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, strprintf("Too many subscribers (max: %d)", MAX_REST_EVENT_SUBSCRIBERS));
+    }
+    return true;
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
@@ -1120,20 +1854,29 @@ static const struct {
       {"/rest/tx/", rest_tx},
       {"/rest/block/notxdetails/", rest_block_notxdetails},
       {"/rest/block/", rest_block_extended},
+      {"/rest/blocks/", rest_blocks},
       {"/rest/blockfilter/", rest_block_filter},
       {"/rest/blockfilterheaders/", rest_filter_header},
       {"/rest/chaininfo", rest_chaininfo},
       {"/rest/mempool/", rest_mempool},
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
+      {"/rest/txs", rest_txs},
       {"/rest/deploymentinfo/", rest_deploymentinfo},
       {"/rest/deploymentinfo", rest_deploymentinfo},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
       {"/rest/spenttxouts/", rest_spent_txouts},
+      {"/rest/scripthistory/", rest_script_history},
+      {"/rest/txospenders/", rest_txospenders},
+      {"/rest/events", rest_events},
 };
 
 void StartREST(const std::any& context)
 {
+    if (auto node{util::AnyPtr<NodeContext>(context)}; node && node->validation_signals) {
+        g_rest_events = std::make_shared<RESTEventPublisher>(EventBase());
+        WITH_LOCK(g_rest_events_mutex, g_rest_events_signals = node->validation_signals.get());
+    }
     for (const auto& up : uri_prefixes) {
         auto handler = [context, up](HTTPRequest* req, const std::string& prefix) { return up.handler(context, req, prefix); };
         RegisterHTTPHandler(up.prefix, false, handler);
@@ -1149,4 +1892,13 @@ void StopREST()
     for (const auto& up : uri_prefixes) {
         UnregisterHTTPHandler(up.prefix, false);
     }
+    if (g_rest_events) {
+        {
+            LOCK(g_rest_events_mutex);
+            if (g_rest_events_registered) g_rest_events_signals->UnregisterSharedValidationInterface(g_rest_events);
+            g_rest_events_signals = nullptr;
+            g_rest_events_registered = false;
+        }
+        g_rest_events->Stop();
+    }
 }
@@ -5,7 +5,18 @@
 #ifndef BITCOIN_REST_H
 #define BITCOIN_REST_H
 
+#include <script/script.h>
+#include <script/solver.h>
+#include <util/result.h>
+
+#include <array>
+#include <functional>
+#include <optional>
+#include <set>
 #include <string>
+#include <string_view>
+
+class CTransaction;
 
 enum class RESTResponseFormat {
     UNDEF,
@@ -25,4 +36,29 @@ enum class RESTResponseFormat {
  */
 RESTResponseFormat ParseDataFormat(std::string& param, const std::string& strReq);
 
+/** Types of the events sent by /rest/events. */
+inline constexpr std::array<std::string_view, 4> REST_EVENT_TYPES{"block", "tip", "tx_added", "tx_removed"};
+
+/** Which events a subscriber of /rest/events receives. */
+struct RESTEventFilter {
+    //! Event types to send, all of them if empty.
+    std::set<std::string, std::less<>> types;
+    //! Unless both are empty, only send the events of transactions with an
+    //! output paying to one of `scripts` or of one of `output_types`.
+    std::set<CScript> scripts;
+    std::set<TxoutType> output_types;
+
+    bool WantsType(std::string_view type) const { return types.empty() || types.contains(type); }
+    bool Matches(const CTransaction& tx) const;
+};
+
+/**
+ * Parse the filter of /rest/events from its query parameters, each a comma
+ * separated list: event types, hex encoded scripts and output type names (as
+ * in the "type" of a scriptPubKey in RPC results).
+ */
+util::Result<RESTEventFilter> ParseRESTEventFilter(const std::optional<std::string>& types,
+                                                   const std::optional<std::string>& scripts,
+                                                   const std::optional<std::string>& output_types);
+
 #endif // BITCOIN_REST_H
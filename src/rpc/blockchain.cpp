@@ -12,6 +12,7 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <consensus/amount.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
@@ -22,6 +23,7 @@
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scriptindex.h>
 #include <interfaces/mining.h>
 #include <kernel/coinstats.h>
 #include <logging/timer.h>
@@ -33,6 +35,7 @@
 #include <node/utxo_snapshot.h>
 #include <node/warnings.h>
 #include <primitives/transaction.h>
+#include <rpc/jsonstream.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
@@ -46,19 +49,29 @@
 #include <univalue.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/hasher.h>
 #include <util/strencodings.h>
+#include <util/thread.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
 #include <versionbits.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 
 #include <condition_variable>
+#include <functional>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 using kernel::CCoinsStats;
@@ -68,24 +81,27 @@ using interfaces::BlockRef;
 using interfaces::Mining;
 using node::BlockManager;
 using node::NodeContext;
+using node::SnapshotChunkHeader;
 using node::SnapshotMetadata;
 using util::MakeUnorderedList;
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
+std::tuple<std::vector<std::unique_ptr<CCoinsViewCursor>>, CCoinsStats, const CBlockIndex*>
 PrepareUTXOSnapshot(
     Chainstate& chainstate,
-    const std::function<void()>& interruption_point = {})
+    const std::function<void()>& interruption_point = {},
+    int num_cursors = 1)
     EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
-    CCoinsViewCursor* pcursor,
+    std::span<const std::unique_ptr<CCoinsViewCursor>> cursors,
     CCoinsStats* maybe_stats,
     const CBlockIndex* tip,
     AutoFile& afile,
     const fs::path& path,
     const fs::path& temppath,
-    const std::function<void()>& interruption_point = {});
+    const std::function<void()>& interruption_point = {},
+    bool chunked = false);
 
 /* Calculate the difficulty for a given block index.
  */
@@ -177,19 +193,13 @@ UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex
     return result;
 }
 
-UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+/** Convert the transactions of a block to JSON one at a time, stopping early if `fn` returns false. */
+static void BlockTxsToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& blockindex, TxVerbosity verbosity, const std::function<bool(UniValue&&)>& fn)
 {
-    UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
-
-    result.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
-    result.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
-    result.pushKV("weight", (int)::GetBlockWeight(block));
-    UniValue txs(UniValue::VARR);
-
     switch (verbosity) {
         case TxVerbosity::SHOW_TXID:
             for (const CTransactionRef& tx : block.vtx) {
-                txs.push_back(tx->GetHash().GetHex());
+                if (!fn(UniValue{tx->GetHash().GetHex()})) break;
             }
             break;
 
@@ -207,16 +217,51 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
                 const CTxUndo* txundo = (have_undo && i > 0) ? &blockUndo.vtxundo.at(i - 1) : nullptr;
                 UniValue objTx(UniValue::VOBJ);
                 TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/objTx, /*include_hex=*/true, txundo, verbosity);
-                txs.push_back(std::move(objTx));
+                if (!fn(std::move(objTx))) break;
             }
             break;
     }
+}
+
+/** The fields of the block description other than the transactions */
+static UniValue BlockSummaryToJSON(const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit)
+{
+    UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
+
+    result.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
+    result.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
+    result.pushKV("weight", (int)::GetBlockWeight(block));
+    return result;
+}
 
+UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+{
+    UniValue result = BlockSummaryToJSON(block, tip, blockindex, pow_limit);
+
+    UniValue txs(UniValue::VARR);
+    BlockTxsToJSON(blockman, block, blockindex, verbosity, [&](UniValue&& tx) {
+        txs.push_back(std::move(tx));
+        return true;
+    });
     result.pushKV("tx", std::move(txs));
 
     return result;
 }
 
+void blockToJSON(JSONStreamWriter& stream, BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+{
+    stream.BeginObject();
+    stream.Entries(BlockSummaryToJSON(block, tip, blockindex, pow_limit));
+    stream.Key("tx");
+    stream.BeginArray();
+    BlockTxsToJSON(blockman, block, blockindex, verbosity, [&](UniValue&& tx) {
+        stream.Value(tx);
+        return !stream.Failed();
+    });
+    stream.EndArray();
+    stream.EndObject();
+}
+
 static RPCHelpMan getblockcount()
 {
     return RPCHelpMan{
@@ -260,6 +305,50 @@ static RPCHelpMan getbestblockhash()
     };
 }
 
+static UniValue BlockRefToJSON(const BlockRef& block)
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("hash", block.hash.GetHex());
+    ret.pushKV("height", block.height);
+    return ret;
+}
+
+/**
+ * Wait until `done` holds for the tip, `timeout` milliseconds passed (unless
+ * 0) or RPC is shutting down, and return the tip. If the request lets it, the
+ * wait is left to the server (see RPCTipWait) and this returns right away.
+ */
+static UniValue WaitForTip(const JSONRPCRequest& request, Mining& miner, BlockRef current_block, int timeout, std::function<bool(const BlockRef&)> done)
+{
+    const auto deadline{std::chrono::steady_clock::now() + 1ms * timeout};
+
+    if (request.m_tip_wait && !done(current_block)) {
+        if (timeout) request.m_tip_wait->wake_at = deadline;
+        request.m_tip_wait->poll = [&miner, timeout, deadline, done = std::move(done)](auto&) -> std::optional<UniValue> {
+            const BlockRef tip{CHECK_NONFATAL(miner.getTip()).value()};
+            if (!done(tip) && IsRPCRunning() && (!timeout || std::chrono::steady_clock::now() < deadline)) return std::nullopt;
+            return BlockRefToJSON(tip);
+        };
+        return UniValue{};
+    }
+
+    while (!done(current_block)) {
+        std::optional<BlockRef> block;
+        if (timeout) {
+            auto now{std::chrono::steady_clock::now()};
+            if (now >= deadline) break;
+            const MillisecondsDouble remaining{deadline - now};
+            block = miner.waitTipChanged(current_block.hash, remaining);
+        } else {
+            block = miner.waitTipChanged(current_block.hash);
+        }
+        // Return current block upon shutdown
+        if (!block) break;
+        current_block = *block;
+    }
+    return BlockRefToJSON(current_block);
+}
+
 static RPCHelpMan waitfornewblock()
 {
     return RPCHelpMan{
@@ -291,17 +380,8 @@ static RPCHelpMan waitfornewblock()
     Mining& miner = EnsureMining(node);
 
     // Abort if RPC came out of warmup too early
-    BlockRef current_block{CHECK_NONFATAL(miner.getTip()).value()};
-    std::optional<BlockRef> block = timeout ? miner.waitTipChanged(current_block.hash, std::chrono::milliseconds(timeout)) :
-                                              miner.waitTipChanged(current_block.hash);
-
-    // Return current block upon shutdown
-    if (block) current_block = *block;
-
-    UniValue ret(UniValue::VOBJ);
-    ret.pushKV("hash", current_block.hash.GetHex());
-    ret.pushKV("height", current_block.height);
-    return ret;
+    const BlockRef current_block{CHECK_NONFATAL(miner.getTip()).value()};
+    return WaitForTip(request, miner, current_block, timeout, [current_block](const BlockRef& tip) { return tip.hash != current_block.hash; });
 },
     };
 }
@@ -341,28 +421,9 @@ static RPCHelpMan waitforblock()
     Mining& miner = EnsureMining(node);
 
     // Abort if RPC came out of warmup too early
-    BlockRef current_block{CHECK_NONFATAL(miner.getTip()).value()};
+    const BlockRef current_block{CHECK_NONFATAL(miner.getTip()).value()};
 
-    const auto deadline{std::chrono::steady_clock::now() + 1ms * timeout};
-    while (current_block.hash != hash) {
-        std::optional<BlockRef> block;
-        if (timeout) {
-            auto now{std::chrono::steady_clock::now()};
-            if (now >= deadline) break;
-            const MillisecondsDouble remaining{deadline - now};
-            block = miner.waitTipChanged(current_block.hash, remaining);
-        } else {
-            block = miner.waitTipChanged(current_block.hash);
-        }
-        // Return current block upon shutdown
-        if (!block) break;
-        current_block = *block;
-    }
-
-    UniValue ret(UniValue::VOBJ);
-    ret.pushKV("hash", current_block.hash.GetHex());
-    ret.pushKV("height", current_block.height);
-    return ret;
+    return WaitForTip(request, miner, current_block, timeout, [hash](const BlockRef& tip) { return tip.hash == hash; });
 },
     };
 }
@@ -403,29 +464,9 @@ static RPCHelpMan waitforblockheight()
     Mining& miner = EnsureMining(node);
 
     // Abort if RPC came out of warmup too early
-    BlockRef current_block{CHECK_NONFATAL(miner.getTip()).value()};
-
-    const auto deadline{std::chrono::steady_clock::now() + 1ms * timeout};
-
-    while (current_block.height < height) {
-        std::optional<BlockRef> block;
-        if (timeout) {
-            auto now{std::chrono::steady_clock::now()};
-            if (now >= deadline) break;
-            const MillisecondsDouble remaining{deadline - now};
-            block = miner.waitTipChanged(current_block.hash, remaining);
-        } else {
-            block = miner.waitTipChanged(current_block.hash);
-        }
-        // Return current block on shutdown
-        if (!block) break;
-        current_block = *block;
-    }
+    const BlockRef current_block{CHECK_NONFATAL(miner.getTip()).value()};
 
-    UniValue ret(UniValue::VOBJ);
-    ret.pushKV("hash", current_block.hash.GetHex());
-    ret.pushKV("height", current_block.height);
-    return ret;
+    return WaitForTip(request, miner, current_block, timeout, [height](const BlockRef& tip) { return tip.height >= height; });
 },
     };
 }
@@ -815,12 +856,15 @@ static RPCHelpMan getblock()
     const std::vector<std::byte> block_data{GetRawBlockChecked(chainman.m_blockman, *pblockindex)};
 
     if (verbosity <= 0) {
+        if (JSONStreamWriter* stream{request.m_result_stream}) {
+            stream->HexValue(block_data);
+            return UniValue::VNULL;
+        }
         return HexStr(block_data);
     }
 
-    DataStream block_stream{block_data};
     CBlock block{};
-    block_stream >> TX_WITH_WITNESS(block);
+    SpanReader{block_data} >> TX_WITH_WITNESS(block);
 
     TxVerbosity tx_verbosity;
     if (verbosity == 1) {
@@ -831,6 +875,10 @@ static RPCHelpMan getblock()
         tx_verbosity = TxVerbosity::SHOW_DETAILS_AND_PREVOUT;
     }
 
+    if (JSONStreamWriter* stream{request.m_result_stream}; stream && tx_verbosity != TxVerbosity::SHOW_TXID) {
+        blockToJSON(*stream, chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+        return UniValue::VNULL;
+    }
     return blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
 },
     };
@@ -961,7 +1009,8 @@ static std::optional<kernel::CCoinsStats> GetUTXOStats(CCoinsView* view, node::B
     // best block.
     CHECK_NONFATAL(!pindex || pindex->GetBlockHash() == view->GetBestBlock());
 
-    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point);
+    return kernel::ComputeUTXOStats(hash_type, view, blockman, interruption_point,
+                                    /*num_threads=*/std::clamp(GetNumCores(), 1, kernel::MAX_UTXO_STATS_THREADS));
 }
 
 static RPCHelpMan gettxoutsetinfo()
@@ -2124,40 +2173,126 @@ static RPCHelpMan getblockstats()
     };
 }
 
+//! Maximum number of threads reading the UTXO set in dumptxoutset.
+static constexpr int MAX_DUMPTXOUTSET_THREADS{8};
+//! Maximum number of threads scanning the UTXO set in scantxoutset.
+static constexpr int MAX_SCANTXOUTSET_THREADS{8};
+//! Number of key ranges, by the first byte of the txid, a parallel scan of the UTXO set is split into.
+static constexpr int SCAN_PARTITIONS{256};
+
 namespace {
-//! Search for a given set of pubkey scripts
-bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+//! Scripts to search for, mapped to the index of the scan object they were derived from.
+using ScanNeedles = std::unordered_map<CScript, size_t, SaltedSipHasher>;
+
+//! Scan the coins from the cursor's position on, up to the first coin whose txid does not start with
+//! the given byte or, without one, to the end of the set. keep_going is called every 256 coins.
+bool ScanCoins(CCoinsViewCursor& cursor, std::optional<uint8_t> partition, const ScanNeedles& needles, std::atomic<int64_t>& count, std::atomic<int64_t>& found, std::vector<std::pair<COutPoint, Coin>>& out_results, const std::function<bool(const COutPoint&)>& keep_going)
 {
-    scan_progress = 0;
-    count = 0;
-    while (cursor->Valid()) {
+    int64_t counted{0};
+    const auto flush_count{[&] { count += counted; counted = 0; }};
+    for (; cursor.Valid(); cursor.Next()) {
         COutPoint key;
         Coin coin;
-        if (!cursor->GetKey(key) || !cursor->GetValue(coin)) return false;
-        if (++count % 8192 == 0) {
-            interruption_point();
-            if (should_abort) {
-                // allow to abort the scan via the abort reference
-                return false;
-            }
+        if (!cursor.GetKey(key)) return false;
+        if (partition && *UCharCast(key.hash.begin()) != *partition) break;
+        if (!cursor.GetValue(coin)) return false;
+        if (++counted == 256) {
+            flush_count();
+            if (!keep_going(key)) return false;
         }
-        if (count % 256 == 0) {
-            // update progress reference every 256 item
-            uint32_t high = 0x100 * *UCharCast(key.hash.begin()) + *(UCharCast(key.hash.begin()) + 1);
-            scan_progress = (int)(high * 100.0 / 65536.0 + 0.5);
+        if (needles.contains(coin.out.scriptPubKey)) {
+            out_results.emplace_back(key, std::move(coin));
+            ++found;
         }
-        if (needles.count(coin.out.scriptPubKey)) {
-            out_results.emplace(key, coin);
-        }
-        cursor->Next();
     }
-    scan_progress = 100;
+    flush_count();
     return true;
 }
+
+//! Search for a given set of pubkey scripts. With more than one cursor, the set is split into
+//! SCAN_PARTITIONS key ranges that are scanned on one thread per cursor. All cursors must see the
+//! same state of the UTXO set. Results are sorted by outpoint.
+bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, std::atomic<int64_t>& count, std::atomic<int64_t>& found, std::span<const std::unique_ptr<CCoinsViewCursor>> cursors, const ScanNeedles& needles, std::vector<std::pair<COutPoint, Coin>>& out_results, const std::function<void()>& interruption_point)
+{
+    scan_progress = 0;
+    count = 0;
+    found = 0;
+    out_results.clear();
+    bool ok;
+    if (cursors.size() <= 1 || !cursors[0]->Seek(COutPoint{Txid{}, 0})) {
+        int calls{0};
+        ok = ScanCoins(*cursors[0], std::nullopt, needles, count, found, out_results, [&](const COutPoint& key) {
+            if (++calls % 32 == 0) {
+                interruption_point();
+                // allow to abort the scan via the abort reference
+                if (should_abort) return false;
+            }
+            uint32_t high = 0x100 * *UCharCast(key.hash.begin()) + *(UCharCast(key.hash.begin()) + 1);
+            scan_progress = (int)(high * 100.0 / 65536.0 + 0.5);
+            return true;
+        });
+    } else {
+        std::atomic<int> next_partition{0};
+        std::atomic<int> done_partitions{0};
+        std::atomic<bool> stop{false};
+        std::atomic<bool> failed{false};
+        std::vector<std::vector<std::pair<COutPoint, Coin>>> results(cursors.size());
+        const auto scan_partitions{[&](size_t i, const std::function<bool(const COutPoint&)>& keep_going) {
+            for (int partition; !stop && (partition = next_partition++) < SCAN_PARTITIONS;) {
+                uint256 start;
+                start.begin()[0] = partition;
+                if (!cursors[i]->Seek(COutPoint{Txid::FromUint256(start), 0}) ||
+                    !ScanCoins(*cursors[i], partition, needles, count, found, results[i], keep_going)) {
+                    if (!stop) failed = true;
+                    stop = true;
+                    return;
+                }
+                scan_progress = ++done_partitions * 100 / SCAN_PARTITIONS;
+            }
+        }};
+        const auto worker_keep_going{[&](const COutPoint&) { return !stop && !should_abort; }};
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < cursors.size(); ++i) {
+            threads.emplace_back(&util::TraceThread, strprintf("scantxout.%d", i), [&, i] {
+                try {
+                    scan_partitions(i, worker_keep_going);
+                } catch (const std::exception& e) {
+                    LogError("%s: unable to scan the UTXO set: %s\n", __func__, e.what());
+                    failed = true;
+                    stop = true;
+                }
+            });
+        }
+        // The calling thread scans too, and is the only one that may be interrupted.
+        int calls{0};
+        try {
+            scan_partitions(0, [&](const COutPoint&) {
+                if (++calls % 32 == 0) interruption_point();
+                return !stop && !should_abort;
+            });
+        } catch (...) {
+            stop = true;
+            for (std::thread& thread : threads) thread.join();
+            throw;
+        }
+        for (std::thread& thread : threads) thread.join();
+
+        ok = !failed && done_partitions == SCAN_PARTITIONS;
+        for (auto& partial : results) {
+            out_results.insert(out_results.end(), std::make_move_iterator(partial.begin()), std::make_move_iterator(partial.end()));
+        }
+        std::sort(out_results.begin(), out_results.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+    if (ok) scan_progress = 100;
+    return ok;
+}
 } // namespace
 
 /** RAII object to prevent concurrency issue when scanning the txout set */
 static std::atomic<int> g_scan_progress;
+static std::atomic<int64_t> g_scan_txouts;
+static std::atomic<int64_t> g_scan_found;
 static std::atomic<bool> g_scan_in_progress;
 static std::atomic<bool> g_should_abort_scan;
 class CoinsViewScanReserver
@@ -2181,6 +2316,8 @@ public:
         if (m_could_reserve) {
             g_scan_in_progress = false;
             g_scan_progress = 0;
+            g_scan_txouts = 0;
+            g_scan_found = 0;
         }
     }
 };
@@ -2215,7 +2352,11 @@ static const auto scan_result_status_none = RPCResult{
 };
 static const auto scan_result_status_some = RPCResult{
     "when action=='status' and a scan is currently in progress", RPCResult::Type::OBJ, "", "",
-    {{RPCResult::Type::NUM, "progress", "Approximate percent complete"},}
+    {
+        {RPCResult::Type::NUM, "progress", "Approximate percent complete"},
+        {RPCResult::Type::NUM, "txouts", "The number of unspent transaction outputs scanned so far"},
+        {RPCResult::Type::NUM, "found", "The number of matching unspent transaction outputs found so far"},
+    }
 };
 
 
@@ -2292,6 +2433,8 @@ static RPCHelpMan scantxoutset()
             return UniValue::VNULL;
         }
         result.pushKV("progress", g_scan_progress.load());
+        result.pushKV("txouts", g_scan_txouts.load());
+        result.pushKV("found", g_scan_found.load());
         return result;
     } else if (action == "abort") {
         CoinsViewScanReserver reserver;
@@ -2312,28 +2455,25 @@ static RPCHelpMan scantxoutset()
             throw JSONRPCError(RPC_MISC_ERROR, "scanobjects argument is required for the start action");
         }
 
-        std::set<CScript> needles;
-        std::map<CScript, std::string> descriptors;
+        // Only derive the scripts here. Descriptors are inferred for matching scripts only, which
+        // keeps large ranges cheap.
+        ScanNeedles needles;
+        std::vector<FlatSigningProvider> providers;
         CAmount total_in = 0;
 
         // loop through the scan objects
         for (const UniValue& scanobject : request.params[1].get_array().getValues()) {
-            FlatSigningProvider provider;
-            auto scripts = EvalDescriptorStringOrObject(scanobject, provider);
-            for (CScript& script : scripts) {
-                std::string inferred = InferDescriptor(script, provider)->ToString();
-                needles.emplace(script);
-                descriptors.emplace(std::move(script), std::move(inferred));
+            FlatSigningProvider& provider{providers.emplace_back()};
+            for (CScript& script : EvalDescriptorStringOrObject(scanobject, provider)) {
+                needles.emplace(std::move(script), providers.size() - 1);
             }
         }
 
         // Scan the unspent transaction output set for inputs
         UniValue unspents(UniValue::VARR);
-        std::vector<CTxOut> input_txos;
-        std::map<COutPoint, Coin> coins;
+        std::vector<std::pair<COutPoint, Coin>> coins;
         g_should_abort_scan = false;
-        int64_t count = 0;
-        std::unique_ptr<CCoinsViewCursor> pcursor;
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
         const CBlockIndex* tip;
         NodeContext& node = EnsureAnyNodeContext(request.context);
         {
@@ -2341,28 +2481,37 @@ static RPCHelpMan scantxoutset()
             LOCK(cs_main);
             Chainstate& active_chainstate = chainman.ActiveChainstate();
             active_chainstate.ForceFlushStateToDisk();
-            pcursor = CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor());
+            // Create all cursors under the same lock so that they see the same UTXO set.
+            const int num_threads{std::clamp(GetNumCores(), 1, MAX_SCANTXOUTSET_THREADS)};
+            for (int i = 0; i < num_threads; ++i) {
+                cursors.push_back(CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor()));
+            }
             tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
         }
-        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
+        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, g_scan_txouts, g_scan_found, cursors, needles, coins, node.rpc_interruption_point);
+        cursors.clear();
         result.pushKV("success", res);
-        result.pushKV("txouts", count);
+        result.pushKV("txouts", g_scan_txouts.load());
         result.pushKV("height", tip->nHeight);
         result.pushKV("bestblock", tip->GetBlockHash().GetHex());
 
-        for (const auto& it : coins) {
-            const COutPoint& outpoint = it.first;
-            const Coin& coin = it.second;
+        std::map<CScript, std::string> descriptors;
+        for (const auto& [outpoint, coin] : coins) {
             const CTxOut& txo = coin.out;
             const CBlockIndex& coinb_block{*CHECK_NONFATAL(tip->GetAncestor(coin.nHeight))};
-            input_txos.push_back(txo);
             total_in += txo.nValue;
 
+            auto desc{descriptors.find(txo.scriptPubKey)};
+            if (desc == descriptors.end()) {
+                const FlatSigningProvider& provider{providers.at(needles.at(txo.scriptPubKey))};
+                desc = descriptors.emplace(txo.scriptPubKey, InferDescriptor(txo.scriptPubKey, provider)->ToString()).first;
+            }
+
             UniValue unspent(UniValue::VOBJ);
             unspent.pushKV("txid", outpoint.hash.GetHex());
             unspent.pushKV("vout", outpoint.n);
             unspent.pushKV("scriptPubKey", HexStr(txo.scriptPubKey));
-            unspent.pushKV("desc", descriptors[txo.scriptPubKey]);
+            unspent.pushKV("desc", desc->second);
             unspent.pushKV("amount", ValueFromAmount(txo.nValue));
             unspent.pushKV("coinbase", coin.IsCoinBase());
             unspent.pushKV("height", coin.nHeight);
@@ -2409,6 +2558,94 @@ public:
     }
 };
 
+//! Maximum number of threads matching block filters in scanblocks.
+static constexpr int MAX_SCANBLOCKS_THREADS{8};
+//! Number of block filters a thread matches before claiming more.
+static constexpr size_t SCANBLOCKS_FILTERS_PER_BATCH{256};
+
+BlockFilterMatcher::BlockFilterMatcher(const GCSFilter::ElementSet& needles, int num_threads) : m_needles{needles}
+{
+    // The thread calling Match() works along, so only start the others.
+    for (int n = 1; n < num_threads; ++n) {
+        m_workers.emplace_back(&util::TraceThread, strprintf("scanblocks.%i", n), [this] { WorkerLoop(); });
+    }
+}
+
+BlockFilterMatcher::~BlockFilterMatcher()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_work_cv.notify_all();
+    for (std::thread& worker : m_workers) worker.join();
+}
+
+std::vector<char> BlockFilterMatcher::Match(const std::vector<BlockFilter>& filters)
+{
+    // Not std::vector<bool>, which can't be written to from several threads.
+    std::vector<char> matches(filters.size());
+    {
+        LOCK(m_mutex);
+        m_filters = &filters;
+        m_matches = &matches;
+        m_next = 0;
+        m_pending = filters.size();
+    }
+    if (filters.size() > SCANBLOCKS_FILTERS_PER_BATCH) m_work_cv.notify_all();
+    MatchBatches();
+
+    // Workers may still write to matches until every batch is done, even after an error.
+    WAIT_LOCK(m_mutex, lock);
+    m_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_pending == 0; });
+    m_filters = nullptr;
+    m_matches = nullptr;
+    if (m_error) std::rethrow_exception(std::exchange(m_error, nullptr));
+    return matches;
+}
+
+void BlockFilterMatcher::MatchBatches()
+{
+    while (true) {
+        const std::vector<BlockFilter>* filters;
+        std::vector<char>* matches;
+        size_t begin, end;
+        {
+            LOCK(m_mutex);
+            if (!m_filters || m_next >= m_filters->size()) return;
+            filters = m_filters;
+            matches = m_matches;
+            begin = m_next;
+            end = std::min(begin + SCANBLOCKS_FILTERS_PER_BATCH, filters->size());
+            m_next = end;
+        }
+        std::exception_ptr error;
+        try {
+            // Filters are read without checking their encoding, so a damaged one throws here.
+            for (size_t i = begin; i < end; ++i) {
+                (*matches)[i] = (*filters)[i].GetFilter().MatchAny(m_needles);
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        LOCK(m_mutex);
+        if (error && !m_error) m_error = error;
+        m_pending -= end - begin;
+        if (m_pending == 0) m_done_cv.notify_one();
+    }
+}
+
+void BlockFilterMatcher::WorkerLoop()
+{
+    while (true) {
+        {
+            WAIT_LOCK(m_mutex, lock);
+            m_work_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+                return m_stop || (m_filters && m_next < m_filters->size());
+            });
+            if (m_stop) return;
+        }
+        MatchBatches();
+    }
+}
+
 static bool CheckBlockFilterMatches(BlockManager& blockman, const CBlockIndex& blockindex, const GCSFilter::ElementSet& needles)
 {
     const CBlock block{GetBlockChecked(blockman, blockindex)};
@@ -2556,6 +2793,7 @@ static RPCHelpMan scanblocks()
         }
         UniValue blocks(UniValue::VARR);
         const int amount_per_chunk = 10000;
+        BlockFilterMatcher matcher{needle_set, std::clamp(GetNumCores(), 1, MAX_SCANBLOCKS_THREADS)};
         std::vector<BlockFilter> filters;
         int start_block_height = start_index->nHeight; // for progress reporting
         const int total_blocks_to_process = stop_block->nHeight - start_block_height;
@@ -2580,9 +2818,16 @@ static RPCHelpMan scanblocks()
                     stop_block;
 
             if (index->LookupFilterRange(start_block, end_range, filters)) {
-                for (const BlockFilter& filter : filters) {
-                    // compare the elements-set with each filter
-                    if (filter.GetFilter().MatchAny(needle_set)) {
+                // compare the elements-set with each filter
+                std::vector<char> matches;
+                try {
+                    matches = matcher.Match(filters);
+                } catch (const std::exception& e) {
+                    throw JSONRPCError(RPC_DATABASE_ERROR, strprintf("Failed to match block filters: %s", e.what()));
+                }
+                for (size_t i = 0; i < filters.size(); ++i) {
+                    const BlockFilter& filter{filters[i]};
+                    if (matches[i]) {
                         if (filter_false_positives) {
                             // Double check the filter matches by scanning the block
                             const CBlockIndex& blockindex = *CHECK_NONFATAL(WITH_LOCK(cs_main, return chainman.m_blockman.LookupBlockIndex(filter.GetBlockHash())));
@@ -2853,6 +3098,153 @@ static RPCHelpMan getdescriptoractivity()
     };
 }
 
+UniValue ScriptHistoryEntryToJSON(const ScriptHistoryEntry& entry, const CScript& script, const uint256& block_hash)
+{
+    UniValue event(UniValue::VOBJ);
+    event.pushKV("type", entry.spend ? "spend" : "receive");
+    event.pushKV("amount", ValueFromAmount(entry.amount));
+    event.pushKV("blockhash", block_hash.GetHex());
+    event.pushKV("height", entry.height);
+    event.pushKV("txid", entry.txid.GetHex());
+    event.pushKV(entry.spend ? "vin" : "vout", entry.index);
+    if (entry.spend) {
+        event.pushKV("prevout_txid", entry.prevout.hash.GetHex());
+        event.pushKV("prevout_vout", entry.prevout.n);
+    }
+    event.pushKV("scriptPubKey", HexStr(script));
+    return event;
+}
+
+UniValue ScriptHistoryToJSON(ChainstateManager& chainman, const std::vector<CScript>& scripts, int start_height, int limit)
+{
+    if (!g_script_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Script index is not enabled (start the node with -scriptindex)");
+    }
+    if (start_height < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid start_height");
+    }
+    if (limit < 1 || limit > MAX_SCRIPT_HISTORY_LIMIT) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("limit must be between 1 and %d", MAX_SCRIPT_HISTORY_LIMIT));
+    }
+    if (!g_script_index->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because scriptindex is still syncing. Current height: %d",
+                                                     g_script_index->GetSummary().best_block_height));
+    }
+
+    // The index only records heights, and it may be rewound to follow a reorg while it is being
+    // read. Take the block hashes from the chain the index was on once done reading, after making
+    // sure that it was not rewound in the meantime.
+    static constexpr int MAX_ATTEMPTS{3};
+    for (int attempt{1}; ; ++attempt) {
+        const IndexSummary before{g_script_index->GetSummary()};
+
+        // Merge the histories of all scripts in block chain order. Each lookup stops at a block
+        // boundary, so everything below the lowest height any of them stopped at is complete.
+        std::vector<std::pair<ScriptHistoryEntry, const CScript*>> events;
+        std::optional<int> next_height;
+        for (const CScript& script : scripts) {
+            std::optional<ScriptHistory> history{g_script_index->FindScriptHistory(script, start_height, limit)};
+            if (!history) {
+                throw JSONRPCError(RPC_DATABASE_ERROR, "Unable to read script index");
+            }
+            for (ScriptHistoryEntry& entry : history->entries) events.emplace_back(std::move(entry), &script);
+            if (history->next_height && (!next_height || *history->next_height < *next_height)) {
+                next_height = history->next_height;
+            }
+        }
+        const IndexSummary after{g_script_index->GetSummary()};
+
+        std::erase_if(events, [&](const auto& event) {
+            // Blocks appended after `after` was taken are left for the next call.
+            return (next_height && event.first.height >= *next_height) || event.first.height > after.best_block_height;
+        });
+        std::sort(events.begin(), events.end(), [](const auto& a, const auto& b) {
+            return std::tie(a.first.height, a.first.tx_pos, a.first.spend, a.first.index) <
+                   std::tie(b.first.height, b.first.tx_pos, b.first.spend, b.first.index);
+        });
+        // Apply the limit to the merged history as well, again only at a block boundary.
+        for (size_t i = limit; i < events.size(); ++i) {
+            if (events[i].first.height != events[i - 1].first.height) {
+                next_height = events[i].first.height;
+                events.resize(i);
+                break;
+            }
+        }
+
+        LOCK(::cs_main);
+        const CBlockIndex* index_tip{chainman.m_blockman.LookupBlockIndex(after.best_block_hash)};
+        const CBlockIndex* index_before{index_tip ? index_tip->GetAncestor(before.best_block_height) : nullptr};
+        if (!index_before || index_before->GetBlockHash() != before.best_block_hash) {
+            if (attempt < MAX_ATTEMPTS) continue;
+            throw JSONRPCError(RPC_MISC_ERROR, "Script index was rewound while being read, try again");
+        }
+
+        UniValue history(UniValue::VARR);
+        for (const auto& [entry, script] : events) {
+            const CBlockIndex* block{CHECK_NONFATAL(index_tip->GetAncestor(entry.height))};
+            history.push_back(ScriptHistoryEntryToJSON(entry, *script, block->GetBlockHash()));
+        }
+
+        UniValue ret(UniValue::VOBJ);
+        ret.pushKV("history", std::move(history));
+        if (next_height) ret.pushKV("next_height", *next_height);
+        return ret;
+    }
+}
+
+static RPCHelpMan getscripthistory()
+{
+    return RPCHelpMan{
+        "getscripthistory",
+        "Get all confirmed receive and spend activity of a set of descriptors from the script index, in block chain order.\n"
+        "Requires -scriptindex. Results are limited in size; continue from next_height to get the rest.\n",
+        {
+            scan_objects_arg_desc,
+            {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "The height of the first block to include"},
+            {"limit", RPCArg::Type::NUM, RPCArg::Default{DEFAULT_SCRIPT_HISTORY_LIMIT}, strprintf("Stop after about this many events (up to %d); never in the middle of a block", MAX_SCRIPT_HISTORY_LIMIT)},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "", {
+                {RPCResult::Type::ARR, "history", "events", {
+                    {RPCResult::Type::OBJ, "", "", {
+                        {RPCResult::Type::STR, "type", "'receive' for an output paying to the script, 'spend' for an input spending one"},
+                        {RPCResult::Type::STR_AMOUNT, "amount", "The amount in " + CURRENCY_UNIT + " of the output"},
+                        {RPCResult::Type::STR_HEX, "blockhash", "The block the event is in"},
+                        {RPCResult::Type::NUM, "height", "The height of the block"},
+                        {RPCResult::Type::STR_HEX, "txid", "The transaction with the output or input"},
+                        {RPCResult::Type::NUM, "vout", /*optional=*/true, "The output index (receive only)"},
+                        {RPCResult::Type::NUM, "vin", /*optional=*/true, "The input index (spend only)"},
+                        {RPCResult::Type::STR_HEX, "prevout_txid", /*optional=*/true, "The txid of the spent output (spend only)"},
+                        {RPCResult::Type::NUM, "prevout_vout", /*optional=*/true, "The vout of the spent output (spend only)"},
+                        {RPCResult::Type::STR_HEX, "scriptPubKey", "The script"},
+                    }},
+                }},
+                {RPCResult::Type::NUM, "next_height", /*optional=*/true, "If the result was limited, the start_height to continue from"},
+            },
+        },
+        RPCExamples{
+            HelpExampleCli("getscripthistory", "'[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"]'") +
+            HelpExampleCli("getscripthistory", "'[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"]' 300000 100") +
+            HelpExampleRpc("getscripthistory", "[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"], 300000, 100")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+
+    std::set<CScript> scripts;
+    for (const UniValue& scanobject : request.params[0].get_array().getValues()) {
+        FlatSigningProvider provider;
+        for (CScript& script : EvalDescriptorStringOrObject(scanobject, provider)) {
+            scripts.insert(std::move(script));
+        }
+    }
+
+    return ScriptHistoryToJSON(chainman, {scripts.begin(), scripts.end()},
+                               self.Arg<int>("start_height"), self.Arg<int>("limit"));
+},
+    };
+}
+
 static RPCHelpMan getblockfilter()
 {
     return RPCHelpMan{
@@ -2990,6 +3382,9 @@ static RPCHelpMan dumptxoutset()
                     {"rollback", RPCArg::Type::NUM, RPCArg::Optional::OMITTED,
                         "Height or hash of the block to roll back to before creating the snapshot. Note: The further this number is from the tip, the longer this process will take. Consider setting a higher -rpcclienttimeout value in this case.",
                     RPCArgOptions{.skip_type_check = true, .type_str = {"", "string or numeric"}}},
+                    {"chunked", RPCArg::Type::BOOL, RPCArg::Default{false},
+                        "Write the coins in separately checksummed chunks, which are written and loaded on several threads. "
+                        "Such snapshots can only be loaded by nodes that support snapshot format version 3."},
                 },
             },
         },
@@ -3088,8 +3483,9 @@ static RPCHelpMan dumptxoutset()
         temporary_rollback.emplace(*node.chainman, *invalidate_index);
     }
 
+    const bool chunked{options.exists("chunked") && options["chunked"].get_bool()};
     Chainstate* chainstate;
-    std::unique_ptr<CCoinsViewCursor> cursor;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
     CCoinsStats stats;
     {
         // Lock the chainstate before calling PrepareUtxoSnapshot, to be able
@@ -3110,11 +3506,12 @@ static RPCHelpMan dumptxoutset()
             LogWarning("dumptxoutset failed to roll back to requested height, reverting to tip.\n");
             throw JSONRPCError(RPC_MISC_ERROR, "Could not roll back to requested height.");
         } else {
-            std::tie(cursor, stats, tip) = PrepareUTXOSnapshot(*chainstate, node.rpc_interruption_point);
+            std::tie(cursors, stats, tip) = PrepareUTXOSnapshot(*chainstate, node.rpc_interruption_point,
+                                                                /*num_cursors=*/std::clamp(GetNumCores(), 1, MAX_DUMPTXOUTSET_THREADS));
         }
     }
 
-    UniValue result = WriteUTXOSnapshot(*chainstate, cursor.get(), &stats, tip, afile, path, temppath, node.rpc_interruption_point);
+    UniValue result = WriteUTXOSnapshot(*chainstate, cursors, &stats, tip, afile, path, temppath, node.rpc_interruption_point, chunked);
     fs::rename(temppath, path);
 
     result.pushKV("path", path.utf8string());
@@ -3123,23 +3520,24 @@ static RPCHelpMan dumptxoutset()
     };
 }
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
+std::tuple<std::vector<std::unique_ptr<CCoinsViewCursor>>, CCoinsStats, const CBlockIndex*>
 PrepareUTXOSnapshot(
     Chainstate& chainstate,
-    const std::function<void()>& interruption_point)
+    const std::function<void()>& interruption_point,
+    int num_cursors)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
     std::optional<CCoinsStats> maybe_stats;
     const CBlockIndex* tip;
 
     {
         // We need to lock cs_main to ensure that the coinsdb isn't written to
         // between (i) flushing coins cache to disk (coinsdb), (ii) getting stats
-        // based upon the coinsdb, and (iii) constructing a cursor to the
+        // based upon the coinsdb, and (iii) constructing the cursors to the
         // coinsdb for use in WriteUTXOSnapshot.
         //
         // Cursors returned by leveldb iterate over snapshots, so the contents
-        // of the pcursor will not be affected by simultaneous writes during
+        // of the cursors will not be affected by simultaneous writes during
         // use below this block.
         //
         // See discussion here:
@@ -3154,73 +3552,169 @@ PrepareUTXOSnapshot(
             throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
         }
 
-        pcursor = chainstate.CoinsDB().Cursor();
+        for (int i = 0; i < std::max(num_cursors, 1); ++i) {
+            cursors.push_back(chainstate.CoinsDB().Cursor());
+        }
         tip = CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(maybe_stats->hashBlock));
     }
 
-    return {std::move(pcursor), *CHECK_NONFATAL(maybe_stats), tip};
+    return {std::move(cursors), *CHECK_NONFATAL(maybe_stats), tip};
 }
 
+namespace {
+//! Serialize the coins of one chunk of the UTXO set, starting at the cursor's position.
+//! To reduce space the serialization format of the snapshot avoids
+//! duplication of tx hashes. The code takes advantage of the guarantee by
+//! leveldb that keys are lexicographically sorted.
+//! In the coins vector we collect all coins that belong to a certain tx hash
+//! and when we have them all we write them to the stream.
+//! See also https://github.com/bitcoin/bitcoin/issues/25675
+bool SerializeSnapshotChunk(CCoinsViewCursor& cursor, uint32_t chunk, DataStream& out, uint64_t& coins_count, const std::function<bool()>& keep_going)
+{
+    COutPoint key;
+    Coin coin;
+    std::optional<Txid> last_hash;
+    std::vector<std::pair<uint32_t, Coin>> coins;
+    const auto write_coins{[&] {
+        out << *last_hash;
+        WriteCompactSize(out, coins.size());
+        for (const auto& [n, coin] : coins) {
+            WriteCompactSize(out, n);
+            out << coin;
+        }
+        coins_count += coins.size();
+        coins.clear();
+    }};
+
+    for (unsigned int iter{0}; cursor.Valid(); cursor.Next()) {
+        if (++iter % 5000 == 0 && !keep_going()) return false;
+        if (!cursor.GetKey(key) || !cursor.GetValue(coin)) continue;
+        if (node::SnapshotChunkOf(key.hash) != chunk) break;
+        if (key.hash != last_hash) {
+            if (last_hash) write_coins();
+            last_hash = key.hash;
+        }
+        coins.emplace_back(key.n, std::move(coin));
+    }
+    if (!coins.empty()) write_coins();
+    return true;
+}
+} // namespace
+
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
-    CCoinsViewCursor* pcursor,
+    std::span<const std::unique_ptr<CCoinsViewCursor>> cursors,
     CCoinsStats* maybe_stats,
     const CBlockIndex* tip,
     AutoFile& afile,
     const fs::path& path,
     const fs::path& temppath,
-    const std::function<void()>& interruption_point)
+    const std::function<void()>& interruption_point,
+    bool chunked)
 {
     LOG_TIME_SECONDS(strprintf("writing UTXO snapshot at height %s (%s) to file %s (via %s)",
         tip->nHeight, tip->GetBlockHash().ToString(),
         fs::PathToString(path), fs::PathToString(temppath)));
 
     SnapshotMetadata metadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), maybe_stats->coins_count};
+    if (chunked) {
+        metadata.m_version = SnapshotMetadata::CHUNKED_VERSION;
+        metadata.m_chunk_count = SNAPSHOT_CHUNKS;
+    }
 
     afile << metadata;
 
-    COutPoint key;
-    Txid last_hash;
-    Coin coin;
-    unsigned int iter{0};
-    size_t written_coins_count{0};
-    std::vector<std::pair<uint32_t, Coin>> coins;
-
-    // To reduce space the serialization format of the snapshot avoids
-    // duplication of tx hashes. The code takes advantage of the guarantee by
-    // leveldb that keys are lexicographically sorted.
-    // In the coins vector we collect all coins that belong to a certain tx hash
-    // (key.hash) and when we have them all (key.hash != last_hash) we write
-    // them to file using the below lambda function.
-    // See also https://github.com/bitcoin/bitcoin/issues/25675
-    auto write_coins_to_file = [&](AutoFile& afile, const Txid& last_hash, const std::vector<std::pair<uint32_t, Coin>>& coins, size_t& written_coins_count) {
-        afile << last_hash;
-        WriteCompactSize(afile, coins.size());
-        for (const auto& [n, coin] : coins) {
-            WriteCompactSize(afile, n);
-            afile << coin;
-            ++written_coins_count;
-        }
+    // Every cursor serializes chunks on its own thread, at most two per
+    // cursor ahead of the one being written. The chunks are written here in
+    // order, so that the file does not depend on the number of threads. The
+    // unchunked format is the concatenation of the chunks without headers.
+    struct Chunk {
+        DataStream data;
+        uint64_t coins_count{0};
+        uint256 hash;
     };
+    Mutex mutex;
+    std::condition_variable cv;
+    std::map<uint32_t, Chunk> ready;
+    uint32_t next_chunk{0};
+    uint32_t written_chunks{0};
+    const uint32_t window{static_cast<uint32_t>(cursors.size() * 2)};
+    std::atomic<bool> stop{false};
+    std::atomic<bool> failed{false};
+
+    const auto serialize_chunks{[&](CCoinsViewCursor& cursor) {
+        WAIT_LOCK(mutex, lock);
+        while (true) {
+            cv.wait(lock, [&] { return stop || next_chunk >= SNAPSHOT_CHUNKS || next_chunk < written_chunks + window; });
+            if (stop || next_chunk >= SNAPSHOT_CHUNKS) return;
+            const uint32_t chunk{next_chunk++};
+            Chunk result;
+            bool ok;
+            {
+                REVERSE_LOCK(lock, mutex);
+                ok = cursor.Seek(COutPoint{node::SnapshotChunkStart(chunk), 0}) &&
+                     SerializeSnapshotChunk(cursor, chunk, result.data, result.coins_count, [&] { return !stop; });
+                if (ok && chunked) result.hash = Hash(result.data);
+            }
+            if (!ok) {
+                if (!stop) failed = true;
+                stop = true;
+                cv.notify_all();
+                return;
+            }
+            ready.emplace(chunk, std::move(result));
+            cv.notify_all();
+        }
+    }};
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        threads.emplace_back(&util::TraceThread, strprintf("dumptxout.%d", i), [&, i] {
+            try {
+                serialize_chunks(*cursors[i]);
+            } catch (const std::exception& e) {
+                LogError("%s: unable to read the UTXO set: %s\n", __func__, e.what());
+                failed = true;
+                WITH_LOCK(mutex, stop = true);
+                cv.notify_all();
+            }
+        });
+    }
+    const auto stop_threads{[&] {
+        WITH_LOCK(mutex, stop = true);
+        cv.notify_all();
+        for (std::thread& thread : threads) thread.join();
+    }};
 
-    pcursor->GetKey(key);
-    last_hash = key.hash;
-    while (pcursor->Valid()) {
-        if (iter % 5000 == 0) interruption_point();
-        ++iter;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
-            if (key.hash != last_hash) {
-                write_coins_to_file(afile, last_hash, coins, written_coins_count);
-                last_hash = key.hash;
-                coins.clear();
+    size_t written_coins_count{0};
+    try {
+        for (uint32_t chunk = 0; chunk < SNAPSHOT_CHUNKS; ++chunk) {
+            interruption_point();
+            Chunk data;
+            {
+                WAIT_LOCK(mutex, lock);
+                while (!failed && !ready.contains(chunk)) {
+                    if (cv.wait_for(lock, std::chrono::milliseconds{100}) == std::cv_status::timeout) {
+                        REVERSE_LOCK(lock, mutex);
+                        interruption_point();
+                    }
+                }
+                if (failed) break;
+                data = std::move(ready.extract(chunk).mapped());
+                ++written_chunks;
             }
-            coins.emplace_back(key.n, coin);
+            cv.notify_all();
+            if (chunked) afile << SnapshotChunkHeader{data.coins_count, data.data.size(), data.hash};
+            afile.write(std::span<const std::byte>{data.data.data(), data.data.size()});
+            written_coins_count += data.coins_count;
         }
-        pcursor->Next();
+    } catch (...) {
+        stop_threads();
+        throw;
     }
-
-    if (!coins.empty()) {
-        write_coins_to_file(afile, last_hash, coins, written_coins_count);
+    stop_threads();
+    if (failed) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
     }
 
     CHECK_NONFATAL(written_coins_count == maybe_stats->coins_count);
@@ -3242,10 +3736,11 @@ UniValue CreateUTXOSnapshot(
     Chainstate& chainstate,
     AutoFile& afile,
     const fs::path& path,
-    const fs::path& tmppath)
+    const fs::path& tmppath,
+    bool chunked)
 {
-    auto [cursor, stats, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate, node.rpc_interruption_point))};
-    return WriteUTXOSnapshot(chainstate, cursor.get(), &stats, tip, afile, path, tmppath, node.rpc_interruption_point);
+    auto [cursors, stats, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate, node.rpc_interruption_point, /*num_cursors=*/2))};
+    return WriteUTXOSnapshot(chainstate, cursors, &stats, tip, afile, path, tmppath, node.rpc_interruption_point, chunked);
 }
 
 static RPCHelpMan loadtxoutset()
@@ -3329,6 +3824,29 @@ static RPCHelpMan loadtxoutset()
     };
 }
 
+const std::vector<RPCResult> RPCHelpForBackgroundSync{
+    {RPCResult::Type::BOOL, "paused", "whether background validation is paused"},
+    {RPCResult::Type::NUM, "script_threads", "number of script verification worker threads used by background validation"},
+    {RPCResult::Type::NUM, "cache_percent", "share of the coins caches given to the background chainstate once the snapshot chainstate has caught up, in percent"},
+    {RPCResult::Type::NUM, "progress", "fraction of the transactions up to the snapshot base block that have been validated"},
+    {RPCResult::Type::NUM, "blocks_per_second", /*optional=*/true, "blocks validated per second since background validation started or was last resumed"},
+    {RPCResult::Type::NUM, "transactions_per_second", /*optional=*/true, "transactions validated per second since background validation started or was last resumed"},
+    {RPCResult::Type::NUM, "remaining_seconds", /*optional=*/true, "estimated time until the snapshot base block is reached at that rate"},
+};
+
+static UniValue BackgroundSyncInfoToJSON(const ChainstateManager::BackgroundSyncInfo& info)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("paused", info.paused);
+    obj.pushKV("script_threads", info.script_threads);
+    obj.pushKV("cache_percent", info.cache_percent);
+    obj.pushKV("progress", info.progress);
+    if (info.blocks_per_second) obj.pushKV("blocks_per_second", *info.blocks_per_second);
+    if (info.transactions_per_second) obj.pushKV("transactions_per_second", *info.transactions_per_second);
+    if (info.remaining) obj.pushKV("remaining_seconds", count_seconds(*info.remaining));
+    return obj;
+}
+
 const std::vector<RPCResult> RPCHelpForChainstate{
     {RPCResult::Type::NUM, "blocks", "number of blocks in this chainstate"},
     {RPCResult::Type::STR_HEX, "bestblockhash", "blockhash of the tip"},
@@ -3340,6 +3858,7 @@ const std::vector<RPCResult> RPCHelpForChainstate{
     {RPCResult::Type::NUM, "coins_db_cache_bytes", "size of the coinsdb cache"},
     {RPCResult::Type::NUM, "coins_tip_cache_bytes", "size of the coinstip cache"},
     {RPCResult::Type::BOOL, "validated", "whether the chainstate is fully validated. True if all blocks in the chainstate were validated, false if the chain is based on a snapshot and the snapshot has not yet been validated."},
+    {RPCResult::Type::OBJ, "background_validation", /*optional=*/true, "progress of the validation of the snapshot, only for the background chainstate while it is validating one", RPCHelpForBackgroundSync},
 };
 
 static RPCHelpMan getchainstates()
@@ -3386,6 +3905,9 @@ return RPCHelpMan{
             data.pushKV("snapshot_blockhash", cs.m_from_snapshot_blockhash->ToString());
         }
         data.pushKV("validated", validated);
+        if (!cs.m_from_snapshot_blockhash) {
+            if (const auto info{chainman.GetBackgroundSyncInfo()}) data.pushKV("background_validation", BackgroundSyncInfoToJSON(*info));
+        }
         return data;
     };
 
@@ -3402,6 +3924,52 @@ return RPCHelpMan{
     };
 }
 
+static RPCHelpMan setbackgroundvalidation()
+{
+    return RPCHelpMan{
+        "setbackgroundvalidation",
+        "Change how the background chainstate validating an assumeutxo snapshot is scheduled.\n"
+        "While paused, no blocks are downloaded for or connected to the background chainstate, and its coins cache "
+        "shrinks to the share it has while the snapshot chainstate is in initial block download.\n",
+        {
+            {"paused", RPCArg::Type::BOOL, RPCArg::Optional::OMITTED, "Pause (true) or resume (false) background validation"},
+            {"cache_percent", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "Share of the coins caches, between 1 and 99 percent, given to the background chainstate once the snapshot chainstate has caught up"},
+        },
+        RPCResult{RPCResult::Type::OBJ, "", "the state of background validation", RPCHelpForBackgroundSync},
+        RPCExamples{
+            HelpExampleCli("-named setbackgroundvalidation", "paused=true")
+    + HelpExampleCli("-named setbackgroundvalidation", "paused=false cache_percent=80")
+    + HelpExampleRpc("setbackgroundvalidation", "false, 80")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    if (!WITH_LOCK(::cs_main, return chainman.BackgroundSyncInProgress())) {
+        throw JSONRPCError(RPC_MISC_ERROR, "No background validation in progress");
+    }
+
+    if (!request.params[1].isNull()) {
+        const int percent{request.params[1].getInt<int>()};
+        if (percent < 1 || percent > 99) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "cache_percent must be between 1 and 99");
+        }
+        WITH_LOCK(::cs_main, chainman.SetBackgroundCachePercent(percent));
+    }
+    if (!request.params[0].isNull()) {
+        if (!chainman.SetBackgroundSyncPaused(request.params[0].get_bool())) {
+            throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to connect blocks to the background chainstate");
+        }
+    }
+
+    LOCK(::cs_main);
+    const auto info{chainman.GetBackgroundSyncInfo()};
+    if (!info) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Background validation completed");
+    }
+    return BackgroundSyncInfoToJSON(*info);
+}
+    };
+}
 
 void RegisterBlockchainRPCCommands(CRPCTable& t)
 {
@@ -3426,10 +3994,12 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &scantxoutset},
         {"blockchain", &scanblocks},
         {"blockchain", &getdescriptoractivity},
+        {"blockchain", &getscripthistory},
         {"blockchain", &getblockfilter},
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
+        {"blockchain", &setbackgroundvalidation},
         {"hidden", &invalidateblock},
         {"hidden", &reconsiderblock},
         {"hidden", &waitfornewblock},
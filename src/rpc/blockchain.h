@@ -5,6 +5,7 @@
 #ifndef BITCOIN_RPC_BLOCKCHAIN_H
 #define BITCOIN_RPC_BLOCKCHAIN_H
 
+#include <blockfilter.h>
 #include <consensus/amount.h>
 #include <core_io.h>
 #include <streams.h>
@@ -13,13 +14,20 @@
 #include <validation.h>
 
 #include <any>
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
+#include <thread>
 #include <vector>
 
 class CBlock;
 class CBlockIndex;
 class Chainstate;
+class ChainstateManager;
+class CScript;
+class JSONStreamWriter;
 class UniValue;
+struct ScriptHistoryEntry;
 namespace node {
 class BlockManager;
 struct NodeContext;
@@ -27,6 +35,10 @@ struct NodeContext;
 
 static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
 
+//! Default and maximum number of events returned by getscripthistory and /rest/scripthistory/.
+static constexpr int DEFAULT_SCRIPT_HISTORY_LIMIT{1000};
+static constexpr int MAX_SCRIPT_HISTORY_LIMIT{100000};
+
 /**
  * Get the difficulty of the net wrt to the given block index.
  *
@@ -38,6 +50,9 @@ double GetDifficulty(const CBlockIndex& blockindex);
 /** Block description to JSON */
 UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
+/** Block description to JSON, written to a stream one transaction at a time */
+void blockToJSON(JSONStreamWriter& stream, node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
+
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
@@ -53,10 +68,61 @@ UniValue CreateUTXOSnapshot(
     Chainstate& chainstate,
     AutoFile& afile,
     const fs::path& path,
-    const fs::path& tmppath);
+    const fs::path& tmppath,
+    bool chunked = false);
 
 //! Return height of highest block that has been pruned, or std::nullopt if no blocks have been pruned
 std::optional<int> GetPruneHeight(const node::BlockManager& blockman, const CChain& chain) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+/** One script history event to JSON, as in getscripthistory */
+UniValue ScriptHistoryEntryToJSON(const ScriptHistoryEntry& entry, const CScript& script, const uint256& block_hash);
+
+/**
+ * Look up the history of the scripts in the script index and return it as in getscripthistory.
+ * Throws a JSONRPCError if the index is not available or the arguments are invalid.
+ */
+UniValue ScriptHistoryToJSON(ChainstateManager& chainman, const std::vector<CScript>& scripts, int start_height, int limit) LOCKS_EXCLUDED(cs_main);
+
+/**
+ * Matches block filters against a set of needles for scanblocks. The filters are spread over a
+ * fixed set of worker threads, which is reused for every chunk of filters a scanblocks call looks up.
+ */
+class BlockFilterMatcher
+{
+public:
+    BlockFilterMatcher(const GCSFilter::ElementSet& needles, int num_threads);
+    ~BlockFilterMatcher();
+
+    /**
+     * Return whether each filter matches any of the needles. Rethrows the first exception matching
+     * a filter threw, such as for a filter that turns out to be truncated.
+     */
+    std::vector<char> Match(const std::vector<BlockFilter>& filters) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    /** Claim and match batches of the current filters until none are left. */
+    void MatchBatches() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void WorkerLoop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    const GCSFilter::ElementSet& m_needles;
+    std::vector<std::thread> m_workers;
+
+    Mutex m_mutex;
+    //! Workers wait on this for filters to match.
+    std::condition_variable m_work_cv;
+    //! Match() waits on this for the workers to finish the last batches.
+    std::condition_variable m_done_cv;
+    bool m_stop GUARDED_BY(m_mutex){false};
+    //! The filters being matched and their results, set for the duration of a Match() call.
+    const std::vector<BlockFilter>* m_filters GUARDED_BY(m_mutex){nullptr};
+    std::vector<char>* m_matches GUARDED_BY(m_mutex){nullptr};
+    //! Index of the first filter not claimed by any thread yet.
+    size_t m_next GUARDED_BY(m_mutex){0};
+    //! Number of filters not matched yet.
+    size_t m_pending GUARDED_BY(m_mutex){0};
+    //! The first exception matching a filter threw during the current Match() call.
+    std::exception_ptr m_error GUARDED_BY(m_mutex);
+};
+
 void CheckBlockDataAvailability(node::BlockManager& blockman, const CBlockIndex& blockindex, bool check_for_undo) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
 #endif // BITCOIN_RPC_BLOCKCHAIN_H
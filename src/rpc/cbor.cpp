@@ -0,0 +1,379 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/cbor.h>
+
+#include <univalue.h>
+#include <univalue_utffilter.h>
+#include <util/strencodings.h>
+#include <util/string.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+
+using util::SplitString;
+using util::TrimStringView;
+
+namespace {
+
+enum MajorType : uint8_t {
+    CBOR_UINT = 0,
+    CBOR_NEGINT = 1,
+    CBOR_BYTES = 2,
+    CBOR_TEXT = 3,
+    CBOR_ARRAY = 4,
+    CBOR_MAP = 5,
+    CBOR_TAG = 6,
+    CBOR_SIMPLE = 7,
+};
+
+constexpr uint8_t CBOR_FALSE{20};
+constexpr uint8_t CBOR_TRUE{21};
+constexpr uint8_t CBOR_NULL{22};
+constexpr uint8_t CBOR_HALF{25};
+constexpr uint8_t CBOR_SINGLE{26};
+constexpr uint8_t CBOR_DOUBLE{27};
+constexpr uint64_t CBOR_TAG_DECIMAL_FRACTION{4};
+
+//! Same limit as the JSON parser.
+constexpr size_t MAX_CBOR_DEPTH{512};
+//! Most digits after the decimal point of a decimal fraction.
+constexpr unsigned int MAX_DECIMAL_SCALE{64};
+
+void WriteHead(std::vector<std::byte>& out, uint8_t major, uint64_t arg)
+{
+    const uint8_t type{uint8_t(major << 5)};
+    int size;
+    if (arg < 24) {
+        out.push_back(std::byte(type | arg));
+        return;
+    } else if (arg <= std::numeric_limits<uint8_t>::max()) {
+        out.push_back(std::byte(type | 24));
+        size = 1;
+    } else if (arg <= std::numeric_limits<uint16_t>::max()) {
+        out.push_back(std::byte(type | 25));
+        size = 2;
+    } else if (arg <= std::numeric_limits<uint32_t>::max()) {
+        out.push_back(std::byte(type | 26));
+        size = 4;
+    } else {
+        out.push_back(std::byte(type | 27));
+        size = 8;
+    }
+    for (int i{size - 1}; i >= 0; --i) {
+        out.push_back(std::byte(arg >> (8 * i)));
+    }
+}
+
+void WriteInt(std::vector<std::byte>& out, int64_t value)
+{
+    if (value >= 0) {
+        WriteHead(out, CBOR_UINT, uint64_t(value));
+    } else {
+        WriteHead(out, CBOR_NEGINT, uint64_t(-(value + 1)));
+    }
+}
+
+/** Write `mantissa` * 10^-`scale` with exactly `scale` digits after the decimal point. */
+std::string FormatDecimal(int64_t mantissa, unsigned int scale)
+{
+    const bool negative{mantissa < 0};
+    const uint64_t magnitude{negative ? uint64_t{0} - uint64_t(mantissa) : uint64_t(mantissa)};
+    std::string digits{std::to_string(magnitude)};
+    if (scale > 0) {
+        if (digits.size() <= scale) digits.insert(0, scale + 1 - digits.size(), '0');
+        digits.insert(digits.size() - scale, ".");
+    }
+    return negative ? "-" + digits : digits;
+}
+
+void WriteNumber(std::vector<std::byte>& out, const UniValue& value)
+{
+    const std::string& num{value.getValStr()};
+    // Only write numbers in a form that decodes to the same text.
+    if (const auto i{ToIntegral<int64_t>(num)}; i && std::to_string(*i) == num) {
+        WriteInt(out, *i);
+        return;
+    }
+    if (const auto u{ToIntegral<uint64_t>(num)}; u && std::to_string(*u) == num) {
+        WriteHead(out, CBOR_UINT, *u);
+        return;
+    }
+    if (const size_t dot{num.find('.')}; dot != std::string::npos && num.size() - dot - 1 <= MAX_DECIMAL_SCALE) {
+        const unsigned int scale(num.size() - dot - 1);
+        const auto mantissa{ToIntegral<int64_t>(num.substr(0, dot) + num.substr(dot + 1))};
+        if (mantissa && FormatDecimal(*mantissa, scale) == num) {
+            WriteHead(out, CBOR_TAG, CBOR_TAG_DECIMAL_FRACTION);
+            WriteHead(out, CBOR_ARRAY, 2);
+            WriteInt(out, -int64_t{scale});
+            WriteInt(out, *mantissa);
+            return;
+        }
+    }
+    out.push_back(std::byte((CBOR_SIMPLE << 5) | CBOR_DOUBLE));
+    const uint64_t bits{std::bit_cast<uint64_t>(value.get_real())};
+    for (int i{7}; i >= 0; --i) {
+        out.push_back(std::byte(bits >> (8 * i)));
+    }
+}
+
+bool IsLowerHex(const std::string& str)
+{
+    return IsHex(str) && std::ranges::none_of(str, [](char c) { return c >= 'A' && c <= 'F'; });
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void WriteValue(std::vector<std::byte>& out, const UniValue& value)
+{
+    switch (value.getType()) {
+    case UniValue::VNULL:
+        out.push_back(std::byte((CBOR_SIMPLE << 5) | CBOR_NULL));
+        break;
+    case UniValue::VBOOL:
+        out.push_back(std::byte((CBOR_SIMPLE << 5) | (value.isTrue() ? CBOR_TRUE : CBOR_FALSE)));
+        break;
+    case UniValue::VNUM:
+        WriteNumber(out, value);
+        break;
+    case UniValue::VSTR: {
+        const std::string& str{value.get_str()};
+        if (IsLowerHex(str)) {
+            WriteHead(out, CBOR_BYTES, str.size() / 2);
+            const auto bytes{ParseHex<std::byte>(str)};
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        } else {
+            WriteHead(out, CBOR_TEXT, str.size());
+            const auto bytes{std::as_bytes(std::span{str})};
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+        break;
+    }
+    case UniValue::VARR:
+        WriteHead(out, CBOR_ARRAY, value.size());
+        for (const UniValue& item : value.getValues()) {
+            WriteValue(out, item);
+        }
+        break;
+    case UniValue::VOBJ:
+        WriteHead(out, CBOR_MAP, value.size());
+        for (size_t i{0}; i < value.size(); ++i) {
+            const std::string& key{value.getKeys()[i]};
+            WriteHead(out, CBOR_TEXT, key.size());
+            const auto bytes{std::as_bytes(std::span{key})};
+            out.insert(out.end(), bytes.begin(), bytes.end());
+            WriteValue(out, value.getValues()[i]);
+        }
+        break;
+    }
+}
+
+double HalfToDouble(uint16_t half)
+{
+    const int exponent{(half >> 10) & 0x1f};
+    const int mantissa{half & 0x3ff};
+    double value;
+    if (exponent == 0) {
+        value = std::ldexp(mantissa, -24);
+    } else if (exponent != 31) {
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+    } else {
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+class Decoder
+{
+public:
+    explicit Decoder(std::span<const std::byte> data) : m_data{data} {}
+
+    bool AtEnd() const { return m_pos == m_data.size(); }
+
+    // NOLINTNEXTLINE(misc-no-recursion)
+    bool ReadValue(UniValue& value, size_t depth)
+    {
+        uint8_t major, info;
+        uint64_t arg;
+        if (!ReadHead(major, info, arg)) return false;
+        switch (major) {
+        case CBOR_UINT:
+            value = UniValue{arg};
+            return true;
+        case CBOR_NEGINT:
+            if (arg > uint64_t(std::numeric_limits<int64_t>::max())) return false;
+            value = UniValue{-1 - int64_t(arg)};
+            return true;
+        case CBOR_BYTES: {
+            if (arg > Remaining()) return false;
+            value = UniValue{HexStr(Take(arg))};
+            return true;
+        }
+        case CBOR_TEXT:
+            return ReadText(arg, value);
+        case CBOR_ARRAY:
+            // Every item takes at least one byte.
+            if (arg > Remaining() || depth >= MAX_CBOR_DEPTH) return false;
+            value = UniValue{UniValue::VARR};
+            for (uint64_t i{0}; i < arg; ++i) {
+                UniValue item;
+                if (!ReadValue(item, depth + 1)) return false;
+                value.push_back(std::move(item));
+            }
+            return true;
+        case CBOR_MAP:
+            if (arg > Remaining() / 2 || depth >= MAX_CBOR_DEPTH) return false;
+            value = UniValue{UniValue::VOBJ};
+            for (uint64_t i{0}; i < arg; ++i) {
+                uint8_t key_major, key_info;
+                uint64_t key_size;
+                UniValue key, item;
+                if (!ReadHead(key_major, key_info, key_size) || key_major != CBOR_TEXT || !ReadText(key_size, key)) return false;
+                if (!ReadValue(item, depth + 1)) return false;
+                value.pushKVEnd(key.get_str(), std::move(item));
+            }
+            return true;
+        case CBOR_TAG:
+            return arg == CBOR_TAG_DECIMAL_FRACTION && ReadDecimalFraction(value);
+        case CBOR_SIMPLE:
+            return ReadSimple(info, arg, value);
+        }
+        return false;
+    }
+
+private:
+    std::span<const std::byte> m_data;
+    size_t m_pos{0};
+
+    size_t Remaining() const { return m_data.size() - m_pos; }
+
+    std::span<const std::byte> Take(size_t size)
+    {
+        const auto taken{m_data.subspan(m_pos, size)};
+        m_pos += size;
+        return taken;
+    }
+
+    bool ReadHead(uint8_t& major, uint8_t& info, uint64_t& arg)
+    {
+        if (Remaining() < 1) return false;
+        const uint8_t initial{std::to_integer<uint8_t>(m_data[m_pos++])};
+        major = initial >> 5;
+        info = initial & 0x1f;
+        if (info < 24) {
+            arg = info;
+            return true;
+        }
+        // Reserved values and indefinite lengths are not supported.
+        if (info > 27) return false;
+        const size_t size{size_t{1} << (info - 24)};
+        if (Remaining() < size) return false;
+        arg = 0;
+        for (const std::byte b : Take(size)) {
+            arg = (arg << 8) | std::to_integer<uint8_t>(b);
+        }
+        return true;
+    }
+
+    bool ReadText(uint64_t size, UniValue& value)
+    {
+        if (size > Remaining()) return false;
+        std::string str;
+        JSONUTF8StringFilter writer{str};
+        for (const std::byte b : Take(size)) {
+            writer.push_back(std::to_integer<unsigned char>(b));
+        }
+        if (!writer.finalize()) return false;
+        value = UniValue{std::move(str)};
+        return true;
+    }
+
+    bool ReadInt(int64_t& value)
+    {
+        uint8_t major, info;
+        uint64_t arg;
+        if (!ReadHead(major, info, arg) || arg > uint64_t(std::numeric_limits<int64_t>::max())) return false;
+        if (major == CBOR_UINT) {
+            value = int64_t(arg);
+        } else if (major == CBOR_NEGINT) {
+            value = -1 - int64_t(arg);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    bool ReadDecimalFraction(UniValue& value)
+    {
+        uint8_t major, info;
+        uint64_t arg;
+        int64_t exponent, mantissa;
+        if (!ReadHead(major, info, arg) || major != CBOR_ARRAY || arg != 2) return false;
+        if (!ReadInt(exponent) || !ReadInt(mantissa)) return false;
+        if (exponent > 0 || exponent < -int64_t{MAX_DECIMAL_SCALE}) return false;
+        value.setNumStr(FormatDecimal(mantissa, unsigned(-exponent)));
+        return true;
+    }
+
+    bool ReadSimple(uint8_t info, uint64_t arg, UniValue& value)
+    {
+        double real;
+        switch (info) {
+        case CBOR_FALSE:
+            value = UniValue{false};
+            return true;
+        case CBOR_TRUE:
+            value = UniValue{true};
+            return true;
+        case CBOR_NULL:
+            value = NullUniValue;
+            return true;
+        case CBOR_HALF:
+            real = HalfToDouble(uint16_t(arg));
+            break;
+        case CBOR_SINGLE:
+            real = std::bit_cast<float>(uint32_t(arg));
+            break;
+        case CBOR_DOUBLE:
+            real = std::bit_cast<double>(arg);
+            break;
+        default:
+            return false;
+        }
+        // JSON has no infinities or NaNs.
+        if (!std::isfinite(real)) return false;
+        value = UniValue{real};
+        return true;
+    }
+};
+
+} // namespace
+
+std::vector<std::byte> EncodeCBOR(const UniValue& value)
+{
+    std::vector<std::byte> out;
+    WriteValue(out, value);
+    return out;
+}
+
+std::optional<UniValue> DecodeCBOR(std::span<const std::byte> data)
+{
+    Decoder decoder{data};
+    UniValue value;
+    if (!decoder.ReadValue(value, /*depth=*/0) || !decoder.AtEnd()) return std::nullopt;
+    return value;
+}
+
+bool IsCBORMediaType(std::string_view header)
+{
+    for (const std::string& range : SplitString(header, ',')) {
+        const std::string_view type{TrimStringView(std::string_view{range}.substr(0, range.find(';')))};
+        if (ToLower(type) == CBOR_MEDIA_TYPE) return true;
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPC_CBOR_H
+#define BITCOIN_RPC_CBOR_H
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+class UniValue;
+
+/** Media type of RPC requests and replies in the binary encoding. */
+static constexpr std::string_view CBOR_MEDIA_TYPE{"application/cbor"};
+
+/**
+ * Binary encoding of RPC requests and replies in CBOR (RFC 8949), as an
+ * alternative to JSON for clients that make many calls or move a lot of raw
+ * data. Every UniValue maps to one CBOR data item and back:
+ *
+ * - null, true and false are the CBOR simple values.
+ * - Numbers that are integers are CBOR integers. Other numbers are decimal
+ *   fractions (tag 4), which keep their digits (e.g. "0.00010000"), or
+ *   doubles if they cannot be written as one.
+ * - Strings made up of an even number of lowercase hex digits, such as raw
+ *   transactions, blocks and hashes, are CBOR byte strings holding the bytes
+ *   the digits stand for. Other strings are text strings.
+ * - Arrays and objects are CBOR arrays and maps with text keys.
+ *
+ * Decoding accepts the same items, as well as half and single precision
+ * floats, and rejects indefinite lengths, other tags, non-text map keys,
+ * text that is not UTF-8 and trailing data.
+ */
+std::vector<std::byte> EncodeCBOR(const UniValue& value);
+
+/** Decode a CBOR data item. Returns std::nullopt if it is malformed or not supported. */
+std::optional<UniValue> DecodeCBOR(std::span<const std::byte> data);
+
+/** Whether a Content-Type or Accept header value names CBOR_MEDIA_TYPE. */
+bool IsCBORMediaType(std::string_view header);
+
+#endif // BITCOIN_RPC_CBOR_H
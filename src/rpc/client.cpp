@@ -94,6 +94,9 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getdescriptoractivity", 0, "blockhashes" },
     { "getdescriptoractivity", 1, "scanobjects" },
     { "getdescriptoractivity", 2, "include_mempool" },
+    { "getscripthistory", 0, "scanobjects" },
+    { "getscripthistory", 1, "start_height" },
+    { "getscripthistory", 2, "limit" },
     { "scantxoutset", 1, "scanobjects" },
     { "createmultisig", 0, "nrequired" },
     { "createmultisig", 1, "keys" },
@@ -189,6 +192,9 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "gettxoutsetinfo", 2, "use_index"},
     { "dumptxoutset", 2, "options" },
     { "dumptxoutset", 2, "rollback" },
+    { "dumptxoutset", 2, "chunked" },
+    { "setbackgroundvalidation", 0, "paused" },
+    { "setbackgroundvalidation", 1, "cache_percent" },
     { "lockunspent", 0, "unlock" },
     { "lockunspent", 1, "transactions" },
     { "lockunspent", 2, "persistent" },
@@ -260,6 +266,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getmempoolancestors", 1, "verbose" },
     { "getmempooldescendants", 1, "verbose" },
     { "gettxspendingprevout", 0, "outputs" },
+    { "gettxspendingprevout", 1, "options" },
+    { "gettxspendingprevout", 1, "mempool_only" },
     { "bumpfee", 1, "options" },
     { "bumpfee", 1, "conf_target"},
     { "bumpfee", 1, "fee_rate"},
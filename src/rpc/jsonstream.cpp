@@ -0,0 +1,132 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/jsonstream.h>
+
+#include <crypto/hex_base.h>
+#include <univalue.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <utility>
+
+JSONStreamWriter::JSONStreamWriter(Sink sink, size_t flush_size)
+    : m_sink{std::move(sink)}, m_flush_size{std::max<size_t>(flush_size, 1)}
+{
+}
+
+void JSONStreamWriter::BeforeValue()
+{
+    if (m_after_key) {
+        m_after_key = false;
+        return;
+    }
+    if (!m_empty.empty()) {
+        if (!m_empty.back()) Append(",");
+        m_empty.back() = false;
+    }
+}
+
+void JSONStreamWriter::Append(std::string_view data)
+{
+    if (m_failed) return;
+    m_written += data.size();
+    m_buffer.append(data);
+    if (m_sink && m_buffer.size() >= m_flush_size) Flush();
+}
+
+void JSONStreamWriter::BeginObject()
+{
+    BeforeValue();
+    Append("{");
+    m_empty.push_back(true);
+}
+
+void JSONStreamWriter::EndObject()
+{
+    Assume(!m_empty.empty() && !m_after_key);
+    m_empty.pop_back();
+    Append("}");
+}
+
+void JSONStreamWriter::BeginArray()
+{
+    BeforeValue();
+    Append("[");
+    m_empty.push_back(true);
+}
+
+void JSONStreamWriter::EndArray()
+{
+    Assume(!m_empty.empty() && !m_after_key);
+    m_empty.pop_back();
+    Append("]");
+}
+
+void JSONStreamWriter::Key(std::string_view key)
+{
+    Assume(!m_after_key);
+    BeforeValue();
+    Append(UniValue{std::string{key}}.write());
+    Append(":");
+    m_after_key = true;
+}
+
+void JSONStreamWriter::Value(const UniValue& value)
+{
+    BeforeValue();
+    Append(value.write());
+}
+
+void JSONStreamWriter::Entries(const UniValue& obj)
+{
+    const auto& keys{obj.getKeys()};
+    const auto& values{obj.getValues()};
+    for (size_t i{0}; i < keys.size(); ++i) {
+        KeyValue(keys[i], values[i]);
+    }
+}
+
+void JSONStreamWriter::RawValue(std::string_view json)
+{
+    BeforeValue();
+    // Pass large values on in parts, so that they are not copied as a whole.
+    while (!json.empty() && !m_failed) {
+        const size_t size{std::min(json.size(), m_sink ? m_flush_size : json.size())};
+        Append(json.substr(0, size));
+        json.remove_prefix(size);
+    }
+}
+
+void JSONStreamWriter::HexValue(std::span<const std::byte> data)
+{
+    BeforeValue();
+    Append("\"");
+    // Encode in parts of about the flush size straight into the buffer.
+    while (!data.empty() && !m_failed) {
+        const size_t size{std::min(data.size(), m_sink ? m_flush_size / 2 + 1 : data.size())};
+        const size_t pos{m_buffer.size()};
+        m_buffer.resize(pos + size * 2);
+        HexEncode(data.first(size), std::span{m_buffer}.subspan(pos));
+        m_written += size * 2;
+        if (m_sink && m_buffer.size() >= m_flush_size) Flush();
+        data = data.subspan(size);
+    }
+    Append("\"");
+}
+
+void JSONStreamWriter::Flush()
+{
+    if (m_failed || !m_sink || m_buffer.empty()) return;
+    m_flushed = true;
+    if (!m_sink(m_buffer)) {
+        m_failed = true;
+    }
+    m_buffer.clear();
+}
+
+std::string JSONStreamWriter::TakeBuffer()
+{
+    return std::exchange(m_buffer, {});
+}
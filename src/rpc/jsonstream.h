@@ -0,0 +1,91 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPC_JSONSTREAM_H
+#define BITCOIN_RPC_JSONSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class UniValue;
+
+/**
+ * Writes a JSON document piece by piece and passes it on to a sink in parts of
+ * about `flush_size` bytes, so that large results (blocks with full
+ * transaction details, the verbose mempool) do not have to be built as one
+ * UniValue tree and serialized into one string before they can be sent.
+ *
+ * Structure (objects, arrays, keys) is written with the Begin/End/Key calls;
+ * leaves and small subtrees are written as UniValues. The writer does not
+ * check that the calls form a valid document beyond placing commas.
+ */
+class JSONStreamWriter
+{
+public:
+    //! Receives the output. Returns false if the rest of the output is not wanted,
+    //! e.g. because the client went away.
+    using Sink = std::function<bool(std::string_view)>;
+
+    static constexpr size_t DEFAULT_FLUSH_SIZE{64 << 10};
+
+    //! Without a sink, all output is kept in the buffer.
+    explicit JSONStreamWriter(Sink sink = {}, size_t flush_size = DEFAULT_FLUSH_SIZE);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+    //! Write an object key, which must be followed by its value.
+    void Key(std::string_view key);
+    void Value(const UniValue& value);
+    void KeyValue(std::string_view key, const UniValue& value)
+    {
+        Key(key);
+        Value(value);
+    }
+    //! Write all key/value pairs of the object `obj` into the current object.
+    void Entries(const UniValue& obj);
+    //! Write a value that is already serialized as JSON.
+    void RawValue(std::string_view json);
+    //! Write the hex encoding of `data` as a string value, without building it first.
+    void HexValue(std::span<const std::byte> data);
+
+    //! Pass all buffered output to the sink.
+    void Flush();
+
+    //! Whether the sink refused output. Further output is dropped, so callers
+    //! producing a lot of it should check this and stop early.
+    bool Failed() const { return m_failed; }
+    //! Whether any output was passed to the sink.
+    bool Flushed() const { return m_flushed; }
+    //! Whether a key was written without its value.
+    bool AwaitingValue() const { return m_after_key; }
+    //! Number of objects and arrays that are open.
+    size_t Depth() const { return m_empty.size(); }
+    //! Total size of the output so far.
+    uint64_t Written() const { return m_written; }
+    //! Take the output that was not passed to the sink yet.
+    std::string TakeBuffer();
+
+private:
+    void BeforeValue();
+    void Append(std::string_view data);
+
+    const Sink m_sink;
+    const size_t m_flush_size;
+    std::string m_buffer;
+    //! For every open object or array, whether nothing was written into it yet.
+    std::vector<bool> m_empty;
+    bool m_after_key{false};
+    uint64_t m_written{0};
+    bool m_flushed{false};
+    bool m_failed{false};
+};
+
+#endif // BITCOIN_RPC_JSONSTREAM_H
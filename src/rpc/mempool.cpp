@@ -10,6 +10,7 @@
 #include <chainparams.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <index/txospenderindex.h>
 #include <kernel/mempool_entry.h>
 #include <net_processing.h>
 #include <node/mempool_persist_args.h>
@@ -17,6 +18,7 @@
 #include <policy/rbf.h>
 #include <policy/settings.h>
 #include <primitives/transaction.h>
+#include <rpc/jsonstream.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
@@ -381,6 +383,24 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
     }
 }
 
+void MempoolToJSON(JSONStreamWriter& stream, const CTxMemPool& pool)
+{
+    // Serialize the entries while holding the lock, which is released before
+    // the output is passed on and has to wait for the client.
+    JSONStreamWriter entries;
+    {
+        LOCK(pool.cs);
+        entries.BeginObject();
+        for (const CTxMemPoolEntry& e : pool.entryAll()) {
+            UniValue info(UniValue::VOBJ);
+            entryToJSON(pool, info, e);
+            entries.KeyValue(e.GetTx().GetHash().ToString(), info);
+        }
+        entries.EndObject();
+    }
+    stream.RawValue(entries.TakeBuffer());
+}
+
 static RPCHelpMan getrawmempool()
 {
     return RPCHelpMan{
@@ -427,6 +447,10 @@ static RPCHelpMan getrawmempool()
         include_mempool_sequence = request.params[1].get_bool();
     }
 
+    if (JSONStreamWriter* stream{request.m_result_stream}; stream && fVerbose && !include_mempool_sequence) {
+        MempoolToJSON(*stream, EnsureAnyMemPool(request.context));
+        return UniValue::VNULL;
+    }
     return MempoolToJSON(EnsureAnyMemPool(request.context), fVerbose, include_mempool_sequence);
 },
     };
@@ -593,10 +617,60 @@ static RPCHelpMan getmempoolentry()
     };
 }
 
+UniValue TxoSpendersToJSON(const CTxMemPool& mempool, const std::vector<COutPoint>& prevouts, bool mempool_only)
+{
+    if (!mempool_only) {
+        if (!g_txospender_index) {
+            throw JSONRPCError(RPC_MISC_ERROR, "Transaction output spender index is not enabled (start the node with -txospenderindex)");
+        }
+        if (!g_txospender_index->BlockUntilSyncedToCurrentChain()) {
+            throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because txospenderindex is still syncing. Current height: %d",
+                                                         g_txospender_index->GetSummary().best_block_height));
+        }
+    }
+
+    std::vector<const CTransaction*> mempool_spenders;
+    std::vector<COutPoint> confirmed_lookups;
+    {
+        LOCK(mempool.cs);
+        for (const COutPoint& prevout : prevouts) {
+            const CTransaction* spending_tx{mempool.GetConflictTx(prevout)};
+            mempool_spenders.push_back(spending_tx);
+            if (!spending_tx && !mempool_only) confirmed_lookups.push_back(prevout);
+        }
+    }
+    // Look up all outputs not spent in the mempool with one call, outside of the mempool lock.
+    std::vector<std::optional<TxoSpender>> confirmed_spenders;
+    if (!confirmed_lookups.empty()) confirmed_spenders = g_txospender_index->FindSpenders(confirmed_lookups);
+
+    UniValue result{UniValue::VARR};
+    auto confirmed_it{confirmed_spenders.begin()};
+    for (size_t i = 0; i < prevouts.size(); ++i) {
+        UniValue o(UniValue::VOBJ);
+        o.pushKV("txid", prevouts[i].hash.ToString());
+        o.pushKV("vout", (uint64_t)prevouts[i].n);
+
+        if (mempool_spenders[i] != nullptr) {
+            o.pushKV("spendingtxid", mempool_spenders[i]->GetHash().ToString());
+        } else if (!mempool_only) {
+            const std::optional<TxoSpender>& spender{*confirmed_it++};
+            if (spender) {
+                o.pushKV("spendingtxid", spender->txid.ToString());
+                o.pushKV("spendingvin", spender->vin);
+                o.pushKV("blockhash", spender->block_hash.GetHex());
+                o.pushKV("height", spender->height);
+            }
+        }
+
+        result.push_back(std::move(o));
+    }
+    return result;
+}
+
 static RPCHelpMan gettxspendingprevout()
 {
     return RPCHelpMan{"gettxspendingprevout",
-        "Scans the mempool to find transactions spending any of the given outputs",
+        "Scans the mempool, and the transaction output spender index if enabled, to find transactions spending any of the given outputs",
         {
             {"outputs", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction outputs that we want to check, and within each, the txid (string) vout (numeric).",
                 {
@@ -608,6 +682,11 @@ static RPCHelpMan gettxspendingprevout()
                     },
                 },
             },
+            {"options", RPCArg::Type::OBJ_NAMED_PARAMS, RPCArg::Optional::OMITTED, "",
+                {
+                    {"mempool_only", RPCArg::Type::BOOL, RPCArg::DefaultHint{"true if txospenderindex is not enabled, false otherwise"}, "If false, look up outputs not spent in the mempool in the transaction output spender index"},
+                },
+            },
         },
         RPCResult{
             RPCResult::Type::ARR, "", "",
@@ -616,7 +695,10 @@ static RPCHelpMan gettxspendingprevout()
                 {
                     {RPCResult::Type::STR_HEX, "txid", "the transaction id of the checked output"},
                     {RPCResult::Type::NUM, "vout", "the vout value of the checked output"},
-                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the mempool transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the mempool or confirmed transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::NUM, "spendingvin", /*optional=*/true, "the index of the spending input (only for confirmed spends)"},
+                    {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "the hash of the block containing the spending transaction (only for confirmed spends)"},
+                    {RPCResult::Type::NUM, "height", /*optional=*/true, "the height of that block (only for confirmed spends)"},
                 }},
             }
         },
@@ -652,25 +734,18 @@ static RPCHelpMan gettxspendingprevout()
                 prevouts.emplace_back(txid, nOutput);
             }
 
-            const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-            LOCK(mempool.cs);
-
-            UniValue result{UniValue::VARR};
-
-            for (const COutPoint& prevout : prevouts) {
-                UniValue o(UniValue::VOBJ);
-                o.pushKV("txid", prevout.hash.ToString());
-                o.pushKV("vout", (uint64_t)prevout.n);
-
-                const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
-                if (spendingTx != nullptr) {
-                    o.pushKV("spendingtxid", spendingTx->GetHash().ToString());
-                }
-
-                result.push_back(std::move(o));
+            bool mempool_only{!g_txospender_index};
+            if (!request.params[1].isNull()) {
+                const UniValue& options{request.params[1].get_obj()};
+                RPCTypeCheckObj(options,
+                                {
+                                    {"mempool_only", UniValueType(UniValue::VBOOL)},
+                                }, /*fAllowNull=*/true, /*fStrict=*/true);
+                if (!options.find_value("mempool_only").isNull()) mempool_only = options.find_value("mempool_only").get_bool();
             }
 
-            return result;
+            const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
+            return TxoSpendersToJSON(mempool, prevouts, mempool_only);
         },
     };
 }
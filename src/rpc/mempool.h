@@ -5,7 +5,11 @@
 #ifndef BITCOIN_RPC_MEMPOOL_H
 #define BITCOIN_RPC_MEMPOOL_H
 
+#include <vector>
+
+class COutPoint;
 class CTxMemPool;
+class JSONStreamWriter;
 class UniValue;
 
 /** Mempool information to JSON */
@@ -14,4 +18,14 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool);
 /** Mempool to JSON */
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose = false, bool include_mempool_sequence = false);
 
+/** Verbose mempool to JSON, written to a stream */
+void MempoolToJSON(JSONStreamWriter& stream, const CTxMemPool& pool);
+
+/**
+ * Spenders of outputs to JSON, as in gettxspendingprevout. Unless mempool_only is set, outputs
+ * not spent in the mempool are looked up in the transaction output spender index, and a
+ * JSONRPCError is thrown if it is not available.
+ */
+UniValue TxoSpendersToJSON(const CTxMemPool& mempool, const std::vector<COutPoint>& prevouts, bool mempool_only);
+
 #endif // BITCOIN_RPC_MEMPOOL_H
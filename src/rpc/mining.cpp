@@ -43,6 +43,7 @@
 #include <validation.h>
 #include <validationinterface.h>
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 
@@ -809,6 +810,35 @@ static RPCHelpMan getblocktemplate()
             nTransactionsUpdatedLastLP = nTransactionsUpdatedLast;
         }
 
+        if (request.m_tip_wait && hashWatchedChain == tip) {
+            // Leave the wait to the server, which answers with a template once
+            // it is over, as if it was asked for one without a longpollid.
+            JSONRPCRequest template_request{request};
+            template_request.m_tip_wait = nullptr;
+            UniValue template_param{UniValue::VOBJ};
+            const UniValue& oparam{request.params[0].get_obj()};
+            for (size_t i{0}; i < oparam.size(); ++i) {
+                if (oparam.getKeys()[i] != "longpollid") template_param.pushKV(oparam.getKeys()[i], oparam[i]);
+            }
+            template_request.params.setArray();
+            template_request.params.push_back(std::move(template_param));
+
+            request.m_tip_wait->wake_at = std::chrono::steady_clock::now() + std::chrono::minutes{1};
+            request.m_tip_wait->poll = [&miner, &mempool, hashWatchedChain, nTransactionsUpdatedLastLP, template_request](auto& wake_at) -> std::optional<UniValue> {
+                if (!IsRPCRunning()) throw JSONRPCError(RPC_CLIENT_NOT_CONNECTED, "Shutting down");
+                if (CHECK_NONFATAL(miner.getTip()).value().hash == hashWatchedChain) {
+                    const auto now{std::chrono::steady_clock::now()};
+                    if (now < *wake_at) return std::nullopt;
+                    if (mempool.GetTransactionsUpdated() == nTransactionsUpdatedLastLP) {
+                        wake_at = now + std::chrono::seconds{10};
+                        return std::nullopt;
+                    }
+                }
+                return getblocktemplate().HandleRequest(template_request);
+            };
+            return UniValue{};
+        }
+
         // Release lock while waiting
         LEAVE_CRITICAL_SECTION(cs_main);
         {
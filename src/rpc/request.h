@@ -7,12 +7,16 @@
 #define BITCOIN_RPC_REQUEST_H
 
 #include <any>
+#include <chrono>
+#include <functional>
 #include <optional>
 #include <string>
 
 #include <univalue.h>
 #include <util/fs.h>
 
+class JSONStreamWriter;
+
 enum class JSONRPCVersion {
     V1_LEGACY,
     V2
@@ -49,6 +53,23 @@ void DeleteAuthCookie();
 /** Parse JSON-RPC batch reply into a vector */
 std::vector<UniValue> JSONRPCProcessBatchReply(const UniValue& in);
 
+/**
+ * Wait of a method for the chain tip to change, left to the server instead of
+ * blocking a thread (see JSONRPCRequest::m_tip_wait).
+ */
+struct RPCTipWait {
+    /**
+     * Finishes the call. It is called on an RPC thread after the tip changed,
+     * once `wake_at` passed, possibly at other times, and when RPC is shutting
+     * down. Returns the result of the method when the wait is over, or
+     * std::nullopt to keep waiting, after possibly moving `wake_at`. It may
+     * throw like the method, and must not keep waiting once !IsRPCRunning().
+     */
+    std::function<std::optional<UniValue>(std::optional<std::chrono::steady_clock::time_point>& wake_at)> poll;
+    //! When to call poll if the tip did not change by then.
+    std::optional<std::chrono::steady_clock::time_point> wake_at;
+};
+
 class JSONRPCRequest
 {
 public:
@@ -61,6 +82,17 @@ public:
     std::string peerAddr;
     std::any context;
     JSONRPCVersion m_json_version = JSONRPCVersion::V1_LEGACY;
+    /**
+     * If set, a method with a large result may write it to this stream, positioned where
+     * the result goes, instead of returning it. The return value is then ignored.
+     */
+    JSONStreamWriter* m_result_stream{nullptr};
+    /**
+     * If set, a method that would block until the chain tip changes may set
+     * the poll function of this wait and return right away instead. The
+     * return value is then ignored, and the result of poll is the result.
+     */
+    RPCTipWait* m_tip_wait{nullptr};
 
     void parse(const UniValue& valRequest);
     [[nodiscard]] bool IsNotification() const { return !id.has_value() && m_json_version == JSONRPCVersion::V2; };
@@ -9,6 +9,7 @@
 
 #include <common/args.h>
 #include <common/system.h>
+#include <httpserver.h>
 #include <logging.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
@@ -21,11 +22,15 @@
 #include <util/time.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 using util::SplitString;
 
@@ -218,6 +223,22 @@ static RPCHelpMan getrpcinfo()
                             }},
                         }},
                         {RPCResult::Type::STR, "logpath", "The complete file path to the debug log"},
+                        {RPCResult::Type::OBJ, "work_queue", /*optional=*/true, "Requests waiting for a worker thread (only present if the HTTP server is running)",
+                        {
+                            {RPCResult::Type::NUM, "depth", "The number of requests waiting"},
+                            {RPCResult::Type::NUM, "max_depth", "The maximum number of requests waiting (-rpcworkqueue)"},
+                            {RPCResult::Type::NUM, "clients", "The number of clients with requests waiting or being handled"},
+                            {RPCResult::Type::NUM, "rejected", "The number of requests rejected because the queue was full"},
+                            {RPCResult::Type::NUM, "cancelled", "The number of requests dropped because their client disconnected while they were waiting"},
+                            {RPCResult::Type::ARR_FIXED, "queue_time_ms", "Histogram of the time requests waited: the number that waited under 1 ms, from 1 to under 2 ms, from 2 to under 4 ms, and so on, and longer in the last entry",
+                            {
+                                {RPCResult::Type::NUM, "", "The number of requests"},
+                            }},
+                            {RPCResult::Type::ARR_FIXED, "exec_time_ms", "Histogram of the time requests took to be handled, like queue_time_ms",
+                            {
+                                {RPCResult::Type::NUM, "", "The number of requests"},
+                            }},
+                        }},
                     }
                 },
                 RPCExamples{
@@ -241,6 +262,22 @@ static RPCHelpMan getrpcinfo()
     UniValue log_path(UniValue::VSTR, path);
     result.pushKV("logpath", std::move(log_path));
 
+    if (const auto stats{GetHTTPWorkQueueStats()}) {
+        UniValue work_queue(UniValue::VOBJ);
+        work_queue.pushKV("depth", uint64_t{stats->depth});
+        work_queue.pushKV("max_depth", uint64_t{stats->max_depth});
+        work_queue.pushKV("clients", uint64_t{stats->clients});
+        work_queue.pushKV("rejected", stats->rejected);
+        work_queue.pushKV("cancelled", stats->cancelled);
+        UniValue queue_time(UniValue::VARR);
+        for (const uint64_t count : stats->queue_time_ms) queue_time.push_back(count);
+        work_queue.pushKV("queue_time_ms", std::move(queue_time));
+        UniValue exec_time(UniValue::VARR);
+        for (const uint64_t count : stats->exec_time_ms) exec_time.push_back(count);
+        work_queue.pushKV("exec_time_ms", std::move(exec_time));
+        result.pushKV("work_queue", std::move(work_queue));
+    }
+
     return result;
 }
     };
@@ -367,6 +404,80 @@ UniValue JSONRPCExec(const JSONRPCRequest& jreq, bool catch_errors)
     return JSONRPCReplyObj(std::move(result), NullUniValue, jreq.id, jreq.m_json_version);
 }
 
+namespace {
+/** Shared between the threads executing a batch request. */
+struct BatchState {
+    BatchState(const JSONRPCRequest& base_in, UniValue requests_in)
+        : base{base_in}, requests{std::move(requests_in)}, replies(requests.size()) {}
+
+    const JSONRPCRequest base;
+    const UniValue requests;
+    Mutex mutex;
+    std::condition_variable cv;
+    //! Index of the next entry to be executed.
+    size_t next GUARDED_BY(mutex){0};
+    //! Number of threads executing entries.
+    size_t running GUARDED_BY(mutex){0};
+    //! Written by the thread that took the entry, nullopt for notifications.
+    std::vector<std::optional<UniValue>> replies;
+};
+} // namespace
+
+static std::optional<UniValue> ExecBatchEntry(const JSONRPCRequest& base, const UniValue& request)
+{
+    // Batches never throw HTTP errors, they are always just included
+    // in "HTTP OK" responses. Notifications never get any response.
+    JSONRPCRequest jreq{base};
+    UniValue response;
+    try {
+        jreq.parse(request);
+        response = JSONRPCExec(jreq, /*catch_errors=*/true);
+    } catch (UniValue& e) {
+        response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
+    } catch (const std::exception& e) {
+        response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
+    }
+    if (jreq.IsNotification()) return std::nullopt;
+    return response;
+}
+
+/** Execute entries of the batch until none are left. */
+static void RunBatchEntries(BatchState& state) EXCLUSIVE_LOCKS_REQUIRED(!state.mutex)
+{
+    WAIT_LOCK(state.mutex, lock);
+    ++state.running;
+    while (state.next < state.requests.size()) {
+        const size_t i{state.next++};
+        REVERSE_LOCK(lock, state.mutex);
+        state.replies[i] = ExecBatchEntry(state.base, state.requests[i]);
+    }
+    --state.running;
+    state.cv.notify_all();
+}
+
+UniValue JSONRPCExecBatch(const JSONRPCRequest& jreq, UniValue requests, size_t max_parallel, const std::function<bool(std::function<void()>)>& spawn)
+{
+    // Workers that only start after the batch is done find nothing left to
+    // do, but may still hold on to the state.
+    const auto state{std::make_shared<BatchState>(jreq, std::move(requests))};
+    const size_t workers{std::min(max_parallel, state->requests.size())};
+    for (size_t i{1}; i < workers; ++i) {
+        if (!spawn([state] { RunBatchEntries(*state); })) break;
+    }
+    RunBatchEntries(*state);
+    {
+        // All entries are taken, wait for the ones other workers are still executing.
+        WAIT_LOCK(state->mutex, lock);
+        state->cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(state->mutex) { return state->running == 0; });
+    }
+
+    UniValue reply{UniValue::VARR};
+    for (std::optional<UniValue>& response : state->replies) {
+        if (response) reply.push_back(std::move(*response));
+    }
+    return reply;
+}
+
 /**
  * Process named arguments into a vector of positional arguments, based on the
  * passed-in specification for the RPC call's arguments.
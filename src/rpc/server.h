@@ -175,4 +175,15 @@ void InterruptRPC();
 void StopRPC();
 UniValue JSONRPCExec(const JSONRPCRequest& jreq, bool catch_errors);
 
+/**
+ * Execute the entries of a batch request, each as if it was sent on its own
+ * with the fields of `jreq` (such as context, URI and user).
+ *
+ * Up to `max_parallel` entries run at the same time: the calling thread runs
+ * entries itself and asks `spawn` to run further workers, which it may refuse
+ * by returning false. The replies are returned in the order of the requests,
+ * without notifications, regardless of the order the entries finished in.
+ */
+UniValue JSONRPCExecBatch(const JSONRPCRequest& jreq, UniValue requests, size_t max_parallel, const std::function<bool(std::function<void()>)>& spawn);
+
 #endif // BITCOIN_RPC_SERVER_H
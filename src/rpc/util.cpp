@@ -15,6 +15,7 @@
 #include <node/types.h>
 #include <outputtype.h>
 #include <pow.h>
+#include <rpc/jsonstream.h>
 #include <rpc/util.h>
 #include <script/descriptor.h>
 #include <script/interpreter.h>
@@ -660,9 +661,13 @@ UniValue RPCHelpMan::HandleRequest(const JSONRPCRequest& request) const
     }
     CHECK_NONFATAL(m_req == nullptr);
     m_req = &request;
+    const uint64_t stream_written{request.m_result_stream ? request.m_result_stream->Written() : 0};
     UniValue ret = m_fun(*this, request);
     m_req = nullptr;
-    if (gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)) {
+    // A result written to the stream or left to a tip wait was not returned and cannot be checked.
+    const bool streamed{request.m_result_stream && request.m_result_stream->Written() != stream_written};
+    const bool waiting{request.m_tip_wait && request.m_tip_wait->poll};
+    if (!streamed && !waiting && gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)) {
         UniValue mismatch{UniValue::VARR};
         for (const auto& res : m_results.m_results) {
             UniValue match{res.MatchesType(ret)};
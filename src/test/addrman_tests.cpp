@@ -11,6 +11,7 @@
 #include <netbase.h>
 #include <random.h>
 #include <test/data/asmap.raw.h>
+#include <test/util/logging.h>
 #include <test/util/setup_common.h>
 #include <util/asmap.h>
 #include <util/string.h>
@@ -376,6 +377,40 @@ BOOST_AUTO_TEST_CASE(addrman_tried_collisions)
 }
 
 
+BOOST_AUTO_TEST_CASE(addrman_getaddr_after_snapshot)
+{
+    // Select() may be served a snapshot that misses recent modifications, GetAddr() may not.
+    auto addrman = std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, /*deterministic=*/false, GetCheckRatio(m_node));
+    const CNetAddr source{ResolveIP("250.1.2.1")};
+    CAddress addr1{ResolveService("250.250.2.1", 8333), NODE_NONE};
+    addr1.nTime = Now<NodeSeconds>();
+    CAddress addr2{ResolveService("250.251.2.2", 8333), NODE_NONE};
+    addr2.nTime = Now<NodeSeconds>();
+
+    BOOST_CHECK(addrman->Add({addr1}, source));
+    BOOST_CHECK_EQUAL(addrman->Select().first.ToStringAddrPort(), "250.250.2.1:8333");
+    BOOST_CHECK(addrman->Add({addr2}, source));
+    BOOST_CHECK_EQUAL(addrman->GetAddr(/*max_addresses=*/0, /*max_pct=*/0, /*network=*/std::nullopt).size(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(addrman_select_after_attempt)
+{
+    // Only added addresses may be missing from the snapshot Select() is served,
+    // not the attempt that ThreadOpenConnections just made.
+    auto addrman = std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, /*deterministic=*/false, GetCheckRatio(m_node));
+    const CNetAddr source{ResolveIP("250.1.2.1")};
+    CAddress addr{ResolveService("250.250.2.1", 8333), NODE_NONE};
+    addr.nTime = Now<NodeSeconds>();
+
+    BOOST_CHECK(addrman->Add({addr}, source));
+    BOOST_CHECK(addrman->Select().second == NodeSeconds{0s});
+    const NodeSeconds attempt_time{Now<NodeSeconds>()};
+    addrman->Attempt(addr, /*fCountFailure=*/true, attempt_time);
+    const auto [selected, last_try]{addrman->Select()};
+    BOOST_CHECK_EQUAL(selected.ToStringAddrPort(), "250.250.2.1:8333");
+    BOOST_CHECK(last_try == attempt_time);
+}
+
 BOOST_AUTO_TEST_CASE(addrman_getaddr)
 {
     auto addrman = std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, DETERMINISTIC, GetCheckRatio(m_node));
@@ -1178,4 +1213,110 @@ BOOST_AUTO_TEST_CASE(addrman_size)
     BOOST_CHECK_EQUAL(addrman->Size(/*net=*/std::nullopt, /*in_new=*/false), 1U);
 }
 
+BOOST_AUTO_TEST_CASE(addrman_journal)
+{
+    const CNetAddr source{ResolveIP("252.2.2.2")};
+    const CAddress addr1{ResolveService("250.1.1.1", 8333), NODE_NONE};
+    const CAddress addr2{ResolveService("250.1.1.2", 8333), NODE_NONE};
+    const CAddress addr3{ResolveService("250.1.1.3", 8333), NODE_NONE};
+
+    // Journaling is disabled by default
+    auto addrman{std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, DETERMINISTIC, GetCheckRatio(m_node))};
+    BOOST_CHECK(addrman->Add({addr1}, source));
+    BOOST_CHECK(!addrman->TakeJournal());
+
+    addrman->EnableJournal(/*max_bytes=*/1 << 20);
+    DataStream base{};
+    base << *addrman;
+    const uint64_t base_sequence{addrman->SerializedJournalSequence()};
+
+    BOOST_CHECK(addrman->Add({addr2, addr3}, source));
+    BOOST_CHECK(addrman->Good(addr1));
+    addrman->Attempt(addr2, /*fCountFailure=*/true);
+    addrman->SetServices(addr3, NODE_NETWORK);
+    const auto records{addrman->TakeJournal()};
+    BOOST_REQUIRE(records);
+    BOOST_CHECK(!records->empty());
+    BOOST_CHECK(addrman->TakeJournal()->empty());
+
+    // Replaying the journal on top of the base state yields the same tables
+    auto restored{std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, DETERMINISTIC, GetCheckRatio(m_node))};
+    base >> *restored;
+    BOOST_CHECK_EQUAL(restored->Size(), 1U);
+    BOOST_CHECK_EQUAL(restored->ReplayJournal(*records, base_sequence), records->size());
+    BOOST_CHECK_EQUAL(restored->Size(/*net=*/std::nullopt, /*in_new=*/true), addrman->Size(/*net=*/std::nullopt, /*in_new=*/true));
+    BOOST_CHECK_EQUAL(restored->Size(/*net=*/std::nullopt, /*in_new=*/false), addrman->Size(/*net=*/std::nullopt, /*in_new=*/false));
+    BOOST_CHECK_EQUAL(restored->Size(/*net=*/std::nullopt, /*in_new=*/false), 1U);
+    const auto addr3_info{restored->FindAddressEntry(addr3)};
+    BOOST_REQUIRE(addr3_info);
+    BOOST_CHECK(!addr3_info->tried);
+    for (const CAddress& addr : restored->GetAddr(/*max_addresses=*/0, /*max_pct=*/0, /*network=*/std::nullopt, /*filtered=*/false)) {
+        BOOST_CHECK_EQUAL(addr.nServices, CService{addr} == addr3 ? NODE_NETWORK : NODE_NONE);
+    }
+
+    // A torn record at the end is not replayed, but everything before it is
+    std::vector<std::byte> torn{*records};
+    torn.pop_back();
+    auto partial{std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, DETERMINISTIC, GetCheckRatio(m_node))};
+    BOOST_CHECK_LT(partial->ReplayJournal(torn, base_sequence), torn.size());
+    BOOST_CHECK_EQUAL(partial->Size(), 2U);
+
+    // Records that were journaled before a later serialization are skipped
+    const CAddress addr4{ResolveService("250.1.1.4", 8333), NODE_NONE};
+    BOOST_CHECK(addrman->Add({addr4}, source));
+    DataStream later{};
+    later << *addrman;
+    const uint64_t later_sequence{addrman->SerializedJournalSequence()};
+    BOOST_CHECK_GT(later_sequence, base_sequence);
+    addrman->Connected(addr4);
+    const auto later_records{addrman->TakeJournal()};
+    BOOST_REQUIRE(later_records);
+    auto resumed{std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, DETERMINISTIC, GetCheckRatio(m_node))};
+    later >> *resumed;
+    {
+        ASSERT_DEBUG_LOG("Replayed 2 journal records, 1 of them already applied");
+        BOOST_CHECK_EQUAL(resumed->ReplayJournal(*later_records, later_sequence), later_records->size());
+    }
+    BOOST_CHECK_EQUAL(resumed->Size(), 4U);
+
+    // Journals exceeding their maximum size are dropped
+    auto small{std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, DETERMINISTIC, GetCheckRatio(m_node))};
+    small->EnableJournal(/*max_bytes=*/8);
+    BOOST_CHECK(small->Add({addr1}, source));
+    BOOST_CHECK(!small->TakeJournal());
+    BOOST_CHECK(small->TakeJournal()->empty());
+}
+
+BOOST_AUTO_TEST_CASE(addrman_journal_replay_choices)
+{
+    // Replay repeats the outcomes of the random choices made when an address
+    // is announced by several sources, even with a differently seeded addrman.
+    auto addrman{std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, DETERMINISTIC, GetCheckRatio(m_node))};
+    addrman->EnableJournal(/*max_bytes=*/1 << 20);
+    DataStream base{};
+    base << *addrman;
+
+    CAddress addr{ResolveService("250.1.1.1", 8333), NODE_NONE};
+    addr.nTime = Now<NodeSeconds>() - 10min;
+    for (int i{1}; i <= 64; ++i) {
+        addr.nTime += 1s;
+        addrman->Add({addr}, ResolveIP(strprintf("%d.%d.1.1", 1 + i / 8, 1 + i % 8)));
+    }
+    const auto records{addrman->TakeJournal()};
+    BOOST_REQUIRE(records);
+
+    auto restored{std::make_unique<AddrMan>(EMPTY_NETGROUPMAN, /*deterministic=*/false, GetCheckRatio(m_node))};
+    base >> *restored;
+    BOOST_CHECK_EQUAL(restored->ReplayJournal(*records, /*base_sequence=*/0), records->size());
+
+    const auto expected{addrman->GetEntries(/*from_tried=*/false)};
+    const auto actual{restored->GetEntries(/*from_tried=*/false)};
+    BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+    BOOST_CHECK_GT(expected.size(), 1U);
+    for (size_t i{0}; i < expected.size(); ++i) {
+        AddressPosition position{actual[i].second};
+        BOOST_CHECK(position == expected[i].second);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
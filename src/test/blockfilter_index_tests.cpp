@@ -8,10 +8,12 @@
 #include <consensus/merkle.h>
 #include <consensus/validation.h>
 #include <index/blockfilterindex.h>
+#include <index/readahead.h>
 #include <interfaces/chain.h>
 #include <node/miner.h>
 #include <pow.h>
 #include <test/util/blockfilter.h>
+#include <test/util/logging.h>
 #include <test/util/setup_common.h>
 #include <validation.h>
 
@@ -268,6 +270,98 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, BuildChainTestingSetup)
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync_read_ahead, BuildChainTestingSetup)
+{
+    // Filters built on the read-ahead threads must chain into the same headers
+    // as filters built on the sync thread.
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+    filter_index.SetReadAhead(std::make_shared<BlockReadAhead>(m_node.chainman->m_blockman, /*num_threads=*/3));
+    BOOST_REQUIRE(filter_index.Init());
+    filter_index.Sync();
+
+    LOCK(cs_main);
+    uint256 last_header;
+    for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+         block_index != nullptr;
+         block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+        CheckFilterLookups(filter_index, block_index, last_header, m_node.chainman->m_blockman);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_height_records, BuildChainTestingSetup)
+{
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+    BOOST_REQUIRE(filter_index.Init());
+    filter_index.Sync();
+
+    const CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+    std::vector<BlockFilter> expected_filters;
+    for (const CBlockIndex* block_index = tip; block_index; block_index = block_index->pprev) {
+        BlockFilter filter;
+        BOOST_REQUIRE(ComputeFilter(BlockFilterType::BASIC, *block_index, filter, m_node.chainman->m_blockman));
+        expected_filters.insert(expected_filters.begin(), std::move(filter));
+    }
+
+    auto check_range = [&] {
+        std::vector<BlockFilter> filters;
+        std::vector<uint256> hashes;
+        BOOST_REQUIRE(filter_index.LookupFilterRange(0, tip, filters));
+        BOOST_REQUIRE(filter_index.LookupFilterHashRange(0, tip, hashes));
+        BOOST_REQUIRE_EQUAL(filters.size(), expected_filters.size());
+        BOOST_REQUIRE_EQUAL(hashes.size(), expected_filters.size());
+        uint256 expected_header;
+        for (int height = 0; height <= tip->nHeight; ++height) {
+            const BlockFilter& expected{expected_filters[height]};
+            BOOST_CHECK_EQUAL(filters[height].GetHash(), expected.GetHash());
+            BOOST_CHECK_EQUAL(hashes[height], expected.GetHash());
+            uint256 header;
+            BOOST_CHECK(filter_index.LookupFilterHeader(tip->GetAncestor(height), header));
+            expected_header = expected.ComputeHeader(expected_header);
+            BOOST_CHECK_EQUAL(header, expected_header);
+        }
+    };
+    check_range();
+
+    // Damaged height records must fall back to the database.
+    const fs::path heights_path{gArgs.GetDataDirNet() / "indexes" / "blockfilter" / "basic" / "heights.dat"};
+    {
+        AutoFile file{fsbridge::fopen(heights_path, "rb+")};
+        BOOST_REQUIRE(!file.IsNull());
+        file.seek(20 * HEIGHT_RECORD_SIZE + 40, SEEK_SET);
+        file << uint64_t{0xdeadbeef};
+        file.seek(50 * HEIGHT_RECORD_SIZE, SEEK_SET);
+        file << uint256::ONE;
+    }
+    check_range();
+}
+
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_height_records_unavailable, BuildChainTestingSetup)
+{
+    // heights.dat cannot be opened if a directory is in its place.
+    const fs::path heights_path{gArgs.GetDataDirNet() / "indexes" / "blockfilter" / "basic" / "heights.dat"};
+    fs::create_directories(heights_path);
+
+    int warnings{0};
+    {
+        DebugLogHelper log{"from the database only until restarted", [&](const std::string* line) {
+            if (line) ++warnings;
+            return false;
+        }};
+        BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+        BOOST_REQUIRE(filter_index.Init());
+        filter_index.Sync();
+
+        const CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+        std::vector<BlockFilter> filters;
+        BOOST_REQUIRE(filter_index.LookupFilterRange(0, tip, filters));
+        BOOST_CHECK_EQUAL(filters.size(), size_t(tip->nHeight) + 1);
+        uint256 header;
+        BOOST_CHECK(filter_index.LookupFilterHeader(tip, header));
+    }
+    // Only once, not for every block the index appended or looked up.
+    BOOST_CHECK_EQUAL(warnings, 1);
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
 {
     BlockFilterIndex* filter_index;
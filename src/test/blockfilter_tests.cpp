@@ -8,12 +8,18 @@
 #include <blockfilter.h>
 #include <core_io.h>
 #include <primitives/block.h>
+#include <random.h>
+#include <rpc/blockchain.h>
 #include <serialize.h>
 #include <streams.h>
 #include <undo.h>
 #include <univalue.h>
+#include <util/golombrice.h>
 #include <util/strencodings.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 
 BOOST_AUTO_TEST_SUITE(blockfilter_tests)
@@ -41,6 +47,48 @@ BOOST_AUTO_TEST_CASE(gcsfilter_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(golombrice_reader)
+{
+    // The word-at-a-time reader must agree with the bit-by-bit decoder, including
+    // on long quotients, on P values that do not fit one refill, and on where
+    // the data runs out.
+    FastRandomContext rng{/*fDeterministic=*/true};
+    for (uint8_t P : {0, 1, 7, 19, 31, 40, 57}) {
+        std::vector<uint64_t> values;
+        for (int i = 0; i < 200; ++i) {
+            const uint64_t quotient{rng.randrange<uint64_t>(i % 17 == 0 ? 300 : 4)};
+            values.push_back((quotient << P) | (P ? rng.randbits(P) : 0));
+        }
+        std::vector<unsigned char> encoded;
+        {
+            VectorWriter stream{encoded, 0};
+            BitStreamWriter bitwriter{stream};
+            for (uint64_t value : values) GolombRiceEncode(bitwriter, P, value);
+            bitwriter.Flush();
+        }
+
+        for (size_t truncate : {size_t{0}, size_t{1}, encoded.size() / 2}) {
+            const std::span<const unsigned char> data{encoded.data(), encoded.size() - truncate};
+            SpanReader stream{data};
+            BitStreamReader bitreader{stream};
+            GolombRiceReader reader{data};
+            for (uint64_t value : values) {
+                uint64_t expected;
+                try {
+                    expected = GolombRiceDecode(bitreader, P);
+                } catch (const std::ios_base::failure&) {
+                    BOOST_CHECK(truncate > 0);
+                    BOOST_CHECK_THROW(reader.Decode(P), std::ios_base::failure);
+                    break;
+                }
+                BOOST_CHECK_EQUAL(expected, value);
+                BOOST_CHECK_EQUAL(reader.Decode(P), expected);
+                BOOST_CHECK_EQUAL(reader.GetBytesRead(), data.size() - stream.size());
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor)
 {
     GCSFilter filter;
@@ -188,4 +236,25 @@ BOOST_AUTO_TEST_CASE(blockfilter_type_names)
     BOOST_CHECK(!BlockFilterTypeByName("unknown", filter_type));
 }
 
+BOOST_AUTO_TEST_CASE(blockfilter_matcher_truncated_filter)
+{
+    const GCSFilter::ElementSet needles{{0x51}};
+    BlockFilterMatcher matcher{needles, /*num_threads=*/4};
+
+    // Enough empty filters for worker threads to match some of them, with one among them whose
+    // encoding claims 100 elements but ends after a byte, as a damaged filter file could.
+    std::vector<BlockFilter> filters;
+    for (int i = 0; i < 5000; ++i) {
+        filters.emplace_back(BlockFilterType::BASIC, uint256{}, std::vector<unsigned char>{0x00}, /*skip_decode_check=*/true);
+    }
+    const std::vector<BlockFilter> good_filters{filters};
+    filters[3000] = BlockFilter{BlockFilterType::BASIC, uint256{}, std::vector<unsigned char>{0x64, 0x00}, /*skip_decode_check=*/true};
+    BOOST_CHECK_THROW(matcher.Match(filters), std::ios_base::failure);
+
+    // The matcher is still usable afterwards.
+    const std::vector<char> matches{matcher.Match(good_filters)};
+    BOOST_CHECK_EQUAL(matches.size(), good_filters.size());
+    BOOST_CHECK(std::ranges::none_of(matches, [](char match) { return match; }));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,7 @@
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
+#include <pow.h>
 #include <script/solver.h>
 #include <primitives/block.h>
 #include <util/chaintype.h>
@@ -147,6 +148,150 @@ BOOST_FIXTURE_TEST_CASE(blockmanager_readblock_hash_mismatch, TestingSetup)
     BOOST_CHECK(!m_node.chainman->m_blockman.ReadBlock(dummy, *fake_index));
 }
 
+BOOST_FIXTURE_TEST_CASE(blockmanager_block_index_snapshot, TestChain100Setup)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    const BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .block_index_snapshot = true,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "snapshot_test_index",
+            .cache_bytes = 0,
+        },
+    };
+    std::vector<const CBlockIndex*> entries;
+    {
+        LOCK(cs_main);
+        for (const auto& [_, block_index] : m_node.chainman->m_blockman.m_block_index) {
+            entries.push_back(&block_index);
+        }
+    }
+
+    // Populate a persistent block tree database with the test chain and write a snapshot of it
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(cs_main);
+        BOOST_CHECK(blockman.m_block_tree_db->WriteBatchSync({}, 0, entries));
+        BOOST_CHECK(blockman.LoadBlockIndexDB(std::nullopt));
+        BOOST_CHECK(blockman.WriteBlockIndexSnapshot());
+        BOOST_CHECK(blockman.m_block_tree_db->ReadIndexSnapshotChecksum());
+        BOOST_CHECK(fs::exists(blockman.GetBlockIndexSnapshotPath()));
+    }
+
+    // Restarting loads the same block index from the snapshot
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(cs_main);
+        {
+            ASSERT_DEBUG_LOG("block index entries from snapshot");
+            BOOST_CHECK(blockman.LoadBlockIndexDB(std::nullopt));
+        }
+        BOOST_CHECK_EQUAL(blockman.m_block_index.size(), entries.size());
+        for (const CBlockIndex* expected : entries) {
+            const CBlockIndex* loaded{blockman.LookupBlockIndex(expected->GetBlockHash())};
+            BOOST_REQUIRE(loaded);
+            BOOST_CHECK_EQUAL(loaded->nHeight, expected->nHeight);
+            BOOST_CHECK_EQUAL(loaded->nStatus, expected->nStatus);
+            BOOST_CHECK_EQUAL(loaded->nDataPos, expected->nDataPos);
+            BOOST_CHECK(loaded->nChainWork == expected->nChainWork);
+            BOOST_CHECK_EQUAL(loaded->m_chain_tx_count, expected->m_chain_tx_count);
+            if (expected->pprev) {
+                BOOST_REQUIRE(loaded->pprev);
+                BOOST_CHECK_EQUAL(loaded->pprev->GetBlockHash(), expected->pprev->GetBlockHash());
+                BOOST_CHECK_EQUAL(loaded->pskip->GetBlockHash(), expected->pskip->GetBlockHash());
+            }
+        }
+
+        // Any write to the block index invalidates the snapshot
+        BOOST_CHECK(blockman.m_block_tree_db->WriteBatchSync({}, 0, {}));
+        BOOST_CHECK(!blockman.m_block_tree_db->ReadIndexSnapshotChecksum());
+    }
+
+    // A stale snapshot is discarded and the block index is loaded from the database
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(cs_main);
+        BOOST_CHECK(blockman.LoadBlockIndexDB(std::nullopt));
+        BOOST_CHECK_EQUAL(blockman.m_block_index.size(), entries.size());
+        BOOST_CHECK(!fs::exists(blockman.GetBlockIndexSnapshotPath()));
+
+        // Record the first block file, start a second one and take a new snapshot
+        CBlockFileInfo first;
+        first.AddBlock(/*nHeightIn=*/100, /*nTimeIn=*/1);
+        CBlockFileInfo info;
+        info.AddBlock(/*nHeightIn=*/101, /*nTimeIn=*/1);
+        BOOST_CHECK(blockman.m_block_tree_db->WriteBatchSync({{0, &first}, {1, &info}}, 1, {}));
+        BOOST_CHECK(blockman.WriteBlockIndexSnapshot());
+        BOOST_CHECK(blockman.m_block_tree_db->ReadIndexSnapshotChecksum());
+
+        // Change the first block file behind the snapshot's back, like a
+        // version without snapshot support pruning it would.
+        CBlockFileInfo pruned;
+        BOOST_CHECK(blockman.m_block_tree_db->Write(std::make_pair(uint8_t{'f'} /* DB_BLOCK_FILES */, 0), pruned));
+    }
+
+    // A change to any block file, not only the last one, makes the snapshot stale
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(cs_main);
+        {
+            ASSERT_DEBUG_LOG("block tree database changed since the snapshot was written");
+            BOOST_CHECK(blockman.LoadBlockIndexDB(std::nullopt));
+        }
+        BOOST_CHECK_EQUAL(blockman.m_block_index.size(), entries.size());
+        BOOST_CHECK(blockman.WriteBlockIndexSnapshot());
+
+        // Mark the tip invalid behind the snapshot's back, like invalidateblock
+        // of a version without snapshot support would.
+        CBlockIndex* tip{blockman.LookupBlockIndex(entries.front()->GetBlockHash())};
+        for (const CBlockIndex* entry : entries) {
+            if (entry->nHeight > tip->nHeight) tip = blockman.LookupBlockIndex(entry->GetBlockHash());
+        }
+        tip->nStatus |= BLOCK_FAILED_VALID;
+        BOOST_CHECK(blockman.m_block_tree_db->Write(std::make_pair(uint8_t{'b'} /* DB_BLOCK_INDEX */, tip->GetBlockHash()), CDiskBlockIndex{tip}));
+    }
+
+    // A status change of a block index entry makes the snapshot stale
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(cs_main);
+        {
+            ASSERT_DEBUG_LOG("block tree database changed since the snapshot was written");
+            BOOST_CHECK(blockman.LoadBlockIndexDB(std::nullopt));
+        }
+        BOOST_CHECK_EQUAL(blockman.m_block_index.size(), entries.size());
+        CBlockIndex* tip{blockman.LookupBlockIndex(WITH_LOCK(m_node.chainman->GetMutex(), return m_node.chainman->ActiveChain().Tip()->GetBlockHash()))};
+        BOOST_REQUIRE(tip);
+        BOOST_CHECK(tip->nStatus & BLOCK_FAILED_VALID);
+        BOOST_CHECK(blockman.WriteBlockIndexSnapshot());
+
+        // Add a header-only entry behind the snapshot's back.
+        CBlockHeader block_header{tip->GetBlockHeader()};
+        block_header.hashPrevBlock = tip->GetBlockHash();
+        while (!CheckProofOfWork(block_header.GetHash(), block_header.nBits, Params().GetConsensus())) ++block_header.nNonce;
+        const uint256 header_hash{block_header.GetHash()};
+        CBlockIndex header{block_header};
+        header.phashBlock = &header_hash;
+        header.nHeight = tip->nHeight + 1;
+        header.nStatus = BLOCK_VALID_TREE;
+        header.pprev = tip;
+        BOOST_CHECK(blockman.m_block_tree_db->Write(std::make_pair(uint8_t{'b'} /* DB_BLOCK_INDEX */, header_hash), CDiskBlockIndex{&header}));
+    }
+
+    // A new block index entry makes the snapshot stale
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(cs_main);
+        {
+            ASSERT_DEBUG_LOG("block tree database changed since the snapshot was written");
+            BOOST_CHECK(blockman.LoadBlockIndexDB(std::nullopt));
+        }
+        BOOST_CHECK_EQUAL(blockman.m_block_index.size(), entries.size() + 1);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
 {
     KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
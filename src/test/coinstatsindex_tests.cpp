@@ -6,12 +6,22 @@
 #include <index/coinstatsindex.h>
 #include <interfaces/chain.h>
 #include <kernel/coinstats.h>
+#include <streams.h>
+#include <test/util/logging.h>
 #include <test/util/setup_common.h>
 #include <test/util/validation.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(coinstatsindex_tests)
 
 BOOST_FIXTURE_TEST_CASE(coinstatsindex_initial_sync, TestChain100Setup)
@@ -114,4 +124,76 @@ BOOST_FIXTURE_TEST_CASE(coinstatsindex_unclean_shutdown, TestChain100Setup)
     }
 }
 
+// Computing the statistics on several threads must give the same results as on one.
+BOOST_FIXTURE_TEST_CASE(coinstats_parallel, TestChain100Setup)
+{
+    Chainstate& chainstate{Assert(m_node.chainman)->ActiveChainstate()};
+    CCoinsView* coins_db;
+    {
+        LOCK(cs_main);
+        chainstate.ForceFlushStateToDisk();
+        coins_db = &chainstate.CoinsDB();
+    }
+
+    for (const auto hash_type : {kernel::CoinStatsHashType::HASH_SERIALIZED, kernel::CoinStatsHashType::MUHASH, kernel::CoinStatsHashType::NONE}) {
+        const auto serial{kernel::ComputeUTXOStats(hash_type, coins_db, m_node.chainman->m_blockman, {}, /*num_threads=*/1)};
+        const auto parallel{kernel::ComputeUTXOStats(hash_type, coins_db, m_node.chainman->m_blockman, {}, /*num_threads=*/4)};
+        BOOST_REQUIRE(serial && parallel);
+        BOOST_CHECK_EQUAL(serial->nHeight, 100);
+        BOOST_CHECK_EQUAL(parallel->nHeight, serial->nHeight);
+        BOOST_CHECK_EQUAL(parallel->hashBlock, serial->hashBlock);
+        BOOST_CHECK_EQUAL(parallel->nTransactions, serial->nTransactions);
+        BOOST_CHECK_EQUAL(parallel->nTransactionOutputs, serial->nTransactionOutputs);
+        BOOST_CHECK_EQUAL(parallel->nBogoSize, serial->nBogoSize);
+        BOOST_CHECK_EQUAL(parallel->coins_count, serial->coins_count);
+        BOOST_CHECK(parallel->total_amount == serial->total_amount);
+        BOOST_CHECK_EQUAL(parallel->hashSerialized, serial->hashSerialized);
+        if (hash_type != kernel::CoinStatsHashType::NONE) BOOST_CHECK(!serial->hashSerialized.IsNull());
+    }
+}
+
+// Threads only compute ahead while the shards waiting to be combined fit in the buffer.
+BOOST_FIXTURE_TEST_CASE(coinstats_parallel_buffer, TestChain100Setup)
+{
+    Chainstate& chainstate{Assert(m_node.chainman)->ActiveChainstate()};
+    CCoinsView* coins_db;
+    {
+        LOCK(cs_main);
+        chainstate.ForceFlushStateToDisk();
+        coins_db = &chainstate.CoinsDB();
+    }
+
+    // Shards are ranges of txids which never span more than one leading byte, so no shard is
+    // larger than the coins sharing a leading byte.
+    std::map<std::byte, size_t> bucket_sizes;
+    for (const auto cursor{coins_db->Cursor()}; cursor->Valid(); cursor->Next()) {
+        std::vector<std::pair<COutPoint, Coin>> coins(1);
+        BOOST_REQUIRE(cursor->GetKey(coins[0].first) && cursor->GetValue(coins[0].second));
+        DataStream serialized;
+        kernel::ApplyTxCoinsHash(serialized, coins);
+        bucket_sizes[coins[0].first.hash.begin()[0]] += serialized.size();
+    }
+    size_t max_shard_size{0};
+    for (const auto& [_, size] : bucket_sizes) max_shard_size = std::max(max_shard_size, size);
+    BOOST_REQUIRE(max_shard_size > 0);
+
+    const auto serial{kernel::ComputeUTXOStats(kernel::CoinStatsHashType::HASH_SERIALIZED, coins_db, m_node.chainman->m_blockman, {}, /*num_threads=*/1)};
+    BOOST_REQUIRE(serial);
+    for (const size_t max_buffered : {size_t{0}, max_shard_size, kernel::DEFAULT_UTXO_STATS_MAX_BUFFERED}) {
+        std::optional<size_t> peak;
+        std::optional<kernel::CCoinsStats> parallel;
+        {
+            DebugLogHelper log{"Computed UTXO set statistics on 4 threads", [&](const std::string* line) {
+                if (line) peak = std::stoull(line->substr(line->find("with up to ") + std::string{"with up to "}.size()));
+                return true;
+            }};
+            parallel = kernel::ComputeUTXOStats(kernel::CoinStatsHashType::HASH_SERIALIZED, coins_db, m_node.chainman->m_blockman, {}, /*num_threads=*/4, max_buffered);
+        }
+        BOOST_REQUIRE(parallel && peak);
+        BOOST_CHECK_EQUAL(parallel->hashSerialized, serial->hashSerialized);
+        // Each thread may finish one shard beyond the limit; without one they take turns.
+        BOOST_CHECK_LE(*peak, max_buffered == 0 ? max_shard_size : max_buffered + 4 * max_shard_size);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,22 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/cbor.h>
+#include <test/fuzz/fuzz.h>
+#include <univalue.h>
+#include <util/check.h>
+
+#include <optional>
+#include <span>
+
+FUZZ_TARGET(cbor)
+{
+    const std::optional<UniValue> value{DecodeCBOR(std::as_bytes(buffer))};
+    if (!value) return;
+    // Whatever can be decoded encodes to an item that can be decoded. Floats
+    // may not keep their exact text, so only the type is compared.
+    const std::optional<UniValue> reencoded{DecodeCBOR(EncodeCBOR(*value))};
+    Assert(reencoded);
+    Assert(reencoded->getType() == value->getType());
+}
@@ -16,6 +16,8 @@
 #include <cassert>
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <span>
 #include <unordered_set>
 #include <vector>
 
@@ -69,16 +71,20 @@ FUZZ_TARGET(golomb_rice)
     }
 
     std::vector<uint64_t> decoded_deltas;
+    std::vector<uint64_t> bulk_decoded_deltas;
     {
         SpanReader stream{golomb_rice_data};
-        BitStreamReader bitreader{stream};
         const uint32_t n = static_cast<uint32_t>(ReadCompactSize(stream));
+        GolombRiceReader reader{std::span{golomb_rice_data}.subspan(golomb_rice_data.size() - stream.size())};
+        BitStreamReader bitreader{stream};
         for (uint32_t i = 0; i < n; ++i) {
             decoded_deltas.push_back(GolombRiceDecode(bitreader, BASIC_FILTER_P));
+            bulk_decoded_deltas.push_back(reader.Decode(BASIC_FILTER_P));
         }
     }
 
     assert(encoded_deltas == decoded_deltas);
+    assert(encoded_deltas == bulk_decoded_deltas);
 
     {
         const std::vector<uint8_t> random_bytes = ConsumeRandomLengthByteVector(fuzzed_data_provider, 1024);
@@ -89,12 +95,21 @@ FUZZ_TARGET(golomb_rice)
         } catch (const std::ios_base::failure&) {
             return;
         }
+        GolombRiceReader reader{std::span{random_bytes}.subspan(random_bytes.size() - stream.size())};
         BitStreamReader bitreader{stream};
         for (uint32_t i = 0; i < std::min<uint32_t>(n, 1024); ++i) {
+            std::optional<uint64_t> decoded;
+            try {
+                decoded = GolombRiceDecode(bitreader, BASIC_FILTER_P);
+            } catch (const std::ios_base::failure&) {
+            }
+            std::optional<uint64_t> bulk_decoded;
             try {
-                (void)GolombRiceDecode(bitreader, BASIC_FILTER_P);
+                bulk_decoded = reader.Decode(BASIC_FILTER_P);
             } catch (const std::ios_base::failure&) {
             }
+            assert(decoded == bulk_decoded);
+            if (!decoded) break;
         }
     }
 }
@@ -3,12 +3,110 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <httpserver.h>
+#include <netbase.h>
 #include <test/util/setup_common.h>
+#include <util/time.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+//! Work item that records its name in a log when it runs.
+class LoggingClosure : public HTTPClosure
+{
+    std::string m_name;
+    std::vector<std::string>& m_log;
+    std::chrono::milliseconds m_duration;
+
+public:
+    LoggingClosure(std::string name, std::vector<std::string>& log, std::chrono::milliseconds duration = {})
+        : m_name{std::move(name)}, m_log{log}, m_duration{duration} {}
+    void operator()() override
+    {
+        UninterruptibleSleep(m_duration);
+        m_log.push_back(m_name);
+    }
+    const std::string& Name() const { return m_name; }
+};
+
+std::unique_ptr<HTTPClosure> MakeItem(std::string name, std::vector<std::string>& log, std::chrono::milliseconds duration = {})
+{
+    return std::make_unique<LoggingClosure>(std::move(name), log, duration);
+}
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(httpserver_tests, BasicTestingSetup)
 
+BOOST_AUTO_TEST_CASE(work_queue_interleaves_clients)
+{
+    // Two connections from the same address are separate clients.
+    const CService client_a{LookupNumeric("127.0.0.1", 1001)};
+    const CService client_b{LookupNumeric("127.0.0.1", 1002)};
+    std::vector<std::string> log;
+    HTTPWorkQueue queue{/*max_depth=*/16};
+    for (const auto* name : {"a1", "a2", "a3"}) {
+        BOOST_CHECK(!queue.Enqueue(MakeItem(name, log, std::chrono::milliseconds{20}), client_a, /*conn=*/nullptr));
+    }
+    for (const auto* name : {"b1", "b2", "b3"}) {
+        BOOST_CHECK(!queue.Enqueue(MakeItem(name, log), client_b, /*conn=*/nullptr));
+    }
+    BOOST_CHECK_EQUAL(queue.GetStats().clients, 2U);
+
+    // Run() drains what is queued before returning once interrupted.
+    queue.Interrupt();
+    queue.Run();
+
+    // The slow request of the first client is followed by all quick requests
+    // of the second, rather than the second waiting for the first.
+    const std::vector<std::string> expected{"a1", "b1", "b2", "b3", "a2", "a3"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(log.begin(), log.end(), expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(queue.GetStats().depth, 0U);
+    BOOST_CHECK_EQUAL(queue.GetStats().clients, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(work_queue_rejects_busiest_client)
+{
+    const CService client_a{LookupNumeric("127.0.0.1", 1001)};
+    const CService client_b{LookupNumeric("127.0.0.1", 1002)};
+    const CService client_c{LookupNumeric("127.0.0.1", 1003)};
+    std::vector<std::string> log;
+    // Every request takes some time, so that a client that was served is charged for it.
+    const std::chrono::milliseconds duration{1};
+    HTTPWorkQueue queue{/*max_depth=*/4};
+    for (const auto* name : {"a1", "a2", "a3"}) {
+        BOOST_CHECK(!queue.Enqueue(MakeItem(name, log, duration), client_a, /*conn=*/nullptr));
+    }
+    BOOST_CHECK(!queue.Enqueue(MakeItem("b1", log, duration), client_b, /*conn=*/nullptr));
+
+    // A new client makes room by evicting the newest request of the busiest one.
+    auto rejected{queue.Enqueue(MakeItem("c1", log, duration), client_c, /*conn=*/nullptr)};
+    BOOST_REQUIRE(rejected);
+    BOOST_CHECK_EQUAL(static_cast<LoggingClosure&>(*rejected).Name(), "a3");
+
+    // The busiest client itself cannot push out others.
+    rejected = queue.Enqueue(MakeItem("a4", log), client_a, /*conn=*/nullptr);
+    BOOST_REQUIRE(rejected);
+    BOOST_CHECK_EQUAL(static_cast<LoggingClosure&>(*rejected).Name(), "a4");
+
+    // Nor can a client with as many queued as the busiest but one.
+    rejected = queue.Enqueue(MakeItem("b2", log), client_b, /*conn=*/nullptr);
+    BOOST_REQUIRE(rejected);
+    BOOST_CHECK_EQUAL(static_cast<LoggingClosure&>(*rejected).Name(), "b2");
+
+    const auto stats{queue.GetStats()};
+    BOOST_CHECK_EQUAL(stats.depth, 4U);
+    BOOST_CHECK_EQUAL(stats.rejected, 3U);
+
+    queue.Interrupt();
+    queue.Run();
+    const std::vector<std::string> expected{"a1", "b1", "c1", "a2"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(log.begin(), log.end(), expected.begin(), expected.end());
+}
+
 BOOST_AUTO_TEST_CASE(test_query_parameters)
 {
     std::string uri {};
@@ -562,4 +562,44 @@ BOOST_AUTO_TEST_CASE(peer_worksets)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(precheck_set)
+{
+    const NodeId node0{0};
+    FastRandomContext det_rand{true};
+    TxOrphanageTest orphanage{det_rand};
+
+    auto parent = MakeTransactionSpending({}, det_rand);
+    auto child1 = MakeTransactionSpending({COutPoint{parent->GetHash(), 0}}, det_rand);
+    auto child2 = MakeTransactionSpending({COutPoint{parent->GetHash(), 1}}, det_rand);
+    BOOST_CHECK(orphanage.AddTx(child1, node0));
+    BOOST_CHECK(orphanage.AddTx(child2, node0));
+    BOOST_CHECK(orphanage.GetTxsToPrecheck(node0, /*max_count=*/10).empty());
+
+    // Both children are handed out for prechecking once, without leaving the work set.
+    orphanage.AddChildrenToWorkSet(*parent, det_rand);
+    BOOST_CHECK_EQUAL(orphanage.GetTxsToPrecheck(node0, /*max_count=*/10).size(), 2U);
+    BOOST_CHECK(orphanage.GetTxsToPrecheck(node0, /*max_count=*/10).empty());
+    BOOST_CHECK(orphanage.HaveTxToReconsider(node0));
+
+    // Batches are capped, and the remainder is handed out by the next call.
+    orphanage.AddChildrenToWorkSet(*parent, det_rand);
+    BOOST_CHECK_EQUAL(orphanage.GetTxsToPrecheck(node0, /*max_count=*/1).size(), 1U);
+    BOOST_CHECK_EQUAL(orphanage.GetTxsToPrecheck(node0, /*max_count=*/1).size(), 1U);
+    BOOST_CHECK(orphanage.GetTxsToPrecheck(node0, /*max_count=*/1).empty());
+
+    // Re-adding them to the work set makes them eligible again, except for those already reconsidered.
+    orphanage.AddChildrenToWorkSet(*parent, det_rand);
+    const auto reconsidered{orphanage.GetTxToReconsider(node0)};
+    BOOST_CHECK(reconsidered);
+    const auto precheck{orphanage.GetTxsToPrecheck(node0, /*max_count=*/10)};
+    BOOST_CHECK_EQUAL(precheck.size(), 1U);
+    BOOST_CHECK(precheck.front() != reconsidered);
+
+    // Orphans that were erased in the meantime are skipped.
+    orphanage.AddChildrenToWorkSet(*parent, det_rand);
+    BOOST_CHECK_EQUAL(orphanage.EraseTx(child1->GetWitnessHash()), 1);
+    BOOST_CHECK_EQUAL(orphanage.EraseTx(child2->GetWitnessHash()), 1);
+    BOOST_CHECK(orphanage.GetTxsToPrecheck(node0, /*max_count=*/10).empty());
+}
 BOOST_AUTO_TEST_SUITE_END()
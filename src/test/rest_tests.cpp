@@ -2,8 +2,13 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <primitives/transaction.h>
 #include <rest.h>
+#include <script/script.h>
+#include <script/solver.h>
 #include <test/util/setup_common.h>
+#include <util/strencodings.h>
+#include <util/translation.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -45,4 +50,56 @@ BOOST_AUTO_TEST_CASE(test_query_string)
     BOOST_CHECK_EQUAL(param, "/rest/endpoint/someresource");
     BOOST_CHECK_EQUAL(rf, RESTResponseFormat::UNDEF);
 }
+
+BOOST_AUTO_TEST_CASE(test_event_filter)
+{
+    const CScript p2wpkh{CScript() << OP_0 << std::vector<unsigned char>(20, 1)};
+    const CScript p2tr{CScript() << OP_1 << std::vector<unsigned char>(32, 2)};
+    CMutableTransaction mtx;
+    mtx.vout.emplace_back(1, p2wpkh);
+    const CTransaction tx{mtx};
+    mtx.vout.emplace_back(2, p2tr);
+    const CTransaction tx_taproot{mtx};
+
+    // No filter matches everything
+    const auto all{ParseRESTEventFilter(std::nullopt, std::nullopt, std::nullopt)};
+    BOOST_REQUIRE(all);
+    for (std::string_view type : REST_EVENT_TYPES) BOOST_CHECK(all->WantsType(type));
+    BOOST_CHECK(all->Matches(tx));
+
+    const auto types{ParseRESTEventFilter("block,tx_added", std::nullopt, std::nullopt)};
+    BOOST_REQUIRE(types);
+    BOOST_CHECK(types->WantsType("block"));
+    BOOST_CHECK(types->WantsType("tx_added"));
+    BOOST_CHECK(!types->WantsType("tip"));
+    BOOST_CHECK(!types->WantsType("tx_removed"));
+    BOOST_CHECK(types->Matches(tx));
+
+    // Scripts and output types
+    const auto script{ParseRESTEventFilter(std::nullopt, HexStr(p2wpkh), std::nullopt)};
+    BOOST_REQUIRE(script);
+    BOOST_CHECK(script->Matches(tx));
+    const auto other_script{ParseRESTEventFilter(std::nullopt, HexStr(p2tr), std::nullopt)};
+    BOOST_REQUIRE(other_script);
+    BOOST_CHECK(!other_script->Matches(tx));
+    BOOST_CHECK(other_script->Matches(tx_taproot));
+    const auto script_or_type{ParseRESTEventFilter(std::nullopt, HexStr(p2tr), "witness_v0_keyhash")};
+    BOOST_REQUIRE(script_or_type);
+    BOOST_CHECK(script_or_type->Matches(tx));
+    const auto output_types{ParseRESTEventFilter(std::nullopt, std::nullopt, "witness_v1_taproot,pubkeyhash")};
+    BOOST_REQUIRE(output_types);
+    BOOST_CHECK(!output_types->Matches(tx));
+    BOOST_CHECK(output_types->Matches(tx_taproot));
+
+    // Invalid filters
+    const auto bad_type{ParseRESTEventFilter("block,blocks", std::nullopt, std::nullopt)};
+    BOOST_REQUIRE(!bad_type);
+    BOOST_CHECK_EQUAL(util::ErrorString(bad_type).original, "Unknown event type: blocks");
+    BOOST_CHECK(!ParseRESTEventFilter("", std::nullopt, std::nullopt));
+    BOOST_CHECK(!ParseRESTEventFilter(std::nullopt, "0014zz", std::nullopt));
+    BOOST_CHECK(!ParseRESTEventFilter(std::nullopt, "", std::nullopt));
+    const auto bad_output_type{ParseRESTEventFilter(std::nullopt, std::nullopt, "taproot")};
+    BOOST_REQUIRE(!bad_output_type);
+    BOOST_CHECK_EQUAL(util::ErrorString(bad_output_type).original, "Unknown output type: taproot");
+}
 BOOST_AUTO_TEST_SUITE_END()
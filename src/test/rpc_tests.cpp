@@ -6,14 +6,25 @@
 #include <interfaces/chain.h>
 #include <node/context.h>
 #include <rpc/blockchain.h>
+#include <rpc/cbor.h>
 #include <rpc/client.h>
+#include <rpc/jsonstream.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
+#include <sync.h>
 #include <test/util/setup_common.h>
+#include <tinyformat.h>
 #include <univalue.h>
 #include <util/time.h>
+#include <validation.h>
 
+#include <algorithm>
 #include <any>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -639,4 +650,187 @@ BOOST_AUTO_TEST_CASE(rpc_arg_helper)
     CheckRpc(params, UniValue{JSON(R"([5, "hello", 4, "test", true, 1.23, "world"])")}, check_positional);
 }
 
+BOOST_AUTO_TEST_CASE(json_stream_writer)
+{
+    const UniValue expected{JSON(R"({"a":1,"b":[{"k\"":"v\n"},2.5,[],null],"c":{},"d":"x","e":"00ff107f1e"})")};
+
+    // Small parts, so that every write is flushed.
+    std::string output;
+    JSONStreamWriter stream{[&](std::string_view data) { output += data; return true; }, /*flush_size=*/3};
+    stream.BeginObject();
+    stream.KeyValue("a", 1);
+    stream.Key("b");
+    stream.BeginArray();
+    stream.Value(expected["b"][0]);
+    stream.RawValue("2.5");
+    stream.BeginArray();
+    stream.EndArray();
+    stream.Value(NullUniValue);
+    stream.EndArray();
+    stream.Key("c");
+    stream.BeginObject();
+    stream.EndObject();
+    stream.Entries(JSON(R"({"d":"x"})"));
+    stream.Key("e");
+    const std::vector<uint8_t> bytes{0x00, 0xff, 0x10, 0x7f, 0x1e};
+    stream.HexValue(std::as_bytes(std::span{bytes}));
+    stream.EndObject();
+    BOOST_CHECK(!stream.AwaitingValue());
+    BOOST_CHECK_EQUAL(stream.Depth(), 0U);
+    stream.Flush();
+    BOOST_CHECK(stream.Flushed());
+    BOOST_CHECK_EQUAL(output, expected.write());
+
+    // Output is dropped once the sink refuses it.
+    int calls{0};
+    JSONStreamWriter refused{[&](std::string_view) { ++calls; return false; }, /*flush_size=*/1};
+    refused.BeginArray();
+    refused.Value(expected);
+    refused.EndArray();
+    refused.Flush();
+    BOOST_CHECK(refused.Failed());
+    BOOST_CHECK_EQUAL(calls, 1);
+    BOOST_CHECK(refused.TakeBuffer().empty());
+}
+
+BOOST_AUTO_TEST_CASE(rpc_result_stream)
+{
+    // Methods that stream their result write the same JSON they would return.
+    for (const std::string& args : {"getblock " + m_node.chainman->ActiveTip()->GetBlockHash().GetHex() + " 0",
+                                    "getblock " + m_node.chainman->ActiveTip()->GetBlockHash().GetHex() + " 2",
+                                    "getblock " + m_node.chainman->ActiveTip()->GetBlockHash().GetHex() + " 3",
+                                    std::string{"getrawmempool true"}}) {
+        const std::string expected{CallRPC(args).write()};
+
+        std::vector<std::string> vArgs{SplitString(args, ' ')};
+        const std::string method{vArgs[0]};
+        vArgs.erase(vArgs.begin());
+        JSONStreamWriter stream;
+        JSONRPCRequest request;
+        request.context = &m_node;
+        request.strMethod = method;
+        request.params = RPCConvertValues(method, vArgs);
+        request.m_result_stream = &stream;
+        BOOST_CHECK(tableRPC.execute(request).isNull());
+        BOOST_CHECK_EQUAL(stream.TakeBuffer(), expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cbor)
+{
+    const auto encode{[](const std::string& json) {
+        UniValue value;
+        BOOST_REQUIRE(value.read(json));
+        return HexStr(EncodeCBOR(value));
+    }};
+    const auto decode{[](const std::string& hex) -> std::optional<std::string> {
+        const auto value{DecodeCBOR(ParseHex<std::byte>(hex))};
+        if (!value) return std::nullopt;
+        return value->write();
+    }};
+
+    // Each value is encoded as specified, and decoded back to the same JSON.
+    for (const auto& [json, hex] : std::vector<std::pair<std::string, std::string>>{
+             {"null", "f6"},
+             {"true", "f5"},
+             {"false", "f4"},
+             {"0", "00"},
+             {"23", "17"},
+             {"24", "1818"},
+             {"1000", "1903e8"},
+             {"-1", "20"},
+             {"-1000", "3903e7"},
+             {"18446744073709551615", "1bffffffffffffffff"},
+             {"0.00010000", "c48227192710"},
+             {"-1.5", "c482202e"},
+             {"1e+30", "fb46293e5939a08cea"},
+             {R"("")", "60"},
+             {R"("a")", "6161"},
+             {R"("abc")", "63616263"},
+             {R"("abcd")", "42abcd"},
+             {R"("ABCD")", "6441424344"},
+             {"[1,[2]]", "82018102"},
+             {R"({"a":1,"b":[]})", "a2616101616280"},
+         }) {
+        BOOST_CHECK_EQUAL(encode(json), hex);
+        BOOST_CHECK_EQUAL(decode(hex).value_or("invalid"), json);
+    }
+
+    // Other encodings of numbers are accepted.
+    BOOST_CHECK_EQUAL(decode("f93e00").value_or("invalid"), "1.5");
+    BOOST_CHECK_EQUAL(decode("fa47c35000").value_or("invalid"), "100000");
+    BOOST_CHECK_EQUAL(decode("190001").value_or("invalid"), "1");
+    BOOST_CHECK_EQUAL(decode("c4820005").value_or("invalid"), "5");
+
+    // A block with full transaction details comes back unchanged.
+    const UniValue block{CallRPC("getblock " + m_node.chainman->ActiveTip()->GetBlockHash().GetHex() + " 3")};
+    BOOST_CHECK_EQUAL(DecodeCBOR(EncodeCBOR(block)).value_or(UniValue{}).write(), block.write());
+
+    for (const char* hex : {
+             "",           // empty
+             "1903",       // truncated argument
+             "6261",       // truncated string
+             "0000",       // trailing data
+             "1c",         // reserved argument size
+             "9fff",       // indefinite length
+             "c240",       // unsupported tag
+             "c4820120",   // positive exponent
+             "c48200f5",   // mantissa not an integer
+             "61ff",       // text not UTF-8
+             "a10101",     // key not text
+             "f7",         // undefined
+             "f97e00",     // NaN
+             "f97c00",     // infinity
+             "3bffffffffffffffff", // out of range
+             "9bffffffffffffffff", // longer than the data
+         }) {
+        BOOST_CHECK_MESSAGE(!decode(hex), hex);
+    }
+    // Nesting is limited like in JSON.
+    std::string nested;
+    for (int i{0}; i < 512; ++i) nested += "81";
+    BOOST_CHECK(decode(nested + "00"));
+    BOOST_CHECK(!decode("81" + nested + "00"));
+
+    BOOST_CHECK(IsCBORMediaType("application/cbor"));
+    BOOST_CHECK(IsCBORMediaType("Application/CBOR; charset=binary"));
+    BOOST_CHECK(IsCBORMediaType("application/json;q=0.5, application/cbor"));
+    BOOST_CHECK(!IsCBORMediaType("application/json"));
+    BOOST_CHECK(!IsCBORMediaType(""));
+}
+
+BOOST_AUTO_TEST_CASE(rpc_batch)
+{
+    if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
+    JSONRPCRequest jreq;
+    jreq.context = &m_node;
+    const UniValue batch{JSON(R"([{"jsonrpc": "2.0", "id": 0, "method": "getblockcount"},
+                                  {"jsonrpc": "2.0", "method": "getblockcount"},
+                                  {"jsonrpc": "2.0", "id": 2, "method": "nosuchmethod"},
+                                  1,
+                                  {"id": 4, "method": "getbestblockhash"}])")};
+    const std::string expected{strprintf(R"([{"jsonrpc":"2.0","result":%d,"id":0},)"
+                                         R"({"jsonrpc":"2.0","error":{"code":-32601,"message":"Method not found"},"id":2},)"
+                                         R"({"result":null,"error":{"code":-32600,"message":"Invalid Request object"},"id":null},)"
+                                         R"({"result":"%s","error":null,"id":4}])",
+                                         WITH_LOCK(::cs_main, return m_node.chainman->ActiveHeight()),
+                                         WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip()->GetBlockHash().GetHex()))};
+
+    // Replies come back in order however many entries run at the same time.
+    for (const size_t max_parallel : {1, 2, 3, 16}) {
+        std::vector<std::thread> workers;
+        const UniValue reply{JSONRPCExecBatch(jreq, batch, max_parallel, [&](std::function<void()> func) {
+            workers.emplace_back(std::move(func));
+            return true;
+        })};
+        for (std::thread& worker : workers) worker.join();
+        BOOST_CHECK_EQUAL(workers.size(), std::min(max_parallel, batch.size()) - 1);
+        BOOST_CHECK_EQUAL(reply.write(), expected);
+    }
+
+    // Entries that no other worker takes are executed by the caller.
+    BOOST_CHECK_EQUAL(JSONRPCExecBatch(jreq, batch, 16, [](std::function<void()>) { return false; }).write(), expected);
+    BOOST_CHECK_EQUAL(JSONRPCExecBatch(jreq, UniValue{UniValue::VARR}, 16, [](std::function<void()>) { return false; }).write(), "[]");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
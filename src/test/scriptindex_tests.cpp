@@ -0,0 +1,125 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <index/scriptindex.h>
+#include <interfaces/chain.h>
+#include <key.h>
+#include <rpc/blockchain.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <univalue.h>
+#include <util/strencodings.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(scriptindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(scriptindex_initial_sync, TestChain100Setup)
+{
+    ScriptIndex script_index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(script_index.Init());
+    script_index.Sync();
+
+    // All coinbase outputs of the test chain pay to the same script; genesis is excluded.
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    auto history{script_index.FindScriptHistory(coinbase_script, 0, 1000)};
+    BOOST_REQUIRE(history);
+    BOOST_CHECK(!history->next_height);
+    BOOST_REQUIRE_EQUAL(history->entries.size(), m_coinbase_txns.size());
+    for (size_t i = 0; i < m_coinbase_txns.size(); ++i) {
+        const ScriptHistoryEntry& entry{history->entries[i]};
+        BOOST_CHECK_EQUAL(entry.height, int(i + 1));
+        BOOST_CHECK_EQUAL(entry.tx_pos, 0U);
+        BOOST_CHECK(!entry.spend);
+        BOOST_CHECK_EQUAL(entry.index, 0U);
+        BOOST_CHECK(entry.txid == m_coinbase_txns[i]->GetHash());
+        BOOST_CHECK_EQUAL(entry.amount, m_coinbase_txns[i]->vout[0].nValue);
+    }
+
+    // A limited lookup stops at a block boundary and says where to continue.
+    history = script_index.FindScriptHistory(coinbase_script, 20, 10);
+    BOOST_REQUIRE(history);
+    BOOST_REQUIRE_EQUAL(history->entries.size(), 10U);
+    BOOST_CHECK_EQUAL(history->entries.front().height, 20);
+    BOOST_CHECK_EQUAL(history->entries.back().height, 29);
+    BOOST_CHECK_EQUAL(history->next_height.value_or(-1), 30);
+
+    // Unknown scripts have no history.
+    CKey other_key{GenerateRandomKey()};
+    const CScript other_script{GetScriptForDestination(PKHash(other_key.GetPubKey()))};
+    history = script_index.FindScriptHistory(other_script, 0, 1000);
+    BOOST_REQUIRE(history);
+    BOOST_CHECK(history->entries.empty());
+
+    // Spend the first coinbase output to another script in a new block.
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                                   coinbaseKey, other_script, /*output_amount=*/CAmount(10 * COIN),
+                                                                   /*submit=*/false)};
+    const CBlock block{CreateAndProcessBlock({spend}, coinbase_script)};
+    const int spend_height{WITH_LOCK(::cs_main, return m_node.chainman->ActiveHeight())};
+    BOOST_CHECK(script_index.BlockUntilSyncedToCurrentChain());
+
+    history = script_index.FindScriptHistory(coinbase_script, spend_height, 1000);
+    BOOST_REQUIRE(history);
+    BOOST_REQUIRE_EQUAL(history->entries.size(), 2U);
+    // The new coinbase output comes first, then the spend in the block's second transaction.
+    BOOST_CHECK(history->entries[0].txid == block.vtx[0]->GetHash());
+    BOOST_CHECK(!history->entries[0].spend);
+    const ScriptHistoryEntry& spent{history->entries[1]};
+    BOOST_CHECK(spent.spend);
+    BOOST_CHECK_EQUAL(spent.height, spend_height);
+    BOOST_CHECK_EQUAL(spent.tx_pos, 1U);
+    BOOST_CHECK_EQUAL(spent.index, 0U);
+    BOOST_CHECK(spent.txid == spend.GetHash());
+    BOOST_CHECK(spent.prevout == COutPoint(m_coinbase_txns[0]->GetHash(), 0));
+    BOOST_CHECK_EQUAL(spent.amount, m_coinbase_txns[0]->vout[0].nValue);
+
+    history = script_index.FindScriptHistory(other_script, 0, 1000);
+    BOOST_REQUIRE(history);
+    BOOST_REQUIRE_EQUAL(history->entries.size(), 1U);
+    BOOST_CHECK_EQUAL(history->entries[0].height, spend_height);
+    BOOST_CHECK(history->entries[0].txid == spend.GetHash());
+    BOOST_CHECK_EQUAL(history->entries[0].amount, 10 * COIN);
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    script_index.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(scriptindex_history_limit, TestChain100Setup)
+{
+    g_script_index = std::make_unique<ScriptIndex>(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(g_script_index->Init());
+    g_script_index->Sync();
+
+    // Alternate the coinbase outputs of ten new blocks between two scripts.
+    const CScript script_a{GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey()))};
+    const CScript script_b{GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey()))};
+    const int start_height{WITH_LOCK(::cs_main, return m_node.chainman->ActiveHeight()) + 1};
+    for (int i = 0; i < 10; ++i) {
+        CreateAndProcessBlock({}, i % 2 == 0 ? script_a : script_b);
+    }
+    BOOST_CHECK(g_script_index->BlockUntilSyncedToCurrentChain());
+
+    // The limit applies to the merged history, not to that of each script.
+    const UniValue result{ScriptHistoryToJSON(*m_node.chainman, {script_a, script_b}, start_height, /*limit=*/5)};
+    const UniValue& history{result["history"]};
+    BOOST_REQUIRE_EQUAL(history.size(), 5U);
+    for (size_t i = 0; i < history.size(); ++i) {
+        const int height{start_height + int(i)};
+        BOOST_CHECK_EQUAL(history[i]["height"].getInt<int>(), height);
+        BOOST_CHECK_EQUAL(history[i]["scriptPubKey"].get_str(), HexStr(i % 2 == 0 ? script_a : script_b));
+        BOOST_CHECK_EQUAL(history[i]["blockhash"].get_str(), WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain()[height]->GetBlockHash().GetHex()));
+    }
+    BOOST_CHECK_EQUAL(result["next_height"].getInt<int>(), start_height + 5);
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    g_script_index->Stop();
+    g_script_index.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,12 +3,18 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <addresstype.h>
+#include <blockfilter.h>
 #include <chainparams.h>
+#include <index/blockfilterindex.h>
+#include <index/readahead.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <test/util/setup_common.h>
+#include <undo.h>
 #include <validation.h>
 
+#include <thread>
+
 #include <boost/test/unit_test.hpp>
 
 BOOST_AUTO_TEST_SUITE(txindex_tests)
@@ -73,4 +79,60 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     txindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_initial_sync_read_ahead, TestChain100Setup)
+{
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true);
+    txindex.SetReadAhead(std::make_shared<BlockReadAhead>(m_node.chainman->m_blockman, /*num_threads=*/2));
+    BOOST_REQUIRE(txindex.Init());
+    txindex.Sync();
+
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    for (const auto& txn : Params().GenesisBlock().vtx) {
+        BOOST_CHECK(!txindex.FindTx(txn->GetHash(), block_hash, tx_disk));
+    }
+    for (const auto& txn : m_coinbase_txns) {
+        BOOST_REQUIRE(txindex.FindTx(txn->GetHash(), block_hash, tx_disk));
+        BOOST_CHECK_EQUAL(tx_disk->GetHash(), txn->GetHash());
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(txindex_shared_read_ahead, TestChain100Setup)
+{
+    // Two indexes syncing concurrently from one read-ahead source, one of
+    // which needs undo data and prepares filters on the workers.
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true);
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+    {
+        auto read_ahead{std::make_shared<BlockReadAhead>(m_node.chainman->m_blockman, /*num_threads=*/2)};
+        txindex.SetReadAhead(read_ahead);
+        filter_index.SetReadAhead(read_ahead);
+    }
+    BOOST_REQUIRE(txindex.Init());
+    BOOST_REQUIRE(filter_index.Init());
+    std::thread filter_sync{[&] { filter_index.Sync(); }};
+    txindex.Sync();
+    filter_sync.join();
+
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    for (const auto& txn : m_coinbase_txns) {
+        BOOST_REQUIRE(txindex.FindTx(txn->GetHash(), block_hash, tx_disk));
+        BOOST_CHECK_EQUAL(tx_disk->GetHash(), txn->GetHash());
+    }
+
+    LOCK(cs_main);
+    for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+         block_index != nullptr;
+         block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+        CBlock block;
+        CBlockUndo block_undo;
+        BOOST_REQUIRE(m_node.chainman->m_blockman.ReadBlock(block, *block_index));
+        if (block_index->nHeight > 0) BOOST_REQUIRE(m_node.chainman->m_blockman.ReadBlockUndo(block_undo, *block_index));
+        BlockFilter filter;
+        BOOST_REQUIRE(filter_index.LookupFilter(block_index, filter));
+        BOOST_CHECK(filter.GetEncodedFilter() == BlockFilter(BlockFilterType::BASIC, block, block_undo).GetEncodedFilter());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
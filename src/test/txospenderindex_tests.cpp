@@ -0,0 +1,82 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <chain.h>
+#include <consensus/validation.h>
+#include <index/txospenderindex.h>
+#include <interfaces/chain.h>
+#include <key.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(txospenderindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(txospenderindex_initial_sync, TestChain100Setup)
+{
+    TxoSpenderIndex txospender_index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(txospender_index.Init());
+    txospender_index.Sync();
+
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const std::vector<COutPoint> outpoints{
+        {m_coinbase_txns[0]->GetHash(), 0},
+        {m_coinbase_txns[1]->GetHash(), 0},
+        {m_coinbase_txns[2]->GetHash(), 0},
+    };
+
+    // Nothing in the test chain spends its coinbase outputs yet.
+    for (const auto& spender : txospender_index.FindSpenders(outpoints)) {
+        BOOST_CHECK(!spender);
+    }
+
+    // Spend the first and the third output, in two transactions of one block,
+    // once the third one has matured.
+    const CScript other_script{GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey()))};
+    CreateAndProcessBlock({}, other_script);
+    CreateAndProcessBlock({}, other_script);
+    const CMutableTransaction spend_a{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                                     coinbaseKey, other_script, /*output_amount=*/CAmount(10 * COIN),
+                                                                     /*submit=*/false)};
+    const CMutableTransaction spend_c{CreateValidMempoolTransaction(m_coinbase_txns[2], /*input_vout=*/0, /*input_height=*/3,
+                                                                     coinbaseKey, other_script, /*output_amount=*/CAmount(10 * COIN),
+                                                                     /*submit=*/false)};
+    const CBlock block{CreateAndProcessBlock({spend_a, spend_c}, coinbase_script)};
+    const int spend_height{WITH_LOCK(::cs_main, return m_node.chainman->ActiveHeight())};
+    BOOST_CHECK(txospender_index.BlockUntilSyncedToCurrentChain());
+
+    auto spenders{txospender_index.FindSpenders(outpoints)};
+    BOOST_REQUIRE_EQUAL(spenders.size(), 3U);
+    BOOST_REQUIRE(spenders[0]);
+    BOOST_CHECK(spenders[0]->txid == spend_a.GetHash());
+    BOOST_CHECK_EQUAL(spenders[0]->vin, 0U);
+    BOOST_CHECK_EQUAL(spenders[0]->height, spend_height);
+    BOOST_CHECK(spenders[0]->block_hash == block.GetHash());
+    BOOST_CHECK(!spenders[1]);
+    BOOST_REQUIRE(spenders[2]);
+    BOOST_CHECK(spenders[2]->txid == spend_c.GetHash());
+
+    // Replace the block with one that does not spend the outputs; the spends are removed again.
+    {
+        BlockValidationState state;
+        CBlockIndex* spend_block{WITH_LOCK(::cs_main, return m_node.chainman->m_blockman.LookupBlockIndex(block.GetHash()))};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, spend_block));
+    }
+    CreateAndProcessBlock({}, other_script);
+    CreateAndProcessBlock({}, other_script);
+    BOOST_CHECK(txospender_index.BlockUntilSyncedToCurrentChain());
+    for (const auto& spender : txospender_index.FindSpenders(outpoints)) {
+        BOOST_CHECK(!spender);
+    }
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    txospender_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
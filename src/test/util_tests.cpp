@@ -248,6 +248,11 @@ BOOST_AUTO_TEST_CASE(util_HexStr)
         BOOST_CHECK_EQUAL(HexStr(in_u), out_exp);
         BOOST_CHECK_EQUAL(HexStr(in_s), out_exp);
         BOOST_CHECK_EQUAL(HexStr(in_b), out_exp);
+
+        // Encoding into a buffer only writes the part it is given.
+        std::string out(out_exp.size() + 2, '-');
+        HexEncode(in_b, std::span{out}.subspan(1, out_exp.size()));
+        BOOST_CHECK_EQUAL(out, "-" + std::string{out_exp} + "-");
     }
 
     {
@@ -269,6 +274,43 @@ BOOST_AUTO_TEST_CASE(util_HexStr)
     }
 }
 
+BOOST_AUTO_TEST_CASE(util_hex_implementations)
+{
+    static constexpr std::string_view hexmap{"0123456789abcdef"};
+    for (const auto impl : {hex_implementation::STANDARD, hex_implementation::USE_SSE41, hex_implementation::USE_SSE41_AND_AVX2}) {
+        BOOST_TEST_MESSAGE("Using the '" << HexAutoDetect(impl) << "' hex implementation");
+        // Cover whole SIMD blocks as well as the scalar tail on either side.
+        for (size_t len = 0; len <= 100; ++len) {
+            const std::vector<uint8_t> data{m_rng.randbytes(len)};
+            std::string expected;
+            for (const uint8_t b : data) {
+                expected.push_back(hexmap[b >> 4]);
+                expected.push_back(hexmap[b & 15]);
+            }
+            BOOST_CHECK_EQUAL(HexStr(data), expected);
+            BOOST_CHECK(TryParseHex<uint8_t>(expected) == data);
+            BOOST_CHECK(TryParseHex<uint8_t>(ToUpper(expected)) == data);
+
+            // An invalid digit anywhere makes the whole string invalid.
+            for (size_t pos = 0; pos < expected.size(); ++pos) {
+                for (const char bad : {'g', 'G', '/', ':', '@', '`', '\0', '\xff'}) {
+                    std::string invalid{expected};
+                    invalid[pos] = bad;
+                    BOOST_CHECK(!TryParseHex(invalid).has_value());
+                }
+            }
+
+            // Spaces between pairs are skipped.
+            if (len > 0) {
+                std::string spaced{expected};
+                spaced.insert(m_rng.randrange(len) * 2, " ");
+                BOOST_CHECK(TryParseHex<uint8_t>(spaced) == data);
+            }
+        }
+    }
+    HexAutoDetect();
+}
+
 BOOST_AUTO_TEST_CASE(span_write_bytes)
 {
     std::array mut_arr{uint8_t{0xaa}, uint8_t{0xbb}};
@@ -3,7 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 //
 #include <chainparams.h>
+#include <coins.h>
 #include <consensus/validation.h>
+#include <hash.h>
+#include <kernel/coinstats.h>
 #include <kernel/disconnected_transactions.h>
 #include <node/chainstatemanager_args.h>
 #include <node/kernel_notifications.h>
@@ -16,6 +19,7 @@
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <test/util/validation.h>
+#include <txdb.h>
 #include <uint256.h>
 #include <util/result.h>
 #include <util/vector.h>
@@ -24,6 +28,7 @@
 
 #include <tinyformat.h>
 
+#include <algorithm>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -424,6 +429,97 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_snapshot, SnapshotTestSetup)
 //!   chainstate only contains fully validated blocks and the other chainstate contains all blocks,
 //!   except those marked assume-valid, because those entries don't HAVE_DATA.
 //!
+//! Test that chunked snapshots are loaded, and that bad ones are rejected.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_chunked_snapshot, SnapshotTestSetup)
+{
+    ChainstateManager& chainman = *Assert(m_node.chainman);
+    constexpr int snapshot_height = 110;
+    mineBlocks(10);
+
+    BOOST_REQUIRE(!CreateAndActivateUTXOSnapshot(
+        this, [](AutoFile& auto_infile, SnapshotMetadata& metadata) {
+            // Coins count is smaller than coins in file
+            metadata.m_coins_count -= 1;
+        }, /*reset_chainstate=*/false, /*in_memory_chainstate=*/false, /*chunked=*/true));
+    BOOST_REQUIRE(!CreateAndActivateUTXOSnapshot(
+        this, [](AutoFile& auto_infile, SnapshotMetadata& metadata) {
+            // Coins count is larger than coins in file
+            metadata.m_coins_count += 1;
+        }, /*reset_chainstate=*/false, /*in_memory_chainstate=*/false, /*chunked=*/true));
+    BOOST_REQUIRE(!CreateAndActivateUTXOSnapshot(
+        this, [](AutoFile& auto_infile, SnapshotMetadata& metadata) {
+            // Chunks left over
+            metadata.m_chunk_count -= 1;
+        }, /*reset_chainstate=*/false, /*in_memory_chainstate=*/false, /*chunked=*/true));
+    BOOST_REQUIRE(!CreateAndActivateUTXOSnapshot(
+        this, [&](AutoFile& auto_infile, SnapshotMetadata& metadata) {
+            // Flip the last byte of the file, which belongs to the last chunk
+            // or its checksum.
+            const int64_t pos{auto_infile.tell()};
+            AutoFile file{fsbridge::fopen(m_path_root / fs::u8path(strprintf("test_snapshot.%d.dat", snapshot_height)), "r+b")};
+            file.seek(-1, SEEK_END);
+            uint8_t last;
+            file >> last;
+            file.seek(-1, SEEK_END);
+            file << uint8_t(~last);
+            BOOST_REQUIRE_EQUAL(file.fclose(), 0);
+            // Drop what was read ahead of the current position.
+            auto_infile.seek(pos, SEEK_SET);
+        }, /*reset_chainstate=*/false, /*in_memory_chainstate=*/false, /*chunked=*/true));
+    BOOST_CHECK(!node::FindSnapshotChainstateDir(chainman.m_options.datadir));
+
+    BOOST_REQUIRE(CreateAndActivateUTXOSnapshot(
+        this, [](AutoFile& auto_infile, SnapshotMetadata& metadata) {
+            BOOST_CHECK(metadata.IsChunked());
+            BOOST_CHECK_EQUAL(metadata.m_chunk_count, SNAPSHOT_CHUNKS);
+        }, /*reset_chainstate=*/false, /*in_memory_chainstate=*/false, /*chunked=*/true));
+    BOOST_CHECK(chainman.IsSnapshotActive());
+
+    LOCK(::cs_main);
+    CCoinsViewCache& coinscache = chainman.ActiveChainstate().CoinsTip();
+    for (const CTransactionRef& txn : m_coinbase_txns) {
+        BOOST_CHECK(coinscache.HaveCoin(COutPoint{txn->GetHash(), 0}));
+    }
+    BOOST_CHECK_EQUAL(m_coinbase_txns.size(), size_t{snapshot_height});
+}
+
+//! Test that the coins of a transaction are hashed for a chunked snapshot in the
+//! order the coin stats hash them, also where the database orders them differently.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_snapshot_coins_hash_order, TestChain100Setup)
+{
+    CCoinsViewDB coins_db{{.path = "test", .cache_bytes = 1 << 20, .memory_only = true}, {}};
+    const Txid txid{Txid::FromUint256(m_rng.rand256())};
+    {
+        CCoinsViewCache cache{&coins_db};
+        for (const uint32_t n : {0, 255, 256, 16511, 16512, 16513, 100000}) {
+            cache.AddCoin(COutPoint{txid, n}, Coin{CTxOut{n + 1, CScript{} << OP_TRUE}, /*nHeightIn=*/1, /*fCoinBaseIn=*/false}, /*possible_overwrite=*/false);
+        }
+        cache.SetBestBlock(WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip()->GetBlockHash()));
+        BOOST_REQUIRE(cache.Flush());
+    }
+
+    // Collect the coins in database order, as dumptxoutset writes them. From
+    // 16512 on, output indexes do not sort numerically there.
+    std::vector<std::pair<COutPoint, Coin>> coins;
+    for (std::unique_ptr<CCoinsViewCursor> cursor{coins_db.Cursor()}; cursor->Valid(); cursor->Next()) {
+        COutPoint outpoint;
+        Coin coin;
+        BOOST_REQUIRE(cursor->GetKey(outpoint) && cursor->GetValue(coin));
+        coins.emplace_back(outpoint, std::move(coin));
+    }
+    BOOST_REQUIRE_EQUAL(coins.size(), 7U);
+    BOOST_CHECK(!std::ranges::is_sorted(coins, {}, [](const auto& entry) { return entry.first.n; }));
+
+    DataStream hash_data;
+    kernel::ApplyTxCoinsHash(hash_data, coins);
+    HashWriter ss{};
+    ss.write(std::span<const std::byte>{hash_data.data(), hash_data.size()});
+
+    const auto stats{kernel::ComputeUTXOStats(kernel::CoinStatsHashType::HASH_SERIALIZED, &coins_db, m_node.chainman->m_blockman)};
+    BOOST_REQUIRE(stats);
+    BOOST_CHECK_EQUAL(ss.GetHash(), stats->hashSerialized);
+}
+
 BOOST_FIXTURE_TEST_CASE(chainstatemanager_loadblockindex, TestChain100Setup)
 {
     ChainstateManager& chainman = *Assert(m_node.chainman);
@@ -834,6 +930,18 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_args, BasicTestingSetup)
 
     BOOST_CHECK(!get_opts({"-minimumchainwork=xyz"}));                                                               // invalid hex characters
     BOOST_CHECK(!get_opts({"-minimumchainwork=01234567890123456789012345678901234567890123456789012345678901234"})); // > 64 hex chars
+
+    // test -backgroundpar
+    BOOST_CHECK(!get_valid_opts({}).background_worker_threads_num);
+    BOOST_CHECK_EQUAL(get_valid_opts({"-backgroundpar=1"}).background_worker_threads_num, 0);
+    BOOST_CHECK_EQUAL(get_valid_opts({"-backgroundpar=4"}).background_worker_threads_num, 3);
+    BOOST_CHECK_EQUAL(get_valid_opts({"-backgroundpar=-1000"}).background_worker_threads_num, 0);
+
+    // test -backgroundcache
+    BOOST_CHECK_EQUAL(get_valid_opts({}).background_cache_percent, DEFAULT_BACKGROUND_CACHE_PERCENT);
+    BOOST_CHECK_EQUAL(get_valid_opts({"-backgroundcache=50"}).background_cache_percent, 50);
+    BOOST_CHECK(!get_opts({"-backgroundcache=0"}));
+    BOOST_CHECK(!get_opts({"-backgroundcache=100"}));
 }
 
 BOOST_AUTO_TEST_SUITE_END()
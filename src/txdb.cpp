@@ -154,6 +154,15 @@ bool CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashB
     return ret;
 }
 
+bool CCoinsViewDB::WriteCoins(std::span<const std::pair<COutPoint, Coin>> coins)
+{
+    CDBBatch batch{*m_db};
+    for (const auto& [outpoint, coin] : coins) {
+        batch.Write(CoinEntry(&outpoint), coin);
+    }
+    return m_db->WriteBatch(batch);
+}
+
 size_t CCoinsViewDB::EstimateSize() const
 {
     return m_db->EstimateSize(DB_COIN, uint8_t(DB_COIN + 1));
@@ -174,8 +183,12 @@ public:
 
     bool Valid() const override;
     void Next() override;
+    bool Seek(const COutPoint& start) override;
 
 private:
+    //! Cache the key of the current record.
+    void LoadKey();
+
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
 
@@ -191,14 +204,18 @@ std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
        that restriction.  */
     i->pcursor->Seek(DB_COIN);
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
+    i->LoadKey();
+    return i;
+}
+
+void CCoinsViewDBCursor::LoadKey()
+{
+    CoinEntry entry(&keyTmp.second);
+    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
+        keyTmp.first = 0; // Make sure Valid() and GetKey() return false
     } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+        keyTmp.first = entry.key;
     }
-    return i;
 }
 
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
@@ -224,10 +241,12 @@ bool CCoinsViewDBCursor::Valid() const
 void CCoinsViewDBCursor::Next()
 {
     pcursor->Next();
-    CoinEntry entry(&keyTmp.second);
-    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
-        keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
-    } else {
-        keyTmp.first = entry.key;
-    }
+    LoadKey();
+}
+
+bool CCoinsViewDBCursor::Seek(const COutPoint& start)
+{
+    pcursor->Seek(CoinEntry(&start));
+    LoadKey();
+    return true;
 }
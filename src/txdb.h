@@ -16,6 +16,8 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 class COutPoint;
@@ -50,6 +52,10 @@ public:
     bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
 
+    //! Write coins straight to the database in one batch, leaving the best block unchanged.
+    //! Used to bulk load UTXO snapshots; may be called from several threads at once.
+    bool WriteCoins(std::span<const std::pair<COutPoint, Coin>> coins);
+
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
     size_t EstimateSize() const override;
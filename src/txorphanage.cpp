@@ -190,9 +190,10 @@ void TxOrphanage::AddChildrenToWorkSet(const CTransaction& tx, FastRandomContext
 
                 // Get this source peer's work set, emplacing an empty set if it didn't exist
                 // (note: if this peer wasn't still connected, we would have removed the orphan tx already)
-                std::set<Wtxid>& orphan_work_set = m_peer_orphanage_info.try_emplace(announcer).first->second.m_work_set;
+                auto& peer_info = m_peer_orphanage_info.try_emplace(announcer).first->second;
                 // Add this tx to the work set
-                orphan_work_set.insert(elem->first);
+                peer_info.m_work_set.insert(elem->first);
+                peer_info.m_precheck_set.insert(elem->first);
                 LogDebug(BCLog::TXPACKAGES, "added %s (wtxid=%s) to peer %d workset\n",
                          tx.GetHash().ToString(), tx.GetWitnessHash().ToString(), announcer);
             }
@@ -226,6 +227,7 @@ CTransactionRef TxOrphanage::GetTxToReconsider(NodeId peer)
     while (!work_set.empty()) {
         Wtxid wtxid = *work_set.begin();
         work_set.erase(work_set.begin());
+        peer_it->second.m_precheck_set.erase(wtxid);
 
         const auto orphan_it = m_orphans.find(wtxid);
         if (orphan_it != m_orphans.end()) {
@@ -235,6 +237,21 @@ CTransactionRef TxOrphanage::GetTxToReconsider(NodeId peer)
     return nullptr;
 }
 
+std::vector<CTransactionRef> TxOrphanage::GetTxsToPrecheck(NodeId peer, size_t max_count)
+{
+    std::vector<CTransactionRef> result;
+    auto peer_it = m_peer_orphanage_info.find(peer);
+    if (peer_it == m_peer_orphanage_info.end()) return result;
+
+    auto& precheck_set = peer_it->second.m_precheck_set;
+    while (!precheck_set.empty() && result.size() < max_count) {
+        const auto orphan_it = m_orphans.find(*precheck_set.begin());
+        precheck_set.erase(precheck_set.begin());
+        if (orphan_it != m_orphans.end()) result.push_back(orphan_it->second.tx);
+    }
+    return result;
+}
+
 bool TxOrphanage::HaveTxToReconsider(NodeId peer)
 {
     auto peer_it = m_peer_orphanage_info.find(peer);
@@ -49,6 +49,11 @@ public:
      */
     CTransactionRef GetTxToReconsider(NodeId peer);
 
+    /** Get up to max_count transactions that were added to a peer's work set and not returned by this
+     *  function yet, so that they can be checked ahead of their turn in GetTxToReconsider. Does not
+     *  remove them from the work set. */
+    std::vector<CTransactionRef> GetTxsToPrecheck(NodeId peer, size_t max_count);
+
     /** Erase an orphan by wtxid */
     int EraseTx(const Wtxid& wtxid);
 
@@ -132,6 +137,10 @@ protected:
          * GetTxToReconsider. */
         std::set<Wtxid> m_work_set;
 
+        /** Subset of m_work_set that has not been returned by GetTxsToPrecheck yet. Like m_work_set, it may
+         * refer to transactions that are no longer present in orphanage. */
+        std::set<Wtxid> m_precheck_set;
+
         /** Total weight of orphans for which this peer is an announcer.
          * If orphans are provided by different peers, its weight will be accounted for in each
          * PeerOrphanInfo, so the total of all peers' m_total_usage may be larger than
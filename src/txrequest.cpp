@@ -9,17 +9,15 @@
 #include <primitives/transaction.h>
 #include <random.h>
 #include <uint256.h>
+#include <util/hasher.h>
 
-#include <boost/multi_index/indexed_by.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/sequenced_index.hpp>
-#include <boost/multi_index/tag.hpp>
-#include <boost/multi_index_container.hpp>
-#include <boost/tuple/tuple.hpp>
-
+#include <algorithm>
 #include <chrono>
+#include <limits>
+#include <map>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <cassert>
 
@@ -28,7 +26,6 @@ namespace {
 /** The various states a (txhash,peer) pair can be in.
  *
  * Note that CANDIDATE is split up into 3 substates (DELAYED, BEST, READY), allowing more efficient implementation.
- * Also note that the sorting order of ByTxHashView relies on the specific order of values in this enum.
  *
  * Expected behaviour is:
  *   - When first announced by a peer, the state is CANDIDATE_DELAYED until reqtime is reached.
@@ -54,29 +51,49 @@ enum class State : uint8_t {
     COMPLETED,
 };
 
+
 //! Type alias for sequence numbers.
 using SequenceNumber = uint64_t;
 
+//! Type alias for priorities.
+using Priority = uint64_t;
+
+//! Type alias for positions of announcements in the main data structure.
+using AnnIndex = uint32_t;
+
+//! Sentinel AnnIndex value, meaning "no announcement".
+constexpr AnnIndex NO_ANNOUNCEMENT{std::numeric_limits<AnnIndex>::max()};
+
 /** An announcement. This is the data we track for each txid or wtxid that is announced to us by each peer. */
 struct Announcement {
     /** Txid or wtxid that was announced. */
-    const uint256 m_txhash;
+    uint256 m_txhash;
     /** For CANDIDATE_{DELAYED,BEST,READY} the reqtime; for REQUESTED the expiry. */
     std::chrono::microseconds m_time;
     /** What peer the request was from. */
-    const NodeId m_peer;
+    NodeId m_peer;
+    /** The priority of this announcement. It only depends on immutable fields, and is cached here because it is
+     *  needed every time the best candidate for a txhash is reselected. */
+    Priority m_priority;
+    /** Position of this announcement in its peer's PeerInfo::m_announcements. */
+    uint32_t m_peer_pos{0};
+    /** Position of this announcement in its peer's PeerInfo::m_best (only meaningful if CANDIDATE_BEST). */
+    uint32_t m_best_pos{0};
     /** What sequence number this announcement has. */
-    const SequenceNumber m_sequence : 59;
+    SequenceNumber m_sequence : 58;
     /** Whether the request is preferred. */
-    const bool m_preferred : 1;
+    bool m_preferred : 1;
     /** Whether this is a wtxid request. */
-    const bool m_is_wtxid : 1;
+    bool m_is_wtxid : 1;
 
     /** What state this announcement is in. */
     State m_state : 3 {State::CANDIDATE_DELAYED};
     State GetState() const { return m_state; }
     void SetState(State state) { m_state = state; }
 
+    /** Whether this slot of the main data structure is unused (the announcement was deleted). */
+    bool m_free : 1 {false};
+
     /** Whether this announcement is selected. There can be at most 1 selected peer per txhash. */
     bool IsSelected() const
     {
@@ -97,14 +114,11 @@ struct Announcement {
 
     /** Construct a new announcement from scratch, initially in CANDIDATE_DELAYED state. */
     Announcement(const GenTxid& gtxid, NodeId peer, bool preferred, std::chrono::microseconds reqtime,
-                 SequenceNumber sequence)
-        : m_txhash(gtxid.GetHash()), m_time(reqtime), m_peer(peer), m_sequence(sequence), m_preferred(preferred),
-          m_is_wtxid{gtxid.IsWtxid()} {}
+                 SequenceNumber sequence, Priority priority)
+        : m_txhash(gtxid.GetHash()), m_time(reqtime), m_peer(peer), m_priority(priority), m_sequence(sequence),
+          m_preferred(preferred), m_is_wtxid{gtxid.IsWtxid()} {}
 };
 
-//! Type alias for priorities.
-using Priority = uint64_t;
-
 /** A functor with embedded salt that computes priority of an announcement.
  *
  * Higher priorities are selected first.
@@ -128,112 +142,29 @@ public:
     }
 };
 
-// Definitions for the 3 indexes used in the main data structure.
-//
-// Each index has a By* type to identify it, a By*View data type to represent the view of announcement it is sorted
-// by, and an By*ViewExtractor type to convert an announcement into the By*View type.
-// See https://www.boost.org/doc/libs/1_58_0/libs/multi_index/doc/reference/key_extraction.html#key_extractors
-// for more information about the key extraction concept.
-
-// The ByPeer index is sorted by (peer, state == CANDIDATE_BEST, txhash)
-//
-// Uses:
-// * Looking up existing announcements by peer/txhash, by checking both (peer, false, txhash) and
-//   (peer, true, txhash).
-// * Finding all CANDIDATE_BEST announcements for a given peer in GetRequestable.
-struct ByPeer {};
-using ByPeerView = std::tuple<NodeId, bool, const uint256&>;
-struct ByPeerViewExtractor
-{
-    using result_type = ByPeerView;
-    result_type operator()(const Announcement& ann) const
-    {
-        return ByPeerView{ann.m_peer, ann.GetState() == State::CANDIDATE_BEST, ann.m_txhash};
-    }
-};
-
-// The ByTxHash index is sorted by (txhash, state, priority).
-//
-// Note: priority == 0 whenever state != CANDIDATE_READY.
-//
-// Uses:
-// * Deleting all announcements with a given txhash in ForgetTxHash.
-// * Finding the best CANDIDATE_READY to convert to CANDIDATE_BEST, when no other CANDIDATE_READY or REQUESTED
-//   announcement exists for that txhash.
-// * Determining when no more non-COMPLETED announcements for a given txhash exist, so the COMPLETED ones can be
-//   deleted.
-struct ByTxHash {};
-using ByTxHashView = std::tuple<const uint256&, State, Priority>;
-class ByTxHashViewExtractor {
-    const PriorityComputer& m_computer;
-public:
-    explicit ByTxHashViewExtractor(const PriorityComputer& computer) : m_computer(computer) {}
-    using result_type = ByTxHashView;
-    result_type operator()(const Announcement& ann) const
-    {
-        const Priority prio = (ann.GetState() == State::CANDIDATE_READY) ? m_computer(ann) : 0;
-        return ByTxHashView{ann.m_txhash, ann.GetState(), prio};
-    }
+/** A pending time event: the reqtime of a CANDIDATE_DELAYED announcement, or the expiry of a REQUESTED one.
+ *
+ * Events are kept in a min-heap ordered by time. They are not removed when their announcement changes or is
+ * deleted; instead they are validated against the announcement when they reach the top of the heap.
+ */
+struct TimeEvent {
+    std::chrono::microseconds m_time;
+    SequenceNumber m_sequence;
+    AnnIndex m_index;
 };
 
-enum class WaitState {
-    //! Used for announcements that need efficient testing of "is their timestamp in the future?".
-    FUTURE_EVENT,
-    //! Used for announcements whose timestamp is not relevant.
-    NO_EVENT,
-    //! Used for announcements that need efficient testing of "is their timestamp in the past?".
-    PAST_EVENT,
+/** Comparator that turns the std::*_heap functions into a min-heap on TimeEvent::m_time. */
+struct LaterEvent {
+    bool operator()(const TimeEvent& a, const TimeEvent& b) const { return a.m_time > b.m_time; }
 };
 
-WaitState GetWaitState(const Announcement& ann)
-{
-    if (ann.IsWaiting()) return WaitState::FUTURE_EVENT;
-    if (ann.IsSelectable()) return WaitState::PAST_EVENT;
-    return WaitState::NO_EVENT;
-}
-
-// The ByTime index is sorted by (wait_state, time).
-//
-// All announcements with a timestamp in the future can be found by iterating the index forward from the beginning.
-// All announcements with a timestamp in the past can be found by iterating the index backwards from the end.
-//
-// Uses:
-// * Finding CANDIDATE_DELAYED announcements whose reqtime has passed, and REQUESTED announcements whose expiry has
-//   passed.
-// * Finding CANDIDATE_READY/BEST announcements whose reqtime is in the future (when the clock time went backwards).
-struct ByTime {};
-using ByTimeView = std::pair<WaitState, std::chrono::microseconds>;
-struct ByTimeViewExtractor
-{
-    using result_type = ByTimeView;
-    result_type operator()(const Announcement& ann) const
-    {
-        return ByTimeView{GetWaitState(ann), ann.m_time};
-    }
-};
-
-struct Announcement_Indices final : boost::multi_index::indexed_by<
-    boost::multi_index::ordered_unique<boost::multi_index::tag<ByPeer>, ByPeerViewExtractor>,
-    boost::multi_index::ordered_non_unique<boost::multi_index::tag<ByTxHash>, ByTxHashViewExtractor>,
-    boost::multi_index::ordered_non_unique<boost::multi_index::tag<ByTime>, ByTimeViewExtractor>
->
-{};
-
-/** Data type for the main data structure (Announcement objects with ByPeer/ByTxHash/ByTime indexes). */
-using Index = boost::multi_index_container<
-    Announcement,
-    Announcement_Indices
->;
-
-/** Helper type to simplify syntax of iterator types. */
-template<typename Tag>
-using Iter = typename Index::index<Tag>::type::iterator;
-
-/** Per-peer statistics object. */
+/** Per-peer statistics object, and the lists of announcements belonging to the peer. */
 struct PeerInfo {
     size_t m_total = 0; //!< Total number of announcements for this peer.
     size_t m_completed = 0; //!< Number of COMPLETED announcements for this peer.
     size_t m_requested = 0; //!< Number of REQUESTED announcements for this peer.
+    std::vector<AnnIndex> m_announcements; //!< All announcements for this peer, in no particular order.
+    std::vector<AnnIndex> m_best; //!< The CANDIDATE_BEST announcements for this peer, in no particular order.
 };
 
 /** Per-txhash statistics object. Only used for sanity checking. */
@@ -255,18 +186,19 @@ struct TxHashInfo
     std::vector<NodeId> m_peers;
 };
 
-/** Compare two PeerInfo objects. Only used for sanity checking. */
+/** Compare the statistics of two PeerInfo objects. Only used for sanity checking. */
 bool operator==(const PeerInfo& a, const PeerInfo& b)
 {
     return std::tie(a.m_total, a.m_completed, a.m_requested) ==
            std::tie(b.m_total, b.m_completed, b.m_requested);
 };
 
-/** (Re)compute the PeerInfo map from the index. Only used for sanity checking. */
-std::unordered_map<NodeId, PeerInfo> RecomputePeerInfo(const Index& index)
+/** (Re)compute the PeerInfo statistics from the announcements. Only used for sanity checking. */
+std::unordered_map<NodeId, PeerInfo> RecomputePeerInfo(const std::vector<Announcement>& announcements)
 {
     std::unordered_map<NodeId, PeerInfo> ret;
-    for (const Announcement& ann : index) {
+    for (const Announcement& ann : announcements) {
+        if (ann.m_free) continue;
         PeerInfo& info = ret[ann.m_peer];
         ++info.m_total;
         info.m_requested += (ann.GetState() == State::REQUESTED);
@@ -276,10 +208,11 @@ std::unordered_map<NodeId, PeerInfo> RecomputePeerInfo(const Index& index)
 }
 
 /** Compute the TxHashInfo map. Only used for sanity checking. */
-std::map<uint256, TxHashInfo> ComputeTxHashInfo(const Index& index, const PriorityComputer& computer)
+std::map<uint256, TxHashInfo> ComputeTxHashInfo(const std::vector<Announcement>& announcements, const PriorityComputer& computer)
 {
     std::map<uint256, TxHashInfo> ret;
-    for (const Announcement& ann : index) {
+    for (const Announcement& ann : announcements) {
+        if (ann.m_free) continue;
         TxHashInfo& info = ret[ann.m_txhash];
         // Classify how many announcements of each state we have for this txhash.
         info.m_candidate_delayed += (ann.GetState() == State::CANDIDATE_DELAYED);
@@ -304,9 +237,28 @@ GenTxid ToGenTxid(const Announcement& ann)
     return ann.m_is_wtxid ? GenTxid::Wtxid(ann.m_txhash) : GenTxid::Txid(ann.m_txhash);
 }
 
+/** Remove idx from an unordered list of announcements, given its position in that list. The announcement that is
+ *  moved into its place gets its position updated through pos_of. */
+template<typename PosOf>
+void RemoveAtPosition(std::vector<AnnIndex>& list, uint32_t pos, PosOf pos_of)
+{
+    assert(pos < list.size());
+    const AnnIndex moved = list.back();
+    list[pos] = moved;
+    pos_of(moved) = pos;
+    list.pop_back();
+}
+
 }  // namespace
 
-/** Actual implementation for TxRequestTracker's data structure. */
+/** Actual implementation for TxRequestTracker's data structure.
+ *
+ * Announcements live in a flat vector whose slots are reused after deletion. They are reachable through three
+ * auxiliary structures, which replace the ordered indexes a multi-index container would provide:
+ * - m_txhashes maps every txhash to the (short) list of its announcements, one per announcing peer.
+ * - m_peerinfo holds, per peer, the list of all its announcements and of its CANDIDATE_BEST ones.
+ * - m_events is a min-heap of the times at which CANDIDATE_DELAYED and REQUESTED announcements need attention.
+ */
 class TxRequestTracker::Impl {
     //! The current sequence number. Increases for every announcement. This is used to sort txhashes returned by
     //! GetRequestable in announcement order.
@@ -315,21 +267,35 @@ class TxRequestTracker::Impl {
     //! This tracker's priority computer.
     const PriorityComputer m_computer;
 
-    //! This tracker's main data structure. See SanityCheck() for the invariants that apply to it.
-    Index m_index;
+    //! This tracker's announcements, indexed by AnnIndex. See SanityCheck() for the invariants that apply to them.
+    std::vector<Announcement> m_announcements;
+
+    //! Slots in m_announcements that are unused and can be reused for new announcements.
+    std::vector<AnnIndex> m_free_slots;
+
+    //! For every txhash, its announcements in no particular order.
+    std::unordered_map<uint256, std::vector<AnnIndex>, SaltedTxidHasher> m_txhashes;
 
-    //! Map with this tracker's per-peer statistics.
+    //! Map with this tracker's per-peer statistics and announcement lists.
     std::unordered_map<NodeId, PeerInfo> m_peerinfo;
 
+    //! Min-heap of pending time events (see TimeEvent). Can contain stale entries.
+    std::vector<TimeEvent> m_events;
+
+    //! Upper bound on the time of all IsSelectable() announcements. Only when the clock goes back to before this
+    //! time can any of them need to be converted back to CANDIDATE_DELAYED.
+    std::chrono::microseconds m_max_selectable_time{std::chrono::microseconds::min()};
+
 public:
     void SanityCheck() const
     {
-        // Recompute m_peerdata from m_index. This verifies the data in it as it should just be caching statistics
-        // on m_index. It also verifies the invariant that no PeerInfo announcements with m_total==0 exist.
-        assert(m_peerinfo == RecomputePeerInfo(m_index));
+        // Recompute m_peerdata from m_announcements. This verifies the data in it as it should just be caching
+        // statistics on m_announcements. It also verifies the invariant that no PeerInfo announcements with
+        // m_total==0 exist.
+        assert(m_peerinfo == RecomputePeerInfo(m_announcements));
 
-        // Calculate per-txhash statistics from m_index, and validate invariants.
-        for (auto& item : ComputeTxHashInfo(m_index, m_computer)) {
+        // Calculate per-txhash statistics from m_announcements, and validate invariants.
+        for (auto& item : ComputeTxHashInfo(m_announcements, m_computer)) {
             TxHashInfo& info = item.second;
 
             // Cannot have only COMPLETED peer (txhash should have been forgotten already)
@@ -354,11 +320,55 @@ public:
             std::sort(info.m_peers.begin(), info.m_peers.end());
             assert(std::adjacent_find(info.m_peers.begin(), info.m_peers.end()) == info.m_peers.end());
         }
+
+        // Every live announcement must be reachable exactly once through its txhash's list.
+        size_t listed{0};
+        for (const auto& [txhash, anns] : m_txhashes) {
+            assert(!anns.empty());
+            for (AnnIndex idx : anns) {
+                assert(!m_announcements[idx].m_free);
+                assert(m_announcements[idx].m_txhash == txhash);
+            }
+            listed += anns.size();
+        }
+        assert(listed == Size());
+        assert(m_free_slots.size() + Size() == m_announcements.size());
+
+        // The per-peer lists must match the announcements, and record their positions correctly.
+        for (const auto& [peer, info] : m_peerinfo) {
+            assert(info.m_announcements.size() == info.m_total);
+            for (uint32_t pos = 0; pos < info.m_announcements.size(); ++pos) {
+                const Announcement& ann = m_announcements[info.m_announcements[pos]];
+                assert(!ann.m_free && ann.m_peer == peer && ann.m_peer_pos == pos);
+            }
+            size_t num_best{0};
+            for (AnnIndex idx : info.m_announcements) num_best += m_announcements[idx].GetState() == State::CANDIDATE_BEST;
+            assert(info.m_best.size() == num_best);
+            for (uint32_t pos = 0; pos < info.m_best.size(); ++pos) {
+                const Announcement& ann = m_announcements[info.m_best[pos]];
+                assert(ann.m_peer == peer && ann.GetState() == State::CANDIDATE_BEST && ann.m_best_pos == pos);
+            }
+        }
+
+        // Cached priorities must be correct, every waiting announcement must have a pending event, and
+        // m_max_selectable_time must bound all selectable announcements.
+        std::vector<bool> has_event(m_announcements.size());
+        for (const TimeEvent& event : m_events) {
+            if (IsCurrent(event)) has_event[event.m_index] = true;
+        }
+        for (AnnIndex idx = 0; idx < m_announcements.size(); ++idx) {
+            const Announcement& ann = m_announcements[idx];
+            if (ann.m_free) continue;
+            assert(ann.m_priority == m_computer(ann));
+            if (ann.IsWaiting()) assert(has_event[idx]);
+            if (ann.IsSelectable()) assert(ann.m_time <= m_max_selectable_time);
+        }
     }
 
     void PostGetRequestableSanityCheck(std::chrono::microseconds now) const
     {
-        for (const Announcement& ann : m_index) {
+        for (const Announcement& ann : m_announcements) {
+            if (ann.m_free) continue;
             if (ann.IsWaiting()) {
                 // REQUESTED and CANDIDATE_DELAYED must have a time in the future (they should have been converted
                 // to COMPLETED/CANDIDATE_READY respectively).
@@ -372,116 +382,172 @@ public:
     }
 
 private:
-    //! Wrapper around Index::...::erase that keeps m_peerinfo up to date.
-    template<typename Tag>
-    Iter<Tag> Erase(Iter<Tag> it)
+    using TxHashIter = decltype(m_txhashes)::iterator;
+
+    //! Whether a time event still describes the current state of its announcement.
+    bool IsCurrent(const TimeEvent& event) const
+    {
+        const Announcement& ann = m_announcements[event.m_index];
+        return !ann.m_free && ann.m_sequence == event.m_sequence && ann.IsWaiting() && ann.m_time == event.m_time;
+    }
+
+    //! Schedule a time event for a (waiting) announcement.
+    void PushEvent(AnnIndex idx)
+    {
+        const Announcement& ann = m_announcements[idx];
+        m_events.push_back(TimeEvent{ann.m_time, ann.m_sequence, idx});
+        std::push_heap(m_events.begin(), m_events.end(), LaterEvent{});
+        // Stale events are only dropped once they reach the top of the heap. Rebuild it when they dominate, so its
+        // size stays proportional to the number of announcements.
+        if (m_events.size() > 2 * Size() + 64) {
+            m_events.clear();
+            for (AnnIndex i = 0; i < m_announcements.size(); ++i) {
+                const Announcement& other = m_announcements[i];
+                if (!other.m_free && other.IsWaiting()) m_events.push_back(TimeEvent{other.m_time, other.m_sequence, i});
+            }
+            std::make_heap(m_events.begin(), m_events.end(), LaterEvent{});
+        }
+    }
+
+    //! Change the state of an announcement, keeping m_peerinfo, the CANDIDATE_BEST lists, the time events and
+    //! m_max_selectable_time up to date.
+    void SetState(AnnIndex idx, State new_state)
+    {
+        Announcement& ann = m_announcements[idx];
+        const State old_state = ann.GetState();
+        if (old_state == new_state) return;
+        PeerInfo& info = m_peerinfo.find(ann.m_peer)->second;
+        info.m_completed -= old_state == State::COMPLETED;
+        info.m_requested -= old_state == State::REQUESTED;
+        if (old_state == State::CANDIDATE_BEST) {
+            RemoveAtPosition(info.m_best, ann.m_best_pos, [&](AnnIndex i) -> uint32_t& { return m_announcements[i].m_best_pos; });
+        }
+        ann.SetState(new_state);
+        info.m_completed += new_state == State::COMPLETED;
+        info.m_requested += new_state == State::REQUESTED;
+        if (new_state == State::CANDIDATE_BEST) {
+            ann.m_best_pos = info.m_best.size();
+            info.m_best.push_back(idx);
+        }
+        if (ann.IsSelectable()) m_max_selectable_time = std::max(m_max_selectable_time, ann.m_time);
+        if (ann.IsWaiting()) PushEvent(idx);
+    }
+
+    //! Delete an announcement, keeping m_peerinfo up to date. The caller must remove it from m_txhashes.
+    void Erase(AnnIndex idx)
+    {
+        Announcement& ann = m_announcements[idx];
+        auto peerit = m_peerinfo.find(ann.m_peer);
+        PeerInfo& info = peerit->second;
+        info.m_completed -= ann.GetState() == State::COMPLETED;
+        info.m_requested -= ann.GetState() == State::REQUESTED;
+        if (ann.GetState() == State::CANDIDATE_BEST) {
+            RemoveAtPosition(info.m_best, ann.m_best_pos, [&](AnnIndex i) -> uint32_t& { return m_announcements[i].m_best_pos; });
+        }
+        RemoveAtPosition(info.m_announcements, ann.m_peer_pos, [&](AnnIndex i) -> uint32_t& { return m_announcements[i].m_peer_pos; });
+        if (--info.m_total == 0) m_peerinfo.erase(peerit);
+        ann.m_free = true;
+        m_free_slots.push_back(idx);
+    }
+
+    //! Delete all announcements for a txhash.
+    void EraseTxHash(TxHashIter it)
+    {
+        for (AnnIndex idx : it->second) Erase(idx);
+        m_txhashes.erase(it);
+    }
+
+    //! Find the announcement by peer among a txhash's announcements.
+    AnnIndex FindByPeer(const std::vector<AnnIndex>& anns, NodeId peer) const
     {
-        auto peerit = m_peerinfo.find(it->m_peer);
-        peerit->second.m_completed -= it->GetState() == State::COMPLETED;
-        peerit->second.m_requested -= it->GetState() == State::REQUESTED;
-        if (--peerit->second.m_total == 0) m_peerinfo.erase(peerit);
-        return m_index.get<Tag>().erase(it);
+        for (AnnIndex idx : anns) {
+            if (m_announcements[idx].m_peer == peer) return idx;
+        }
+        return NO_ANNOUNCEMENT;
+    }
+
+    //! Find the IsSelected() announcement among a txhash's announcements.
+    AnnIndex FindSelected(const std::vector<AnnIndex>& anns) const
+    {
+        for (AnnIndex idx : anns) {
+            if (m_announcements[idx].IsSelected()) return idx;
+        }
+        return NO_ANNOUNCEMENT;
     }
 
-    //! Wrapper around Index::...::modify that keeps m_peerinfo up to date.
-    template<typename Tag, typename Modifier>
-    void Modify(Iter<Tag> it, Modifier modifier)
+    //! Find the highest-priority CANDIDATE_READY announcement among a txhash's announcements.
+    AnnIndex FindBestReady(const std::vector<AnnIndex>& anns) const
     {
-        auto peerit = m_peerinfo.find(it->m_peer);
-        peerit->second.m_completed -= it->GetState() == State::COMPLETED;
-        peerit->second.m_requested -= it->GetState() == State::REQUESTED;
-        m_index.get<Tag>().modify(it, std::move(modifier));
-        peerit->second.m_completed += it->GetState() == State::COMPLETED;
-        peerit->second.m_requested += it->GetState() == State::REQUESTED;
+        AnnIndex best{NO_ANNOUNCEMENT};
+        for (AnnIndex idx : anns) {
+            const Announcement& ann = m_announcements[idx];
+            if (ann.GetState() != State::CANDIDATE_READY) continue;
+            if (best == NO_ANNOUNCEMENT || ann.m_priority > m_announcements[best].m_priority) best = idx;
+        }
+        return best;
     }
 
     //! Convert a CANDIDATE_DELAYED announcement into a CANDIDATE_READY. If this makes it the new best
     //! CANDIDATE_READY (and no REQUESTED exists) and better than the CANDIDATE_BEST (if any), it becomes the new
     //! CANDIDATE_BEST.
-    void PromoteCandidateReady(Iter<ByTxHash> it)
+    void PromoteCandidateReady(AnnIndex idx, const std::vector<AnnIndex>& anns)
     {
-        assert(it != m_index.get<ByTxHash>().end());
-        assert(it->GetState() == State::CANDIDATE_DELAYED);
-        // Convert CANDIDATE_DELAYED to CANDIDATE_READY first.
-        Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_READY); });
-        // The following code relies on the fact that the ByTxHash is sorted by txhash, and then by state (first
-        // _DELAYED, then _READY, then _BEST/REQUESTED). Within the _READY announcements, the best one (highest
-        // priority) comes last. Thus, if an existing _BEST exists for the same txhash that this announcement may
-        // be preferred over, it must immediately follow the newly created _READY.
-        auto it_next = std::next(it);
-        if (it_next == m_index.get<ByTxHash>().end() || it_next->m_txhash != it->m_txhash ||
-            it_next->GetState() == State::COMPLETED) {
-            // This is the new best CANDIDATE_READY, and there is no IsSelected() announcement for this txhash
-            // already.
-            Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
-        } else if (it_next->GetState() == State::CANDIDATE_BEST) {
-            Priority priority_old = m_computer(*it_next);
-            Priority priority_new = m_computer(*it);
-            if (priority_new > priority_old) {
-                // There is a CANDIDATE_BEST announcement already, but this one is better.
-                Modify<ByTxHash>(it_next, [](Announcement& ann){ ann.SetState(State::CANDIDATE_READY); });
-                Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
-            }
+        assert(m_announcements[idx].GetState() == State::CANDIDATE_DELAYED);
+        const AnnIndex selected = FindSelected(anns);
+        if (selected == NO_ANNOUNCEMENT) {
+            // There is no IsSelected() announcement for this txhash, which by the invariants means there is no
+            // other CANDIDATE_READY either. This is the new CANDIDATE_BEST.
+            SetState(idx, State::CANDIDATE_BEST);
+        } else if (m_announcements[selected].GetState() == State::CANDIDATE_BEST &&
+                   m_announcements[idx].m_priority > m_announcements[selected].m_priority) {
+            // There is a CANDIDATE_BEST announcement already, but this one is better.
+            SetState(selected, State::CANDIDATE_READY);
+            SetState(idx, State::CANDIDATE_BEST);
+        } else {
+            SetState(idx, State::CANDIDATE_READY);
         }
     }
 
     //! Change the state of an announcement to something non-IsSelected(). If it was IsSelected(), the next best
     //! announcement will be marked CANDIDATE_BEST.
-    void ChangeAndReselect(Iter<ByTxHash> it, State new_state)
+    void ChangeAndReselect(AnnIndex idx, const std::vector<AnnIndex>& anns, State new_state)
     {
         assert(new_state == State::COMPLETED || new_state == State::CANDIDATE_DELAYED);
-        assert(it != m_index.get<ByTxHash>().end());
-        if (it->IsSelected() && it != m_index.get<ByTxHash>().begin()) {
-            auto it_prev = std::prev(it);
-            // The next best CANDIDATE_READY, if any, immediately precedes the REQUESTED or CANDIDATE_BEST
-            // announcement in the ByTxHash index.
-            if (it_prev->m_txhash == it->m_txhash && it_prev->GetState() == State::CANDIDATE_READY) {
-                // If one such CANDIDATE_READY exists (for this txhash), convert it to CANDIDATE_BEST.
-                Modify<ByTxHash>(it_prev, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
-            }
+        if (m_announcements[idx].IsSelected()) {
+            // If a CANDIDATE_READY exists for this txhash, convert the best one to CANDIDATE_BEST.
+            const AnnIndex next_best = FindBestReady(anns);
+            if (next_best != NO_ANNOUNCEMENT) SetState(next_best, State::CANDIDATE_BEST);
         }
-        Modify<ByTxHash>(it, [new_state](Announcement& ann){ ann.SetState(new_state); });
+        SetState(idx, new_state);
     }
 
-    //! Check if 'it' is the only announcement for a given txhash that isn't COMPLETED.
-    bool IsOnlyNonCompleted(Iter<ByTxHash> it)
+    //! Check if idx is the only announcement for a given txhash that isn't COMPLETED.
+    bool IsOnlyNonCompleted(AnnIndex idx, const std::vector<AnnIndex>& anns) const
     {
-        assert(it != m_index.get<ByTxHash>().end());
-        assert(it->GetState() != State::COMPLETED); // Not allowed to call this on COMPLETED announcements.
-
-        // This announcement has a predecessor that belongs to the same txhash. Due to ordering, and the
-        // fact that 'it' is not COMPLETED, its predecessor cannot be COMPLETED here.
-        if (it != m_index.get<ByTxHash>().begin() && std::prev(it)->m_txhash == it->m_txhash) return false;
-
-        // This announcement has a successor that belongs to the same txhash, and is not COMPLETED.
-        if (std::next(it) != m_index.get<ByTxHash>().end() && std::next(it)->m_txhash == it->m_txhash &&
-            std::next(it)->GetState() != State::COMPLETED) return false;
-
+        assert(m_announcements[idx].GetState() != State::COMPLETED); // Not allowed to call this on COMPLETED announcements.
+        for (AnnIndex other : anns) {
+            if (other != idx && m_announcements[other].GetState() != State::COMPLETED) return false;
+        }
         return true;
     }
 
     /** Convert any announcement to a COMPLETED one. If there are no non-COMPLETED announcements left for this
      *  txhash, they are deleted. If this was a REQUESTED announcement, and there are other CANDIDATEs left, the
      *  best one is made CANDIDATE_BEST. Returns whether the announcement still exists. */
-    bool MakeCompleted(Iter<ByTxHash> it)
+    bool MakeCompleted(AnnIndex idx, TxHashIter txit)
     {
-        assert(it != m_index.get<ByTxHash>().end());
-
         // Nothing to be done if it's already COMPLETED.
-        if (it->GetState() == State::COMPLETED) return true;
+        if (m_announcements[idx].GetState() == State::COMPLETED) return true;
 
-        if (IsOnlyNonCompleted(it)) {
+        if (IsOnlyNonCompleted(idx, txit->second)) {
             // This is the last non-COMPLETED announcement for this txhash. Delete all.
-            uint256 txhash = it->m_txhash;
-            do {
-                it = Erase<ByTxHash>(it);
-            } while (it != m_index.get<ByTxHash>().end() && it->m_txhash == txhash);
+            EraseTxHash(txit);
             return false;
         }
 
         // Mark the announcement COMPLETED, and select the next best announcement (the first CANDIDATE_READY) if
         // needed.
-        ChangeAndReselect(it, State::COMPLETED);
+        ChangeAndReselect(idx, txit->second, State::COMPLETED);
 
         return true;
     }
@@ -494,112 +560,112 @@ private:
     {
         if (expired) expired->clear();
 
-        // Iterate over all CANDIDATE_DELAYED and REQUESTED from old to new, as long as they're in the past,
-        // and convert them to CANDIDATE_READY and COMPLETED respectively.
-        while (!m_index.empty()) {
-            auto it = m_index.get<ByTime>().begin();
-            if (it->GetState() == State::CANDIDATE_DELAYED && it->m_time <= now) {
-                PromoteCandidateReady(m_index.project<ByTxHash>(it));
-            } else if (it->GetState() == State::REQUESTED && it->m_time <= now) {
-                if (expired) expired->emplace_back(it->m_peer, ToGenTxid(*it));
-                MakeCompleted(m_index.project<ByTxHash>(it));
+        // Process all CANDIDATE_DELAYED and REQUESTED events from old to new, as long as they're in the past,
+        // and convert the announcements to CANDIDATE_READY and COMPLETED respectively.
+        while (!m_events.empty() && m_events.front().m_time <= now) {
+            const TimeEvent event = m_events.front();
+            std::pop_heap(m_events.begin(), m_events.end(), LaterEvent{});
+            m_events.pop_back();
+            if (!IsCurrent(event)) continue;
+
+            const Announcement& ann = m_announcements[event.m_index];
+            auto txit = m_txhashes.find(ann.m_txhash);
+            if (ann.GetState() == State::CANDIDATE_DELAYED) {
+                PromoteCandidateReady(event.m_index, txit->second);
             } else {
-                break;
+                if (expired) expired->emplace_back(ann.m_peer, ToGenTxid(ann));
+                MakeCompleted(event.m_index, txit);
             }
         }
 
-        while (!m_index.empty()) {
+        if (now < m_max_selectable_time) {
             // If time went backwards, we may need to demote CANDIDATE_BEST and CANDIDATE_READY announcements back
             // to CANDIDATE_DELAYED. This is an unusual edge case, and unlikely to matter in production. However,
             // it makes it much easier to specify and test TxRequestTracker::Impl's behaviour.
-            auto it = std::prev(m_index.get<ByTime>().end());
-            if (it->IsSelectable() && it->m_time > now) {
-                ChangeAndReselect(m_index.project<ByTxHash>(it), State::CANDIDATE_DELAYED);
-            } else {
-                break;
+            for (AnnIndex idx = 0; idx < m_announcements.size(); ++idx) {
+                const Announcement& ann = m_announcements[idx];
+                if (!ann.m_free && ann.IsSelectable() && ann.m_time > now) {
+                    ChangeAndReselect(idx, m_txhashes.find(ann.m_txhash)->second, State::CANDIDATE_DELAYED);
+                }
             }
+            // All remaining IsSelectable() announcements have a time <= now.
+            m_max_selectable_time = now;
         }
     }
 
 public:
     explicit Impl(bool deterministic) :
-        m_computer(deterministic),
-        // Explicitly initialize m_index as we need to pass a reference to m_computer to ByTxHashViewExtractor.
-        m_index(boost::make_tuple(
-            boost::make_tuple(ByPeerViewExtractor(), std::less<ByPeerView>()),
-            boost::make_tuple(ByTxHashViewExtractor(m_computer), std::less<ByTxHashView>()),
-            boost::make_tuple(ByTimeViewExtractor(), std::less<ByTimeView>())
-        )) {}
-
-    // Disable copying and assigning (a default copy won't work due the stateful ByTxHashViewExtractor).
+        m_computer(deterministic) {}
+
+    // Disable copying and assigning (announcements refer to each other by position).
     Impl(const Impl&) = delete;
     Impl& operator=(const Impl&) = delete;
 
     void DisconnectedPeer(NodeId peer)
     {
-        auto& index = m_index.get<ByPeer>();
-        auto it = index.lower_bound(ByPeerView{peer, false, uint256::ZERO});
-        while (it != index.end() && it->m_peer == peer) {
-            // Check what to continue with after this iteration. 'it' will be deleted in what follows, so we need to
-            // decide what to continue with afterwards. There are a number of cases to consider:
-            // - std::next(it) is end() or belongs to a different peer. In that case, this is the last iteration
-            //   of the loop (denote this by setting it_next to end()).
-            // - 'it' is not the only non-COMPLETED announcement for its txhash. This means it will be deleted, but
-            //   no other Announcement objects will be modified. Continue with std::next(it) if it belongs to the
-            //   same peer, but decide this ahead of time (as 'it' may change position in what follows).
-            // - 'it' is the only non-COMPLETED announcement for its txhash. This means it will be deleted along
-            //   with all other announcements for the same txhash - which may include std::next(it). However, other
-            //   than 'it', no announcements for the same peer can be affected (due to (peer, txhash) uniqueness).
-            //   In other words, the situation where std::next(it) is deleted can only occur if std::next(it)
-            //   belongs to a different peer but the same txhash as 'it'. This is covered by the first bulletpoint
-            //   already, and we'll have set it_next to end().
-            auto it_next = (std::next(it) == index.end() || std::next(it)->m_peer != peer) ? index.end() :
-                std::next(it);
+        auto peerit = m_peerinfo.find(peer);
+        if (peerit == m_peerinfo.end()) return;
+        // Iterate over a copy, as the peer's list (and its PeerInfo entry) is modified below. Deleting one of the
+        // peer's announcements can delete other announcements for the same txhash, but due to (peer, txhash)
+        // uniqueness, never another announcement of this peer.
+        const std::vector<AnnIndex> anns{peerit->second.m_announcements};
+        for (AnnIndex idx : anns) {
+            auto txit = m_txhashes.find(m_announcements[idx].m_txhash);
             // If the announcement isn't already COMPLETED, first make it COMPLETED (which will mark other
             // CANDIDATEs as CANDIDATE_BEST, or delete all of a txhash's announcements if no non-COMPLETED ones are
             // left).
-            if (MakeCompleted(m_index.project<ByTxHash>(it))) {
+            if (MakeCompleted(idx, txit)) {
                 // Then actually delete the announcement (unless it was already deleted by MakeCompleted).
-                Erase<ByPeer>(it);
+                auto& list = txit->second;
+                list.erase(std::find(list.begin(), list.end(), idx));
+                Erase(idx);
             }
-            it = it_next;
         }
     }
 
     void ForgetTxHash(const uint256& txhash)
     {
-        auto it = m_index.get<ByTxHash>().lower_bound(ByTxHashView{txhash, State::CANDIDATE_DELAYED, 0});
-        while (it != m_index.get<ByTxHash>().end() && it->m_txhash == txhash) {
-            it = Erase<ByTxHash>(it);
-        }
+        auto it = m_txhashes.find(txhash);
+        if (it != m_txhashes.end()) EraseTxHash(it);
     }
 
     void GetCandidatePeers(const uint256& txhash, std::vector<NodeId>& result_peers) const
     {
-        auto it = m_index.get<ByTxHash>().lower_bound(ByTxHashView{txhash, State::CANDIDATE_DELAYED, 0});
-        while (it != m_index.get<ByTxHash>().end() && it->m_txhash == txhash && it->GetState() != State::COMPLETED) {
-            result_peers.push_back(it->m_peer);
-            ++it;
+        auto it = m_txhashes.find(txhash);
+        if (it == m_txhashes.end()) return;
+        for (AnnIndex idx : it->second) {
+            const Announcement& ann = m_announcements[idx];
+            if (ann.GetState() != State::COMPLETED) result_peers.push_back(ann.m_peer);
         }
     }
 
     void ReceivedInv(NodeId peer, const GenTxid& gtxid, bool preferred,
         std::chrono::microseconds reqtime)
     {
-        // Bail out if we already have a CANDIDATE_BEST announcement for this (txhash, peer) combination. The case
-        // where there is a non-CANDIDATE_BEST announcement already will be caught by the uniqueness property of the
-        // ByPeer index when we try to emplace the new object below.
-        if (m_index.get<ByPeer>().count(ByPeerView{peer, true, gtxid.GetHash()})) return;
-
-        // Try creating the announcement with CANDIDATE_DELAYED state (which will fail due to the uniqueness
-        // of the ByPeer index if a non-CANDIDATE_BEST announcement already exists with the same txhash and peer).
-        // Bail out in that case.
-        auto ret = m_index.get<ByPeer>().emplace(gtxid, peer, preferred, reqtime, m_current_sequence);
-        if (!ret.second) return;
+        // Bail out if we already have an announcement for this (txhash, peer) combination.
+        auto [txit, inserted] = m_txhashes.try_emplace(gtxid.GetHash());
+        if (!inserted && FindByPeer(txit->second, peer) != NO_ANNOUNCEMENT) return;
+
+        // Create the announcement with CANDIDATE_DELAYED state, reusing a free slot if there is one.
+        Announcement ann{gtxid, peer, preferred, reqtime, m_current_sequence, m_computer(gtxid.GetHash(), peer, preferred)};
+        AnnIndex idx;
+        if (m_free_slots.empty()) {
+            idx = m_announcements.size();
+            m_announcements.push_back(ann);
+        } else {
+            idx = m_free_slots.back();
+            m_free_slots.pop_back();
+            m_announcements[idx] = ann;
+        }
+        txit->second.push_back(idx);
 
         // Update accounting metadata.
-        ++m_peerinfo[peer].m_total;
+        PeerInfo& info = m_peerinfo[peer];
+        m_announcements[idx].m_peer_pos = info.m_announcements.size();
+        info.m_announcements.push_back(idx);
+        ++info.m_total;
         ++m_current_sequence;
+        PushEvent(idx);
     }
 
     //! Find the GenTxids to request now from peer.
@@ -611,11 +677,10 @@ public:
 
         // Find all CANDIDATE_BEST announcements for this peer.
         std::vector<const Announcement*> selected;
-        auto it_peer = m_index.get<ByPeer>().lower_bound(ByPeerView{peer, true, uint256::ZERO});
-        while (it_peer != m_index.get<ByPeer>().end() && it_peer->m_peer == peer &&
-            it_peer->GetState() == State::CANDIDATE_BEST) {
-            selected.emplace_back(&*it_peer);
-            ++it_peer;
+        auto peerit = m_peerinfo.find(peer);
+        if (peerit != m_peerinfo.end()) {
+            selected.reserve(peerit->second.m_best.size());
+            for (AnnIndex idx : peerit->second.m_best) selected.push_back(&m_announcements[idx]);
         }
 
         // Sort by sequence number.
@@ -634,57 +699,55 @@ public:
 
     void RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry)
     {
-        auto it = m_index.get<ByPeer>().find(ByPeerView{peer, true, txhash});
-        if (it == m_index.get<ByPeer>().end()) {
+        auto txit = m_txhashes.find(txhash);
+        if (txit == m_txhashes.end()) return;
+        const AnnIndex idx = FindByPeer(txit->second, peer);
+        if (idx == NO_ANNOUNCEMENT) return;
+
+        const State state = m_announcements[idx].GetState();
+        if (state != State::CANDIDATE_BEST) {
             // There is no CANDIDATE_BEST announcement, look for a _READY or _DELAYED instead. If the caller only
             // ever invokes RequestedTx with the values returned by GetRequestable, and no other non-const functions
             // other than ForgetTxHash and GetRequestable in between, this branch will never execute (as txhashes
             // returned by GetRequestable always correspond to CANDIDATE_BEST announcements).
-
-            it = m_index.get<ByPeer>().find(ByPeerView{peer, false, txhash});
-            if (it == m_index.get<ByPeer>().end() || (it->GetState() != State::CANDIDATE_DELAYED &&
-                                                      it->GetState() != State::CANDIDATE_READY)) {
+            if (state != State::CANDIDATE_DELAYED && state != State::CANDIDATE_READY) {
                 // There is no CANDIDATE announcement tracked for this peer, so we have nothing to do. Either this
-                // txhash wasn't tracked at all (and the caller should have called ReceivedInv), or it was already
-                // requested and/or completed for other reasons and this is just a superfluous RequestedTx call.
+                // txhash was already requested and/or completed for other reasons and this is just a superfluous
+                // RequestedTx call.
                 return;
             }
 
             // Look for an existing CANDIDATE_BEST or REQUESTED with the same txhash. We only need to do this if the
             // found announcement had a different state than CANDIDATE_BEST. If it did, invariants guarantee that no
             // other CANDIDATE_BEST or REQUESTED can exist.
-            auto it_old = m_index.get<ByTxHash>().lower_bound(ByTxHashView{txhash, State::CANDIDATE_BEST, 0});
-            if (it_old != m_index.get<ByTxHash>().end() && it_old->m_txhash == txhash) {
-                if (it_old->GetState() == State::CANDIDATE_BEST) {
+            const AnnIndex old = FindSelected(txit->second);
+            if (old != NO_ANNOUNCEMENT) {
+                if (m_announcements[old].GetState() == State::CANDIDATE_BEST) {
                     // The data structure's invariants require that there can be at most one CANDIDATE_BEST or one
                     // REQUESTED announcement per txhash (but not both simultaneously), so we have to convert any
                     // existing CANDIDATE_BEST to another CANDIDATE_* when constructing another REQUESTED.
                     // It doesn't matter whether we pick CANDIDATE_READY or _DELAYED here, as SetTimePoint()
                     // will correct it at GetRequestable() time. If time only goes forward, it will always be
                     // _READY, so pick that to avoid extra work in SetTimePoint().
-                    Modify<ByTxHash>(it_old, [](Announcement& ann) { ann.SetState(State::CANDIDATE_READY); });
-                } else if (it_old->GetState() == State::REQUESTED) {
+                    SetState(old, State::CANDIDATE_READY);
+                } else {
                     // As we're no longer waiting for a response to the previous REQUESTED announcement, convert it
                     // to COMPLETED. This also helps guaranteeing progress.
-                    Modify<ByTxHash>(it_old, [](Announcement& ann) { ann.SetState(State::COMPLETED); });
+                    SetState(old, State::COMPLETED);
                 }
             }
         }
 
-        Modify<ByPeer>(it, [expiry](Announcement& ann) {
-            ann.SetState(State::REQUESTED);
-            ann.m_time = expiry;
-        });
+        m_announcements[idx].m_time = expiry;
+        SetState(idx, State::REQUESTED);
     }
 
     void ReceivedResponse(NodeId peer, const uint256& txhash)
     {
-        // We need to search the ByPeer index for both (peer, false, txhash) and (peer, true, txhash).
-        auto it = m_index.get<ByPeer>().find(ByPeerView{peer, false, txhash});
-        if (it == m_index.get<ByPeer>().end()) {
-            it = m_index.get<ByPeer>().find(ByPeerView{peer, true, txhash});
-        }
-        if (it != m_index.get<ByPeer>().end()) MakeCompleted(m_index.project<ByTxHash>(it));
+        auto txit = m_txhashes.find(txhash);
+        if (txit == m_txhashes.end()) return;
+        const AnnIndex idx = FindByPeer(txit->second, peer);
+        if (idx != NO_ANNOUNCEMENT) MakeCompleted(idx, txit);
     }
 
     size_t CountInFlight(NodeId peer) const
@@ -709,7 +772,7 @@ public:
     }
 
     //! Count how many announcements are being tracked in total across all peers and transactions.
-    size_t Size() const { return m_index.size(); }
+    size_t Size() const { return m_announcements.size() - m_free_slots.size(); }
 
     uint64_t ComputePriority(const uint256& txhash, NodeId peer, bool preferred) const
     {
@@ -453,6 +453,31 @@ void univalue_readwrite()
     BOOST_CHECK(!v.read("[]{}"));
     BOOST_CHECK(!v.read("{}[]"));
     BOOST_CHECK(!v.read("{} 42"));
+
+    // Strings longer than the parser reads at once, with escapes and
+    // multi-byte characters at all positions
+    for (size_t pos = 0; pos < 20; pos++) {
+        const std::string head(pos, 'a'), tail(19 - pos, 'b');
+        BOOST_CHECK(v.read("\"" + head + "\\n" + tail + "\""));
+        BOOST_CHECK_EQUAL(v.get_str(), head + "\n" + tail);
+        BOOST_CHECK_EQUAL(v.write(), "\"" + head + "\\n" + tail + "\"");
+        BOOST_CHECK(v.read("\"" + head + "\xc3\xa9" + tail + "\""));
+        BOOST_CHECK_EQUAL(v.get_str(), head + "\xc3\xa9" + tail);
+        BOOST_CHECK_EQUAL(v.write(), "\"" + head + "\xc3\xa9" + tail + "\"");
+        BOOST_CHECK(v.read("[\"" + head + "\\\"\",\"" + tail + "\"]"));
+        BOOST_CHECK_EQUAL(v[0].get_str(), head + "\"");
+        BOOST_CHECK_EQUAL(v[1].get_str(), tail);
+        // Control characters must be escaped
+        BOOST_CHECK(!v.read("\"" + head + "\t" + tail + "\""));
+        // ASCII is not a continuation of a UTF-8 sequence
+        BOOST_CHECK(!v.read("\"" + head + "\xc3" + tail + "\""));
+        // Unterminated
+        BOOST_CHECK(!v.read("\"" + head + tail));
+    }
+    BOOST_CHECK(v.read("[-12.5e+3, 0, 12345678901234567890]"));
+    BOOST_CHECK_EQUAL(v[0].getValStr(), "-12.5e+3");
+    BOOST_CHECK_EQUAL(v[1].getValStr(), "0");
+    BOOST_CHECK_EQUAL(v[2].getValStr(), "12345678901234567890");
 }
 
 int main(int argc, char* argv[])
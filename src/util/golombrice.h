@@ -5,11 +5,17 @@
 #ifndef BITCOIN_UTIL_GOLOMBRICE_H
 #define BITCOIN_UTIL_GOLOMBRICE_H
 
+#include <crypto/common.h>
 #include <util/fastrange.h>
 
 #include <streams.h>
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <ios>
+#include <span>
 
 template <typename OStream>
 void GolombRiceEncode(BitStreamWriter<OStream>& bitwriter, uint8_t P, uint64_t x)
@@ -42,4 +48,95 @@ uint64_t GolombRiceDecode(BitStreamReader<IStream>& bitreader, uint8_t P)
     return (q << P) + r;
 }
 
+/**
+ * Decodes a sequence of Golomb-Rice codes from a byte span, a 64-bit word at a
+ * time rather than bit by bit: the unary quotient is found with a single
+ * count of leading ones and the remainder with a single shift.
+ *
+ * Returns the same values as repeated GolombRiceDecode() calls on a
+ * BitStreamReader over the same bytes, and likewise throws
+ * std::ios_base::failure when the data runs out.
+ */
+class GolombRiceReader
+{
+private:
+    std::span<const unsigned char> m_data;
+
+    /// Number of bytes of m_data loaded into m_buffer so far.
+    size_t m_pos{0};
+
+    /// The next bits of the stream, starting at the most significant bit.
+    /// Only the first m_bits are counted as loaded; the bits after them are
+    /// either zero or the (not yet counted) bits that follow in the stream.
+    uint64_t m_buffer{0};
+
+    /// Number of valid bits at the top of m_buffer.
+    int m_bits{0};
+
+    void Refill()
+    {
+        if (m_data.size() - m_pos >= 8) {
+            // Load a whole word and count as many whole bytes of it as fit.
+            // The rest overlaps bits already present or is loaded again next
+            // time, which is harmless as they are the same bits.
+            m_buffer |= ReadBE64(m_data.data() + m_pos) >> m_bits;
+            const int bytes{(63 - m_bits) >> 3};
+            m_pos += bytes;
+            m_bits += bytes * 8;
+        } else {
+            while (m_bits <= 56 && m_pos < m_data.size()) {
+                m_buffer |= uint64_t{m_data[m_pos++]} << (56 - m_bits);
+                m_bits += 8;
+            }
+        }
+    }
+
+    void Consume(int nbits)
+    {
+        m_buffer = nbits < 64 ? m_buffer << nbits : 0;
+        m_bits -= nbits;
+    }
+
+public:
+    explicit GolombRiceReader(std::span<const unsigned char> data) : m_data{data} {}
+
+    /** Read the specified number of bits, returned in the least significant bits. */
+    uint64_t Read(int nbits)
+    {
+        uint64_t data{0};
+        while (nbits > 0) {
+            Refill();
+            if (m_bits == 0) throw std::ios_base::failure("GolombRiceReader: end of data");
+            const int bits{std::min({nbits, m_bits, 32})};
+            data = (data << bits) | (m_buffer >> (64 - bits));
+            Consume(bits);
+            nbits -= bits;
+        }
+        return data;
+    }
+
+    /** Decode the next value, encoded with parameter P. */
+    uint64_t Decode(uint8_t P)
+    {
+        // Read unary-encoded quotient: q 1's followed by one 0.
+        uint64_t q{0};
+        while (true) {
+            Refill();
+            const int ones{std::countl_one(m_buffer)};
+            if (ones < m_bits) {
+                q += ones;
+                Consume(ones + 1);
+                break;
+            }
+            if (m_bits == 0) throw std::ios_base::failure("GolombRiceReader: end of data");
+            q += m_bits;
+            Consume(m_bits);
+        }
+        return (q << P) + Read(P);
+    }
+
+    /** Number of bytes the values decoded so far were read from, counting a partially used last byte. */
+    size_t GetBytesRead() const { return m_pos - m_bits / 8; }
+};
+
 #endif // BITCOIN_UTIL_GOLOMBRICE_H
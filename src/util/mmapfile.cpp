@@ -0,0 +1,76 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/mmapfile.h>
+
+#include <utility>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)}
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        Close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+#ifndef WIN32
+bool MappedFile::Open(const fs::path& path)
+{
+    // Large files cannot be mapped in a 32-bit address space.
+    if constexpr (sizeof(void*) < 8) return false;
+
+    const int fd{::open(fs::PathToString(path).c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd == -1) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    const size_t size{static_cast<size_t>(st.st_size)};
+    void* data{nullptr};
+    if (size > 0) {
+        data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+    if (data == MAP_FAILED) return false;
+
+    Close();
+    m_data = static_cast<const std::byte*>(data);
+    m_size = size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) ::munmap(const_cast<std::byte*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+#else
+bool MappedFile::Open(const fs::path& path)
+{
+    return false;
+}
+
+void MappedFile::Close()
+{
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif // WIN32
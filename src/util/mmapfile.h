@@ -0,0 +1,47 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_MMAPFILE_H
+#define BITCOIN_UTIL_MMAPFILE_H
+
+#include <util/fs.h>
+
+#include <cstddef>
+#include <span>
+
+/**
+ * A read-only memory mapping of a whole file, as it was when it was opened.
+ *
+ * Writes to the file through other handles are visible in the mapping, but
+ * growth is not: call Open() again to map the new size. Accessing the mapping
+ * beyond the current end of a file that was truncated after it was mapped
+ * crashes the process, so callers must re-map files they truncate.
+ *
+ * Mapping is only supported on 64-bit non-Windows systems. Elsewhere Open()
+ * always fails and callers are expected to fall back to reading the file.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /** Map the file at path, replacing any previous mapping. Returns false, keeping the previous mapping, on failure. */
+    bool Open(const fs::path& path);
+
+    void Close();
+
+    std::span<const std::byte> Data() const { return {m_data, m_size}; }
+
+private:
+    const std::byte* m_data{nullptr};
+    size_t m_size{0};
+};
+
+#endif // BITCOIN_UTIL_MMAPFILE_H
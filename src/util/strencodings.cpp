@@ -49,21 +49,21 @@ bool IsHex(std::string_view str)
 template <typename Byte>
 std::optional<std::vector<Byte>> TryParseHex(std::string_view str)
 {
-    std::vector<Byte> vch;
-    vch.reserve(str.size() / 2); // two hex characters form a single byte
+    std::vector<Byte> vch(str.size() / 2); // two hex characters form a single byte
+    size_t size{0};
 
-    auto it = str.begin();
-    while (it != str.end()) {
-        if (IsSpace(*it)) {
-            ++it;
+    while (!str.empty()) {
+        if (IsSpace(str.front())) {
+            str.remove_prefix(1);
             continue;
         }
-        auto c1 = HexDigit(*(it++));
-        if (it == str.end()) return std::nullopt;
-        auto c2 = HexDigit(*(it++));
-        if (c1 < 0 || c2 < 0) return std::nullopt;
-        vch.push_back(Byte(c1 << 4) | Byte(c2));
+        // Decode the whole run of hex digits up to the next space at once.
+        const size_t decoded{HexDecode(str, std::span{reinterpret_cast<uint8_t*>(vch.data()) + size, vch.size() - size})};
+        if (decoded == 0) return std::nullopt;
+        size += decoded;
+        str.remove_prefix(2 * decoded);
     }
+    vch.resize(size);
     return vch;
 }
 template std::optional<std::vector<std::byte>> TryParseHex(std::string_view);
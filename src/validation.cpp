@@ -44,6 +44,7 @@
 #include <script/script.h>
 #include <script/sigcache.h>
 #include <signet.h>
+#include <streams.h>
 #include <tinyformat.h>
 #include <txdb.h>
 #include <txmempool.h>
@@ -59,6 +60,7 @@
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/thread.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
@@ -67,12 +69,15 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <memory>
 #include <numeric>
 #include <optional>
 #include <ranges>
 #include <span>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 
@@ -632,6 +637,16 @@ public:
      */
     PackageMempoolAcceptResult AcceptPackage(const Package& package, ATMPArgs& args) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /**
+     * Run the policy checks of a single transaction except for its scripts (see PreChecks()) and, if
+     * they pass, initialize txdata with the outputs it spends, so that its scripts can be verified
+     * later without holding cs_main.
+     *
+     * @param[out] sigop_cost  The sigop cost of the transaction, set if the checks pass.
+     */
+    bool PrepareScriptChecks(const CTransactionRef& ptx, ATMPArgs& args, PrecomputedTransactionData& txdata, int64_t& sigop_cost)
+        EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
 private:
     // All the intermediate state that gets passed between the various levels
     // of checking a given transaction.
@@ -1877,6 +1892,26 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptPackage(const Package& package,
     return PackageMempoolAcceptResult(package_state_final, std::move(results_final));
 }
 
+bool MemPoolAccept::PrepareScriptChecks(const CTransactionRef& ptx, ATMPArgs& args, PrecomputedTransactionData& txdata, int64_t& sigop_cost)
+{
+    AssertLockHeld(cs_main);
+    LOCK(m_pool.cs);
+
+    Workspace ws(ptx);
+    const bool passed{PreChecks(args, ws)};
+    if (passed) {
+        std::vector<CTxOut> spent_outputs;
+        spent_outputs.reserve(ptx->vin.size());
+        for (const CTxIn& txin : ptx->vin) {
+            spent_outputs.push_back(m_view.AccessCoin(txin.prevout).out);
+        }
+        txdata.Init(*ptx, std::move(spent_outputs));
+        sigop_cost = ws.m_tx_handle->GetSigOpCost();
+    }
+    ClearSubPackageState();
+    return passed;
+}
+
 } // namespace
 
 MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTransactionRef& tx,
@@ -2611,7 +2646,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     // doesn't invalidate pointers into the vector, and keep txsdata in scope
     // for as long as `control`.
     std::optional<CCheckQueueControl<CScriptCheck>> control;
-    if (auto& queue = m_chainman.GetCheckQueue(); queue.HasThreads() && fScriptChecks) control.emplace(queue);
+    if (auto& queue = m_chainman.GetCheckQueue(*this); queue.HasThreads() && fScriptChecks) control.emplace(queue);
 
     std::vector<PrecomputedTransactionData> txsdata(block.vtx.size());
 
@@ -4577,7 +4612,14 @@ bool ChainstateManager::ProcessNewBlock(const std::shared_ptr<const CBlock>& blo
         return false;
     }
 
-    Chainstate* bg_chain{WITH_LOCK(cs_main, return BackgroundSyncInProgress() ? m_ibd_chainstate.get() : nullptr)};
+    Chainstate* bg_chain{nullptr};
+    {
+        LOCK(cs_main);
+        if (BackgroundSyncInProgress() && !m_background_validation_paused) {
+            bg_chain = m_ibd_chainstate.get();
+            if (!m_background_sync_start) m_background_sync_start.emplace(SteadyClock::now(), bg_chain->m_chain.Tip());
+        }
+    }
     BlockValidationState bg_state;
     if (bg_chain && !bg_chain->ActivateBestChain(bg_state, block)) {
         LogError("%s: [background] ActivateBestChain failed (%s)\n", __func__, bg_state.ToString());
@@ -4601,6 +4643,56 @@ MempoolAcceptResult ChainstateManager::ProcessTransaction(const CTransactionRef&
     return result;
 }
 
+void ChainstateManager::PrecheckTransactionScripts(const std::vector<CTransactionRef>& txs)
+{
+    if (txs.empty() || !GetCheckQueue().HasThreads()) return;
+
+    // The checks refer to the precomputed data by pointer, so size the vector up front and keep it in
+    // scope for as long as the checks.
+    std::vector<PrecomputedTransactionData> txsdata(txs.size());
+    std::vector<CScriptCheck> checks;
+    {
+        LOCK(cs_main);
+        Chainstate& active_chainstate = ActiveChainstate();
+        CTxMemPool* pool{active_chainstate.GetMempool()};
+        if (!pool) return;
+
+        // Run the same policy checks as ProcessTransaction, so that no scripts are verified for
+        // transactions that would be rejected without them, e.g. for being non-standard or paying too
+        // little fee. Transactions that still miss inputs are prechecked again once their parents arrive.
+        MemPoolAccept accept{*pool, active_chainstate};
+        std::vector<COutPoint> coins_to_uncache;
+        int64_t total_sigop_cost{0};
+        for (size_t i = 0; i < txs.size(); ++i) {
+            auto args{MemPoolAccept::ATMPArgs::SingleAccept(GetParams(), GetTime(), /*bypass_limits=*/false, coins_to_uncache, /*test_accept=*/true)};
+            int64_t sigop_cost;
+            if (!accept.PrepareScriptChecks(txs[i], args, txsdata[i], sigop_cost)) continue;
+            if (total_sigop_cost + sigop_cost > MAX_PRECHECK_SIGOPS_COST) break;
+            total_sigop_cost += sigop_cost;
+
+            const CTransaction& tx = *txs[i];
+            for (unsigned int n = 0; n < tx.vin.size(); ++n) {
+                checks.emplace_back(txsdata[i].m_spent_outputs[n], tx, m_validation_cache.m_signature_cache, n,
+                                    STANDARD_SCRIPT_VERIFY_FLAGS, /*cacheIn=*/true, &txsdata[i]);
+            }
+        }
+        // ProcessTransaction looks the coins up again when the transactions' turn comes.
+        for (const COutPoint& outpoint : coins_to_uncache) {
+            active_chainstate.CoinsTip().Uncache(outpoint);
+        }
+    }
+    if (checks.empty()) return;
+
+    // Connecting a block waits for the script check queue while this batch is verified, which the
+    // sigop cost limit above keeps short.
+    CCheckQueueControl<CScriptCheck> control(GetCheckQueue());
+    control.Add(std::move(checks));
+    // Only signatures that verify are added to the signature cache, and the actual validation of these
+    // transactions happens in ProcessTransaction, so the result is not needed. A failure stops the
+    // remaining checks early, which only means fewer signatures are cached.
+    control.Complete();
+}
+
 
 BlockValidationState TestBlockValidity(
     Chainstate& chainstate,
@@ -5891,6 +5983,190 @@ static void SnapshotUTXOHashBreakpoint(const util::SignalInterrupt& interrupt)
     if (interrupt) throw StopHashingException();
 }
 
+/**
+ * Load the coins of a chunked snapshot straight into the coins database.
+ * Chunks are read here, in order, and verified, deserialized and written on
+ * num_threads threads, at most two per thread ahead of the oldest one not
+ * done yet.
+ *
+ * @returns the CoinStatsHashType::HASH_SERIALIZED hash of the coins, with
+ *          the transactions in the order they appear in the file. It only
+ *          matches the hash of the coins database if they are in database
+ *          order, as written by dumptxoutset.
+ */
+static util::Result<uint256> LoadSnapshotChunks(
+    AutoFile& coins_file,
+    const SnapshotMetadata& metadata,
+    int base_height,
+    CCoinsViewDB& coins_db,
+    int num_threads,
+    const util::SignalInterrupt& interrupt)
+{
+    struct Chunk {
+        uint32_t index{0};
+        node::SnapshotChunkHeader header;
+        std::vector<std::byte> data;
+        //! The data hashed for the coins of this chunk.
+        DataStream hash_data;
+        std::optional<std::string> error;
+        bool done{false};
+    };
+
+    const auto process_chunk{[&](Chunk& chunk) {
+        if (Hash(chunk.data) != chunk.header.hash) {
+            chunk.error = strprintf("Bad snapshot - checksum mismatch in chunk %d", chunk.index);
+            return;
+        }
+        std::vector<std::pair<COutPoint, Coin>> coins;
+        coins.reserve(std::min<uint64_t>(chunk.header.coins_count, chunk.data.size()));
+        try {
+            SpanReader reader{chunk.data};
+            while (!reader.empty()) {
+                Txid txid;
+                reader >> txid;
+                const size_t coins_per_txid{ReadCompactSize(reader)};
+                if (coins_per_txid > chunk.header.coins_count - coins.size()) {
+                    chunk.error = strprintf("Mismatch in coins count in chunk %d", chunk.index);
+                    return;
+                }
+                const size_t txid_begin{coins.size()};
+                for (size_t i = 0; i < coins_per_txid; ++i) {
+                    COutPoint outpoint{txid, static_cast<uint32_t>(ReadCompactSize(reader))};
+                    Coin coin;
+                    reader >> coin;
+                    if (coin.nHeight > base_height ||
+                        outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() || // Avoid integer wrap-around in coinstats.cpp:ApplyHash
+                        !MoneyRange(coin.out.nValue)) {
+                        chunk.error = strprintf("Bad snapshot data in chunk %d", chunk.index);
+                        return;
+                    }
+                    coins.emplace_back(outpoint, std::move(coin));
+                }
+                kernel::ApplyTxCoinsHash(chunk.hash_data, std::span{coins}.subspan(txid_begin));
+            }
+        } catch (const std::ios_base::failure&) {
+            chunk.error = strprintf("Bad snapshot format in chunk %d", chunk.index);
+            return;
+        }
+        if (coins.size() != chunk.header.coins_count) {
+            chunk.error = strprintf("Mismatch in coins count in chunk %d", chunk.index);
+            return;
+        }
+        if (!coins_db.WriteCoins(coins)) {
+            chunk.error = "Failed to write coins to the database";
+        }
+    }};
+
+    Mutex mutex;
+    std::condition_variable cv;
+    //! Chunks read but not yet picked up by a thread.
+    std::deque<std::shared_ptr<Chunk>> queued;
+    //! Chunks read but not yet hashed, in file order.
+    std::deque<std::shared_ptr<Chunk>> pending;
+    bool stop{false};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < std::max(num_threads, 1); ++i) {
+        threads.emplace_back(&util::TraceThread, strprintf("loadutxo.%d", i), [&] {
+            WAIT_LOCK(mutex, lock);
+            while (true) {
+                cv.wait(lock, [&] { return stop || !queued.empty(); });
+                if (stop) return;
+                const std::shared_ptr<Chunk> chunk{queued.front()};
+                queued.pop_front();
+                {
+                    REVERSE_LOCK(lock, mutex);
+                    try {
+                        process_chunk(*chunk);
+                    } catch (const std::exception& e) {
+                        chunk->error = strprintf("Failed to load chunk %d: %s", chunk->index, e.what());
+                    }
+                }
+                chunk->done = true;
+                cv.notify_all();
+            }
+        });
+    }
+
+    const size_t window{threads.size() * 2};
+    HashWriter ss{};
+    uint64_t coins_left{metadata.m_coins_count};
+    uint64_t coins_processed{0};
+    uint32_t next_chunk{0};
+    std::optional<std::string> error;
+    while (!error) {
+        if (interrupt) {
+            error = "Aborting after an interrupt was requested";
+            break;
+        }
+        std::shared_ptr<Chunk> done;
+        {
+            WAIT_LOCK(mutex, lock);
+            if (!pending.empty() && pending.front()->done) {
+                done = pending.front();
+                pending.pop_front();
+            } else if (next_chunk == metadata.m_chunk_count && pending.empty()) {
+                break;
+            } else if (next_chunk == metadata.m_chunk_count || pending.size() >= window) {
+                cv.wait_for(lock, std::chrono::milliseconds{100});
+                continue;
+            }
+        }
+        if (done) {
+            // Hash the chunks in file order.
+            if (done->error) {
+                error = *done->error;
+                break;
+            }
+            ss.write(std::span<const std::byte>{done->hash_data.data(), done->hash_data.size()});
+            if ((coins_processed + done->header.coins_count) / 1000000 > coins_processed / 1000000) {
+                LogPrintf("[snapshot] %d coins loaded (%.2f%%)\n",
+                          coins_processed + done->header.coins_count,
+                          static_cast<float>(coins_processed + done->header.coins_count) * 100 / static_cast<float>(metadata.m_coins_count));
+            }
+            coins_processed += done->header.coins_count;
+            continue;
+        }
+
+        auto chunk{std::make_shared<Chunk>()};
+        chunk->index = next_chunk++;
+        try {
+            coins_file >> chunk->header;
+            if (chunk->header.coins_count > coins_left) {
+                error = "Mismatch in coins count in snapshot metadata and actual snapshot data";
+                break;
+            }
+            if (chunk->header.size > MAX_SNAPSHOT_CHUNK_SIZE) {
+                error = strprintf("Bad snapshot - chunk %d is too large", chunk->index);
+                break;
+            }
+            chunk->data.resize(chunk->header.size);
+            coins_file.read(chunk->data);
+        } catch (const std::ios_base::failure&) {
+            error = strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins",
+                              metadata.m_coins_count - coins_left);
+            break;
+        }
+        coins_left -= chunk->header.coins_count;
+        {
+            LOCK(mutex);
+            queued.push_back(chunk);
+            pending.push_back(chunk);
+        }
+        cv.notify_all();
+    }
+
+    WITH_LOCK(mutex, stop = true);
+    cv.notify_all();
+    for (std::thread& thread : threads) thread.join();
+
+    if (error) return util::Error{Untranslated(*error)};
+    if (coins_left > 0) {
+        return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
+    }
+    return ss.GetHash();
+}
+
 util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     Chainstate& snapshot_chainstate,
     AutoFile& coins_file,
@@ -5932,74 +6208,85 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     const uint64_t coins_count = metadata.m_coins_count;
     uint64_t coins_left = metadata.m_coins_count;
 
-    LogPrintf("[snapshot] loading %d coins from snapshot %s\n", coins_left, base_blockhash.ToString());
-    int64_t coins_processed{0};
-
-    while (coins_left > 0) {
-        try {
-            Txid txid;
-            coins_file >> txid;
-            size_t coins_per_txid{0};
-            coins_per_txid = ReadCompactSize(coins_file);
+    uint256 hash_serialized;
+    if (metadata.IsChunked()) {
+        LogPrintf("[snapshot] loading %d coins in %d chunks from snapshot %s\n", coins_left, metadata.m_chunk_count, base_blockhash.ToString());
+        CCoinsViewDB& coins_db = *WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
+        // Bypass the coins cache and write chunks straight to the database
+        // on as many threads as scripts are verified on.
+        auto res{LoadSnapshotChunks(coins_file, metadata, base_height, coins_db, m_options.worker_threads_num + 1, m_interrupt)};
+        if (!res) return util::Error{util::ErrorString(res)};
+        hash_serialized = *res;
+    } else {
+        LogPrintf("[snapshot] loading %d coins from snapshot %s\n", coins_left, base_blockhash.ToString());
+        int64_t coins_processed{0};
 
-            if (coins_per_txid > coins_left) {
-                return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
-            }
+        while (coins_left > 0) {
+            try {
+                Txid txid;
+                coins_file >> txid;
+                size_t coins_per_txid{0};
+                coins_per_txid = ReadCompactSize(coins_file);
 
-            for (size_t i = 0; i < coins_per_txid; i++) {
-                COutPoint outpoint;
-                Coin coin;
-                outpoint.n = static_cast<uint32_t>(ReadCompactSize(coins_file));
-                outpoint.hash = txid;
-                coins_file >> coin;
-                if (coin.nHeight > base_height ||
-                    outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
-                ) {
-                    return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins",
-                                                              coins_count - coins_left))};
+                if (coins_per_txid > coins_left) {
+                    return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
                 }
-                if (!MoneyRange(coin.out.nValue)) {
-                    return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins - bad tx out value",
-                                                              coins_count - coins_left))};
-                }
-                coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
 
-                --coins_left;
-                ++coins_processed;
+                for (size_t i = 0; i < coins_per_txid; i++) {
+                    COutPoint outpoint;
+                    Coin coin;
+                    outpoint.n = static_cast<uint32_t>(ReadCompactSize(coins_file));
+                    outpoint.hash = txid;
+                    coins_file >> coin;
+                    if (coin.nHeight > base_height ||
+                        outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
+                    ) {
+                        return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins",
+                                                                  coins_count - coins_left))};
+                    }
+                    if (!MoneyRange(coin.out.nValue)) {
+                        return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins - bad tx out value",
+                                                                  coins_count - coins_left))};
+                    }
+                    coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
 
-                if (coins_processed % 1000000 == 0) {
-                    LogPrintf("[snapshot] %d coins loaded (%.2f%%, %.2f MB)\n",
-                              coins_processed,
-                              static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count),
-                              coins_cache.DynamicMemoryUsage() / (1000 * 1000));
-                }
+                    --coins_left;
+                    ++coins_processed;
 
-                // Batch write and flush (if we need to) every so often.
-                //
-                // If our average Coin size is roughly 41 bytes, checking every 120,000 coins
-                // means <5MB of memory imprecision.
-                if (coins_processed % 120000 == 0) {
-                    if (m_interrupt) {
-                        return util::Error{Untranslated("Aborting after an interrupt was requested")};
+                    if (coins_processed % 1000000 == 0) {
+                        LogPrintf("[snapshot] %d coins loaded (%.2f%%, %.2f MB)\n",
+                                  coins_processed,
+                                  static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count),
+                                  coins_cache.DynamicMemoryUsage() / (1000 * 1000));
                     }
 
-                    const auto snapshot_cache_state = WITH_LOCK(::cs_main,
-                                                                return snapshot_chainstate.GetCoinsCacheSizeState());
+                    // Batch write and flush (if we need to) every so often.
+                    //
+                    // If our average Coin size is roughly 41 bytes, checking every 120,000 coins
+                    // means <5MB of memory imprecision.
+                    if (coins_processed % 120000 == 0) {
+                        if (m_interrupt) {
+                            return util::Error{Untranslated("Aborting after an interrupt was requested")};
+                        }
 
-                    if (snapshot_cache_state >= CoinsCacheSizeState::CRITICAL) {
-                        // This is a hack - we don't know what the actual best block is, but that
-                        // doesn't matter for the purposes of flushing the cache here. We'll set this
-                        // to its correct value (`base_blockhash`) below after the coins are loaded.
-                        coins_cache.SetBestBlock(GetRandHash());
+                        const auto snapshot_cache_state = WITH_LOCK(::cs_main,
+                                                                    return snapshot_chainstate.GetCoinsCacheSizeState());
 
-                        // No need to acquire cs_main since this chainstate isn't being used yet.
-                        FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/false);
+                        if (snapshot_cache_state >= CoinsCacheSizeState::CRITICAL) {
+                            // This is a hack - we don't know what the actual best block is, but that
+                            // doesn't matter for the purposes of flushing the cache here. We'll set this
+                            // to its correct value (`base_blockhash`) below after the coins are loaded.
+                            coins_cache.SetBestBlock(GetRandHash());
+
+                            // No need to acquire cs_main since this chainstate isn't being used yet.
+                            FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/false);
+                        }
                     }
                 }
+            } catch (const std::ios_base::failure&) {
+                return util::Error{Untranslated(strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins",
+                                                          coins_processed))};
             }
-        } catch (const std::ios_base::failure&) {
-            return util::Error{Untranslated(strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins",
-                                                      coins_processed))};
         }
     }
 
@@ -6037,22 +6324,28 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     // about the snapshot_chainstate.
     CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
 
-    std::optional<CCoinsStats> maybe_stats;
+    // Chunked snapshots are hashed while they are loaded.
+    if (!metadata.IsChunked()) {
+        std::optional<CCoinsStats> maybe_stats;
 
-    try {
-        maybe_stats = ComputeUTXOStats(
-            CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
-    } catch (StopHashingException const&) {
-        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-    }
-    if (!maybe_stats.has_value()) {
-        return util::Error{Untranslated("Failed to generate coins stats")};
+        try {
+            // Hash the snapshot on as many threads as scripts are verified on.
+            maybe_stats = ComputeUTXOStats(
+                CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); },
+                /*num_threads=*/m_options.worker_threads_num + 1);
+        } catch (StopHashingException const&) {
+            return util::Error{Untranslated("Aborting after an interrupt was requested")};
+        }
+        if (!maybe_stats.has_value()) {
+            return util::Error{Untranslated("Failed to generate coins stats")};
+        }
+        hash_serialized = maybe_stats->hashSerialized;
     }
 
     // Assert that the deserialized chainstate contents match the expected assumeutxo value.
-    if (AssumeutxoHash{maybe_stats->hashSerialized} != au_data.hash_serialized) {
+    if (AssumeutxoHash{hash_serialized} != au_data.hash_serialized) {
         return util::Error{Untranslated(strprintf("Bad snapshot content hash: expected %s, got %s",
-                                                  au_data.hash_serialized.ToString(), maybe_stats->hashSerialized.ToString()))};
+                                                  au_data.hash_serialized.ToString(), hash_serialized.ToString()))};
     }
 
     snapshot_chainstate.m_chain.SetTip(*snapshot_start_block);
@@ -6201,7 +6494,8 @@ SnapshotCompletionResult ChainstateManager::MaybeCompleteSnapshotValidation()
             CoinStatsHashType::HASH_SERIALIZED,
             &ibd_coins_db,
             m_blockman,
-            [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
+            [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); },
+            /*num_threads=*/m_options.worker_threads_num + 1);
     } catch (StopHashingException const&) {
         return SnapshotCompletionResult::STATS_FAILED;
     }
@@ -6279,12 +6573,95 @@ void ChainstateManager::MaybeRebalanceCaches()
             m_snapshot_chainstate->ResizeCoinsCaches(
                 m_total_coinstip_cache * 0.95, m_total_coinsdb_cache * 0.95);
         } else {
-            m_snapshot_chainstate->ResizeCoinsCaches(
-                m_total_coinstip_cache * 0.05, m_total_coinsdb_cache * 0.05);
-            m_ibd_chainstate->ResizeCoinsCaches(
-                m_total_coinstip_cache * 0.95, m_total_coinsdb_cache * 0.95);
+            // A paused background chainstate gets the share it has while the snapshot
+            // chainstate is in IBD, so that its cache is flushed and the memory goes to
+            // the tip.
+            const double background{(m_background_validation_paused ? 5 : m_background_cache_percent) / 100.0};
+            if (background >= 0.5) {
+                m_snapshot_chainstate->ResizeCoinsCaches(
+                    m_total_coinstip_cache * (1 - background), m_total_coinsdb_cache * (1 - background));
+                m_ibd_chainstate->ResizeCoinsCaches(
+                    m_total_coinstip_cache * background, m_total_coinsdb_cache * background);
+            } else {
+                m_ibd_chainstate->ResizeCoinsCaches(
+                    m_total_coinstip_cache * background, m_total_coinsdb_cache * background);
+                m_snapshot_chainstate->ResizeCoinsCaches(
+                    m_total_coinstip_cache * (1 - background), m_total_coinsdb_cache * (1 - background));
+            }
+        }
+    }
+}
+
+CCheckQueue<CScriptCheck>& ChainstateManager::GetCheckQueue(const Chainstate& chainstate)
+{
+    AssertLockHeld(::cs_main);
+    if (m_background_script_check_queue && &chainstate == m_ibd_chainstate.get() && BackgroundSyncInProgress()) {
+        return *m_background_script_check_queue;
+    }
+    return m_script_check_queue;
+}
+
+bool ChainstateManager::SetBackgroundSyncPaused(bool paused)
+{
+    AssertLockNotHeld(::cs_main);
+    Chainstate* bg_chain{nullptr};
+    {
+        LOCK(::cs_main);
+        if (m_background_validation_paused.exchange(paused) == paused) return true;
+        LogPrintf("[snapshot] background validation %s\n", paused ? "paused" : "resumed");
+        m_background_sync_start.reset();
+        if (!BackgroundSyncInProgress()) return true;
+        MaybeRebalanceCaches();
+        if (!paused) bg_chain = m_ibd_chainstate.get();
+    }
+    if (!bg_chain) return true;
+
+    // Connect the blocks that were received while paused; further blocks are
+    // connected as they arrive.
+    WITH_LOCK(::cs_main, m_background_sync_start.emplace(SteadyClock::now(), bg_chain->m_chain.Tip()));
+    BlockValidationState state;
+    if (!bg_chain->ActivateBestChain(state, nullptr)) {
+        LogError("%s: [background] ActivateBestChain failed (%s)\n", __func__, state.ToString());
+        return false;
+    }
+    return true;
+}
+
+void ChainstateManager::SetBackgroundCachePercent(int percent)
+{
+    AssertLockHeld(::cs_main);
+    m_background_cache_percent = std::clamp(percent, 1, 99);
+    if (IsUsable(m_ibd_chainstate.get()) && IsUsable(m_snapshot_chainstate.get())) MaybeRebalanceCaches();
+}
+
+std::optional<ChainstateManager::BackgroundSyncInfo> ChainstateManager::GetBackgroundSyncInfo() const
+{
+    AssertLockHeld(::cs_main);
+    if (!BackgroundSyncInProgress()) return std::nullopt;
+    const CBlockIndex* tip{m_ibd_chainstate->m_chain.Tip()};
+    const CBlockIndex& base{*Assert(GetSnapshotBaseBlock())};
+
+    BackgroundSyncInfo info;
+    info.paused = m_background_validation_paused;
+    info.script_threads = (m_background_script_check_queue ? *m_background_script_check_queue : m_script_check_queue).NumThreads();
+    info.cache_percent = m_background_cache_percent;
+    const uint64_t tip_tx{tip ? tip->m_chain_tx_count : 0};
+    info.progress = base.m_chain_tx_count ? std::min(1.0, double(tip_tx) / base.m_chain_tx_count) : 0.0;
+
+    if (!info.paused && m_background_sync_start && tip) {
+        const auto& [start_time, start_tip] = *m_background_sync_start;
+        const double seconds{Ticks<SecondsDouble>(SteadyClock::now() - start_time)};
+        const int start_height{start_tip ? start_tip->nHeight : -1};
+        const uint64_t start_tx{start_tip ? start_tip->m_chain_tx_count : 0};
+        if (seconds > 0 && tip->nHeight > start_height) {
+            info.blocks_per_second = (tip->nHeight - start_height) / seconds;
+            info.transactions_per_second = (tip_tx - start_tx) / seconds;
+            if (*info.transactions_per_second > 0 && base.m_chain_tx_count >= tip_tx) {
+                info.remaining = std::chrono::seconds{int64_t((base.m_chain_tx_count - tip_tx) / *info.transactions_per_second)};
+            }
         }
     }
+    return info;
 }
 
 void ChainstateManager::ResetChainstates()
@@ -6314,6 +6691,11 @@ ChainstateManager::ChainstateManager(const util::SignalInterrupt& interrupt, Opt
       m_blockman{interrupt, std::move(blockman_options)},
       m_validation_cache{m_options.script_execution_cache_bytes, m_options.signature_cache_bytes}
 {
+    if (m_options.background_worker_threads_num) {
+        m_background_script_check_queue = std::make_unique<CCheckQueue<CScriptCheck>>(
+            /*batch_size=*/128, std::clamp(*m_options.background_worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS));
+    }
+    WITH_LOCK(::cs_main, m_background_cache_percent = std::clamp(m_options.background_cache_percent, 1, 99));
 }
 
 ChainstateManager::~ChainstateManager()
@@ -36,6 +36,7 @@
 #include <versionbits.h>
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -82,6 +83,9 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES = 550 * 1024 * 1024;
 /** Maximum number of dedicated script-checking threads allowed */
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
 
+/** Maximum total sigop cost verified by a single ChainstateManager::PrecheckTransactionScripts() call */
+static constexpr int64_t MAX_PRECHECK_SIGOPS_COST{MAX_STANDARD_TX_SIGOPS_COST};
+
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
     INIT_REINDEX,
@@ -962,6 +966,21 @@ private:
     //! A queue for script verifications that have to be performed by worker threads.
     CCheckQueue<CScriptCheck> m_script_check_queue;
 
+    //! A separate queue for the background chainstate, if it was given its own
+    //! script check threads (-backgroundpar).
+    std::unique_ptr<CCheckQueue<CScriptCheck>> m_background_script_check_queue;
+
+    //! Whether blocks are currently being connected to the background chainstate.
+    std::atomic<bool> m_background_validation_paused{false};
+
+    //! Share of the coins caches, in percent, given to the background chainstate
+    //! once the snapshot chainstate is out of initial block download.
+    int m_background_cache_percent GUARDED_BY(::cs_main);
+
+    //! Time and background tip when background validation started or was last
+    //! resumed, to report its throughput.
+    std::optional<std::pair<SteadyClock::time_point, const CBlockIndex*>> m_background_sync_start GUARDED_BY(::cs_main);
+
     //! Timers and counters used for benchmarking validation in both background
     //! and active chainstates.
     SteadyClock::duration GUARDED_BY(::cs_main) time_check{};
@@ -1117,6 +1136,39 @@ public:
         return BackgroundSyncInProgress() ? m_ibd_chainstate->m_chain.Tip() : nullptr;
     }
 
+    //! Whether the background sync is paused. While paused, no blocks are
+    //! connected to the background chainstate and net processing does not
+    //! download blocks for it.
+    bool IsBackgroundSyncPaused() const { return m_background_validation_paused; }
+
+    //! Pause or resume the background sync. Resuming connects the blocks that
+    //! were received in the meantime.
+    //!
+    //! @returns false if resuming failed to connect blocks.
+    bool SetBackgroundSyncPaused(bool paused) EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
+
+    //! Change the share of the coins caches given to the background chainstate
+    //! once the snapshot chainstate is out of initial block download.
+    void SetBackgroundCachePercent(int percent) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    struct BackgroundSyncInfo {
+        bool paused{false};
+        //! Script check worker threads used by the background chainstate.
+        int script_threads{0};
+        //! Coins cache share of the background chainstate, in percent.
+        int cache_percent{0};
+        //! Fraction of the transactions up to the snapshot base block that have been validated.
+        double progress{0};
+        //! Validation rate since background validation started or was last resumed.
+        std::optional<double> blocks_per_second;
+        std::optional<double> transactions_per_second;
+        //! Estimated time until the snapshot base block is reached at that rate.
+        std::optional<std::chrono::seconds> remaining;
+    };
+
+    //! Progress and throughput of the background sync, or nullopt if there is none.
+    std::optional<BackgroundSyncInfo> GetBackgroundSyncInfo() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
     node::BlockMap& BlockIndex() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
     {
         AssertLockHeld(::cs_main);
@@ -1249,6 +1301,19 @@ public:
     [[nodiscard]] MempoolAcceptResult ProcessTransaction(const CTransactionRef& tx, bool test_accept=false)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /**
+     * Verify the input scripts of transactions on the script check threads ahead of their
+     * ProcessTransaction() call, so that their signatures are in the signature cache by then.
+     *
+     * Only transactions that pass all mempool policy checks other than their scripts are verified,
+     * in order, until their total sigop cost would exceed MAX_PRECHECK_SIGOPS_COST. cs_main is only
+     * held while running those checks, not while verifying the scripts. This has no effect other
+     * than populating the signature cache, and does nothing if there are no script check threads.
+     *
+     * @param[in]  txs             The transactions to check.
+     */
+    void PrecheckTransactionScripts(const std::vector<CTransactionRef>& txs) LOCKS_EXCLUDED(::cs_main);
+
     //! Load the block tree and coins database from disk, initializing state if we're running with -reindex
     bool LoadBlockIndex() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
@@ -1320,6 +1385,9 @@ public:
 
     CCheckQueue<CScriptCheck>& GetCheckQueue() { return m_script_check_queue; }
 
+    //! The queue for script verifications of blocks connected to the given chainstate.
+    CCheckQueue<CScriptCheck>& GetCheckQueue(const Chainstate& chainstate) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
     ~ChainstateManager();
 };
 
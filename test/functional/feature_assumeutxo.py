@@ -578,6 +578,16 @@ class AssumeutxoTest(BitcoinTestFramework):
         assert_equal(snapshot['blocks'], SNAPSHOT_BASE_HEIGHT)
         assert_equal(snapshot['snapshot_blockhash'], dump_output['base_hash'])
         assert_equal(snapshot['validated'], False)
+        assert_equal(normal['background_validation']['paused'], False)
+        assert_equal(normal['background_validation']['cache_percent'], 95)
+        assert 0 < normal['background_validation']['progress'] < 1
+        assert 'background_validation' not in snapshot
+
+        self.log.info("Pause and resume background validation")
+        assert_raises_rpc_error(-8, "cache_percent must be between 1 and 99", n1.setbackgroundvalidation, cache_percent=100)
+        assert_equal(n1.setbackgroundvalidation(paused=True, cache_percent=80)['paused'], True)
+        assert_equal(n1.getchainstates()['chainstates'][0]['background_validation']['cache_percent'], 80)
+        assert_equal(n1.setbackgroundvalidation(paused=False)['paused'], False)
 
         assert_equal(n1.getblockchaininfo()["blocks"], SNAPSHOT_BASE_HEIGHT)
 
@@ -17,10 +17,12 @@ from test_framework.messages import (
     BLOCK_HEADER_SIZE,
     COIN,
     deser_block_spent_outputs,
+    ser_compact_size,
 )
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import (
     assert_equal,
+    assert_raises,
     assert_greater_than,
     assert_greater_than_or_equal,
 )
@@ -456,6 +458,80 @@ class RESTTest (BitcoinTestFramework):
                 assert_equal(expected, actual)
 
 
+        self.log.info("Test the /blocks URI")
+
+        blocks_bin = b''
+        blocks_undo_bin = b''
+        for height in range(block_count - 9, block_count + 1):
+            blockhash = self.nodes[0].getblockhash(height)
+            block_bin = self.test_rest_request(f"/block/{blockhash}", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+            blocks_bin += block_bin
+            blocks_undo_bin += block_bin + self.test_rest_request(f"/spenttxouts/{blockhash}", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        # The range ends at the tip
+        for count in [10, 1000]:
+            assert_equal(self.test_rest_request(f"/blocks/{block_count - 9}", req_type=ReqType.BIN, ret_type=RetType.BYTES, query_params={"count": count}), blocks_bin)
+        assert_equal(self.test_rest_request(f"/blocks/{block_count - 9}", req_type=ReqType.BIN, ret_type=RetType.BYTES, query_params={"count": 10, "undo": "true"}), blocks_undo_bin)
+        assert_equal(self.test_rest_request(f"/blocks/{block_count - 9}", req_type=ReqType.HEX, ret_type=RetType.BYTES, query_params={"count": 10, "undo": "true"}), blocks_undo_bin.hex().encode() + b'\n')
+        assert_equal(self.test_rest_request(f"/blocks/{block_count}", req_type=ReqType.BIN, ret_type=RetType.BYTES), blocks_bin[-len(block_bin):])
+        # The genesis block has no spent outputs
+        genesis_bin = self.test_rest_request(f"/block/{self.nodes[0].getblockhash(0)}", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(self.test_rest_request("/blocks/0", req_type=ReqType.BIN, ret_type=RetType.BYTES, query_params={"undo": "true"}), genesis_bin + bytes([1, 0]))
+
+        resp = self.test_rest_request(f"/blocks/{block_count + 1}", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=404)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Block height out of range")
+        resp = self.test_rest_request(f"/blocks/{INVALID_PARAM}", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), f"Invalid height: {INVALID_PARAM}")
+        for num in ['5a', '-5', '0', '1001']:
+            resp = self.test_rest_request("/blocks/0", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400, query_params={"count": num})
+            assert_equal(resp.read().decode('utf-8').rstrip(), f"Block count is invalid or out of acceptable range (1-1000): {num}")
+        resp = self.test_rest_request("/blocks/0", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400, query_params={"undo": "1"})
+        assert_equal(resp.read().decode('utf-8').rstrip(), 'The "undo" query parameter must be true or false.')
+        self.test_rest_request("/blocks/0", ret_type=RetType.OBJ, status=404)
+
+        self.log.info("Test the /txs URI")
+
+        self.test_rest_request(f"/txs/{UNKNOWN_PARAM}", ret_type=RetType.OBJ, status=503)
+        self.restart_node(0, extra_args=["-rest", "-blockfilterindex=1", "-txindex"])
+        self.connect_nodes(0, 1)
+        self.wait_until(lambda: self.nodes[0].getindexinfo()['txindex']['synced'])
+        txids = self.nodes[0].getblock(self.nodes[0].getblockhash(block_count - 9))['tx'] + [UNKNOWN_PARAM]
+        txs_json = self.test_rest_request("/txs/" + "/".join(txids))
+        assert_equal([tx['txid'] for tx in txs_json[:-1]], txids[:-1])
+        assert_equal(txs_json[-1], None)
+        txs_bin = self.test_rest_request("/txs/" + "/".join(txids), req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        bitmap = bytearray((len(txids) + 7) // 8)
+        for i in range(len(txids) - 1):
+            bitmap[i // 8] |= 1 << (i % 8)
+        expected = ser_compact_size(len(bitmap)) + bitmap + ser_compact_size(len(txids) - 1)
+        for txid in txids[:-1]:
+            expected += self.test_rest_request(f"/tx/{txid}", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(txs_bin, expected)
+        # The same request as a serialized vector of hashes
+        body = (ser_compact_size(len(txids)) + b''.join(bytes.fromhex(txid)[::-1] for txid in txids)).hex()
+        assert_equal(self.test_rest_request("/txs", http_method="POST", req_type=ReqType.HEX, body=body, ret_type=RetType.BYTES), expected.hex().encode() + b'\n')
+        resp = self.test_rest_request("/txs", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Error: empty request")
+
+        self.log.info("Test that a /txs reply that cannot be finished is cut off")
+        # The same large mempool transaction 1000 times makes a reply of about 90 MB,
+        # which waits for the client to read it.
+        big_txid = self.wallet.send_self_transfer(from_node=self.nodes[0], target_vsize=90000)['txid']
+        body = ser_compact_size(1000) + bytes.fromhex(big_txid)[::-1] * 1000
+        conn = http.client.HTTPConnection(self.url.hostname, self.url.port, timeout=60)
+        conn.request('POST', '/rest/txs.bin', body)
+        resp = conn.getresponse()
+        assert_equal(resp.status, 200)
+        resp.read(1000)
+        # Shutting down interrupts the reply, which must not look complete then.
+        self.stop_node(0)
+        assert_raises(http.client.IncompleteRead, resp.read)
+        conn.close()
+        self.start_node(0, extra_args=["-rest", "-blockfilterindex=1", "-txindex"])
+        self.connect_nodes(0, 1)
+        # The wallet spends from the transaction later on
+        self.wait_until(lambda: self.nodes[0].getmempoolinfo()['loaded'])
+        assert big_txid in self.nodes[0].getrawmempool()
+
         self.log.info("Test the /deploymentinfo URI")
 
         deployment_info = self.nodes[0].getdeploymentinfo()
@@ -472,5 +548,74 @@ class RESTTest (BitcoinTestFramework):
         resp = self.test_rest_request(f"/deploymentinfo/{INVALID_PARAM}", ret_type=RetType.OBJ, status=400)
         assert_equal(resp.read().decode('utf-8').rstrip(), f"Invalid hash: {INVALID_PARAM}")
 
+        self.test_events()
+
+    def open_event_stream(self, query_params, headers=None):
+        conn = http.client.HTTPConnection(self.url.hostname, self.url.port, timeout=60)
+        conn.request('GET', f'/rest/events?{urllib.parse.urlencode(query_params)}', headers=headers or {})
+        resp = conn.getresponse()
+        assert_equal(resp.status, 200)
+        assert_equal(resp.getheader('Content-Type'), 'text/event-stream')
+        return conn, resp
+
+    def read_event(self, resp):
+        """Read the next event of a stream, skipping comments, as a dict of its fields."""
+        event = {}
+        while True:
+            line = resp.readline().decode('utf-8').rstrip('\n')
+            if not line:
+                if event:
+                    return event
+            elif not line.startswith(':'):
+                field, _, value = line.partition(': ')
+                event[field] = json.loads(value) if field == 'data' else value
+
+    def test_events(self):
+        self.log.info("Test the /events URI")
+        node = self.nodes[0]
+        script = getnewdestination()[1]
+        # Validation events are only recorded from the first subscriber on
+        with node.assert_debug_log(["First subscriber to /rest/events, recording validation events"]):
+            conn, resp = self.open_event_stream({'types': 'block,tx_added', 'scripts': script.hex()})
+
+        block_hash = self.generate(node, 1)[0]
+        event = self.read_event(resp)
+        assert_equal(event['event'], 'block')
+        assert_equal(event['data']['hash'], block_hash)
+        assert_equal(event['data']['height'], node.getblockcount())
+        block_id = int(event['id'])
+
+        self.log.info("Test that transactions are filtered by script")
+        self.wallet.send_to(from_node=node, scriptPubKey=getnewdestination()[1], amount=int(0.1 * COIN))
+        txid = self.wallet.send_to(from_node=node, scriptPubKey=script, amount=int(0.1 * COIN))["txid"]
+        event = self.read_event(resp)
+        assert_equal(event['event'], 'tx_added')
+        assert_equal(event['data']['txid'], txid)
+        # Ids count all events, also the ones that were not sent
+        assert_greater_than(int(event['id']), block_id + 1)
+        conn.close()
+
+        self.log.info("Test replaying missed events with Last-Event-ID")
+        block_hash = self.generate(node, 1)[0]
+        with node.assert_debug_log(expected_msgs=[], unexpected_msgs=["First subscriber to /rest/events"]):
+            conn, resp = self.open_event_stream({'types': 'block'}, headers={'Last-Event-ID': str(block_id)})
+        event = self.read_event(resp)
+        assert_equal(event['event'], 'block')
+        assert_equal(event['data']['hash'], block_hash)
+        conn.close()
+
+        self.log.info("Test invalid /events requests")
+        for query_params, error in [
+            ({'types': 'blocks'}, "Unknown event type: blocks"),
+            ({'scripts': INVALID_PARAM}, f"Invalid script: {INVALID_PARAM}"),
+            ({'outputtypes': 'taproot'}, "Unknown output type: taproot"),
+            ({'since': INVALID_PARAM}, f"Invalid event id: {INVALID_PARAM}"),
+        ]:
+            conn = http.client.HTTPConnection(self.url.hostname, self.url.port)
+            conn.request('GET', f'/rest/events?{urllib.parse.urlencode(query_params)}')
+            resp = conn.getresponse()
+            assert_equal(resp.status, 400)
+            assert_equal(resp.read().decode('utf-8').rstrip(), error)
+
 if __name__ == '__main__':
     RESTTest(__file__).main()
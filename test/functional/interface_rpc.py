@@ -105,6 +105,14 @@ class RPCInterfaceTest(BitcoinTestFramework):
         assert_greater_than_or_equal(command['duration'], 0)
         assert_equal(info['logpath'], os.path.join(self.nodes[0].chain_path, 'debug.log'))
 
+        work_queue = info['work_queue']
+        assert_equal(work_queue['depth'], 0)
+        assert_equal(work_queue['max_depth'], 64)
+        assert_equal(work_queue['clients'], 1)
+        assert_equal(len(work_queue['queue_time_ms']), 16)
+        assert_equal(len(work_queue['exec_time_ms']), 16)
+        assert_greater_than_or_equal(sum(work_queue['queue_time_ms']), 1)
+
     def test_batch_request(self, call_options):
         calls = [
             # A basic request that will work fine.
@@ -237,6 +245,7 @@ class RPCInterfaceTest(BitcoinTestFramework):
             threads.append(t)
         for t in threads:
             t.join()
+        assert_greater_than_or_equal(self.nodes[0].getrpcinfo()['work_queue']['rejected'], 1)
 
     def run_test(self):
         self.test_getrpcinfo()
@@ -244,6 +253,10 @@ class RPCInterfaceTest(BitcoinTestFramework):
         self.test_http_status_codes()
         self.test_work_queue_exceeded()
 
+        self.log.info("Testing batch requests executed in parallel...")
+        self.restart_node(0, extra_args=["-rpcbatchparallel=4"])
+        self.test_batch_requests()
+
 
 if __name__ == '__main__':
     RPCInterfaceTest(__file__).main()
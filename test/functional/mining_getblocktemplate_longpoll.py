@@ -8,7 +8,10 @@ import random
 import threading
 
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import get_rpc_proxy
+from test_framework.util import (
+    assert_equal,
+    get_rpc_proxy,
+)
 from test_framework.wallet import MiniWallet
 
 
@@ -25,6 +28,14 @@ class LongpollThread(threading.Thread):
     def run(self):
         self.node.getblocktemplate({'longpollid': self.longpollid, 'rules': ['segwit']})
 
+class WaitForNewBlockThread(threading.Thread):
+    def __init__(self, node):
+        threading.Thread.__init__(self)
+        self.node = get_rpc_proxy(node.url, 1, timeout=600, coveragedir=node.coverage_dir)
+
+    def run(self):
+        self.block = self.node.waitfornewblock()
+
 class GetBlockTemplateLPTest(BitcoinTestFramework):
     def set_test_params(self):
         self.num_nodes = 2
@@ -72,5 +83,23 @@ class GetBlockTemplateLPTest(BitcoinTestFramework):
         thr.join(60 + 20)
         assert not thr.is_alive()
 
+        self.log.info("Test that waiting calls do not hold RPC threads")
+        self.restart_node(0, extra_args=["-rpcthreads=1"])
+        self.connect_nodes(0, 1)
+        threads = [LongpollThread(self.nodes[0]) for _ in range(4)] + [WaitForNewBlockThread(self.nodes[0]) for _ in range(4)]
+        with self.nodes[0].assert_debug_log(["ThreadRPCServer method=getblocktemplate", "ThreadRPCServer method=waitfornewblock"], timeout=3):
+            for thr in threads:
+                thr.start()
+        # The only RPC thread still serves other calls
+        height = self.nodes[0].getblockcount()
+        for thr in threads:
+            assert thr.is_alive()
+        self.generate(self.nodes[1], 1)
+        for thr in threads:
+            thr.join(5)
+            assert not thr.is_alive()
+        for thr in threads[4:]:
+            assert_equal(thr.block["height"], height + 1)
+
 if __name__ == '__main__':
     GetBlockTemplateLPTest(__file__).main()
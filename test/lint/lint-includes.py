@@ -35,7 +35,6 @@ EXPECTED_BOOST_INCLUDES = [
                            "boost/signals2/signal.hpp",
                            "boost/test/included/unit_test.hpp",
                            "boost/test/unit_test.hpp",
-                           "boost/tuple/tuple.hpp",
                           ]
 
 